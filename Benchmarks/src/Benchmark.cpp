@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Benchmark.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/DefaultBlocks.h"
+#include "BloxxEngine/World/TerrainGenerator.h"
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace BloxxBench
+{
+
+using namespace BloxxEngine;
+
+int GenerateTerrain(World &world, ThreadPool &threadPool, const int radius, const uint32_t seed)
+{
+    TerrainGenerator::Settings terrain = RegisterDefaultBlocks(world);
+    terrain.Seed = seed;
+    const TerrainGenerator generator(terrain);
+
+    std::vector<Chunk *> chunks;
+    for (int chunkX = -radius; chunkX < radius; chunkX++)
+    {
+        for (int chunkZ = -radius; chunkZ < radius; chunkZ++)
+            chunks.push_back(&world.AddChunk(chunkX, chunkZ));
+    }
+    threadPool.ParallelFor(chunks.size(), 1, [&generator, &chunks](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++)
+            generator.Generate(*chunks[i]);
+    });
+
+    int maxHeight = terrain.SeaLevel;
+    for (int x = -radius * SECTION_SIZE; x < radius * SECTION_SIZE; x++)
+    {
+        for (int z = -radius * SECTION_SIZE; z < radius * SECTION_SIZE; z++)
+            maxHeight = std::max(maxHeight, generator.GetHeight(x, z));
+    }
+    return maxHeight;
+}
+
+void LightWorld(World &world)
+{
+    world.ForEachChunk([&world](const Chunk &chunk) {
+        world.GetLightEngine().LightChunk(chunk.GetChunkX(), chunk.GetChunkZ());
+    });
+    world.GetLightEngine().Propagate();
+}
+
+} // namespace BloxxBench
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "BloxxEngine/World/Raycast.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace BloxxEngine
+{
+class ThreadPool;
+class World;
+} // namespace BloxxEngine
+
+namespace BloxxBench
+{
+
+// Each benchmark prints its timings and returns false when its results fail a correctness check
+bool RunRaycastBenchmark();
+bool RunCollisionBenchmark();
+bool RunOccupancyBenchmark();
+bool RunSpatialGridBenchmark();
+bool RunReplicationBenchmark();
+bool RunEditBenchmark();
+bool RunTickBenchmark();
+bool RunRelightBenchmark();
+
+// Seconds func() takes
+template <typename F> double Measure(F &&func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Registers the default blocks and generates the chunks within radius of the origin on the pool, the same terrain
+ * the client and the server start with. Returns the height of the highest generated column.
+ */
+int GenerateTerrain(BloxxEngine::World &world, BloxxEngine::ThreadPool &threadPool, int radius, uint32_t seed = 1337);
+// Lights every loaded chunk from scratch and runs the queued lighting
+void LightWorld(BloxxEngine::World &world);
+
+// Random rays from around the surface of terrain generated with the same radius, see RaycastBenchmark.cpp
+std::vector<BloxxEngine::Ray> GenerateRays(size_t count, int radius, int maxHeight, uint32_t seed);
+// Every field equal, the distance bit for bit
+bool SameHit(const BloxxEngine::RaycastHit &a, const BloxxEngine::RaycastHit &b);
+
+} // namespace BloxxBench
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Benchmark.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/Collision.h"
+#include "BloxxEngine/World/World.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace BloxxBench
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+constexpr int TERRAIN_RADIUS = 8;
+constexpr size_t BODY_COUNT = 10000;
+constexpr int STEP_COUNT = 300; // Five seconds at 60 Hz, long enough for every body to land and walk into walls
+constexpr float DELTA_TIME = 1.0f / 60.0f;
+constexpr float GRAVITY = -20.0f;
+
+// Whether the box overlaps a solid block, shrunk a little so resting contact doesn't count
+bool IsEmbedded(const World &world, const glm::vec3 &position, const glm::vec3 &halfExtents)
+{
+    const glm::ivec3 low(glm::floor(position - halfExtents + 1e-3f));
+    const glm::ivec3 high(glm::floor(position + halfExtents - 1e-3f));
+    for (int x = low.x; x <= high.x; x++)
+    {
+        for (int y = low.y; y <= high.y; y++)
+        {
+            for (int z = low.z; z <= high.z; z++)
+            {
+                if (world.GetBlockRegistry().IsSolid(world.GetBlock(x, y, z)))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+} // namespace
+
+bool RunCollisionBenchmark()
+{
+    ThreadPool threadPool;
+    World world(&threadPool);
+    const int maxHeight = GenerateTerrain(world, threadPool, TERRAIN_RADIUS);
+    const CollisionSystem collision(world);
+
+    // Player sized boxes dropped from above the highest column, walking in random directions
+    std::mt19937 random(7);
+    const auto extent = static_cast<float>(TERRAIN_RADIUS * SECTION_SIZE - 8);
+    std::uniform_real_distribution<float> horizontal(-extent, extent);
+    std::uniform_real_distribution<float> height(static_cast<float>(maxHeight) + 2.0f,
+                                                 static_cast<float>(maxHeight) + 20.0f);
+    std::uniform_real_distribution<float> speed(-5.0f, 5.0f);
+    CollisionBodies bodies;
+    for (size_t i = 0; i < BODY_COUNT; i++)
+    {
+        bodies.Add({horizontal(random), height(random), horizontal(random)}, {0.3f, 0.9f, 0.3f},
+                   {speed(random), 0.0f, speed(random)});
+    }
+    CollisionBodies reference = bodies;
+
+    double stepTime = 0.0, slowestStep = 0.0;
+    for (int step = 0; step < STEP_COUNT; step++)
+    {
+        for (float &velocity : bodies.VelocityY)
+            velocity += GRAVITY * DELTA_TIME;
+        const double time = Measure([&] { collision.Step(bodies, DELTA_TIME, threadPool); });
+        stepTime += time;
+        slowestStep = std::max(slowestStep, time);
+    }
+
+    // The batched steps on the pool have to match moving every body on its own
+    size_t mismatches = 0, embedded = 0, grounded = 0;
+    for (size_t i = 0; i < BODY_COUNT; i++)
+    {
+        glm::vec3 position(reference.PositionX[i], reference.PositionY[i], reference.PositionZ[i]);
+        glm::vec3 velocity(reference.VelocityX[i], reference.VelocityY[i], reference.VelocityZ[i]);
+        const glm::vec3 halfExtents(reference.HalfExtentX[i], reference.HalfExtentY[i], reference.HalfExtentZ[i]);
+        uint8_t contacts = 0;
+        for (int step = 0; step < STEP_COUNT; step++)
+        {
+            velocity.y += GRAVITY * DELTA_TIME;
+            contacts = collision.Move(position, halfExtents, velocity, DELTA_TIME);
+        }
+
+        const glm::vec3 stepped(bodies.PositionX[i], bodies.PositionY[i], bodies.PositionZ[i]);
+        mismatches += stepped != position || bodies.Contacts[i] != contacts;
+        embedded += IsEmbedded(world, stepped, halfExtents);
+        grounded += (bodies.Contacts[i] & CollisionContact_Ground) != 0;
+    }
+
+    std::cout << BODY_COUNT << " bodies, " << STEP_COUNT << " steps over " << world.GetChunkCount() << " chunks, "
+              << grounded << " on the ground at the end" << std::endl;
+    std::cout << "Step: " << stepTime / STEP_COUNT * 1000.0 << " ms avg, " << slowestStep * 1000.0 << " ms max, "
+              << static_cast<double>(BODY_COUNT) * STEP_COUNT / stepTime << " bodies/s on "
+              << threadPool.GetWorkerCount() + 1 << " threads" << std::endl;
+
+    if (mismatches)
+        std::cerr << mismatches << " stepped bodies differ from moving them one by one" << std::endl;
+    if (embedded)
+        std::cerr << embedded << " bodies ended up inside solid blocks" << std::endl;
+    return mismatches == 0 && embedded == 0;
+}
+
+} // namespace BloxxBench
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Benchmark.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+namespace BloxxBench
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+constexpr int TERRAIN_RADIUS = 8;
+// Edits cover boxes of EDIT_SIZE^3, a million blocks
+constexpr int EDIT_SIZE = 100;
+
+struct EditCase
+{
+    const char *Name;
+    glm::ivec3 Min; // The box the edit touches, restored by undoing it
+    std::function<EditJournal()> Edit;
+};
+} // namespace
+
+bool RunEditBenchmark()
+{
+    ThreadPool threadPool;
+    World world(&threadPool);
+    GenerateTerrain(world, threadPool, TERRAIN_RADIUS);
+    LightWorld(world);
+    const BlockId stone = world.GetBlock(0, 0, 0);
+    const BlockId dirt = world.GetBlockRegistry().Register("dirt", BlockType::Solid);
+
+    const glm::ivec3 size(EDIT_SIZE - 1);
+    const glm::ivec3 underground(-EDIT_SIZE / 2, 0, -EDIT_SIZE / 2);
+    const glm::ivec3 sky(-EDIT_SIZE / 2, 120, -EDIT_SIZE / 2);
+    const BlockRegion terrain = world.CopyRegion(underground, underground + size);
+    const EditCase cases[] = {
+        {"FillBox in the sky", sky, [&] { return world.FillBox(sky, sky + size, stone); }},
+        {"FillBox underground", underground, [&] { return world.FillBox(underground, underground + size, BLOCK_AIR); }},
+        {"FillSphere", sky, [&] { return world.FillSphere(sky + EDIT_SIZE / 2, EDIT_SIZE / 2, stone); }},
+        {"Replace", underground, [&] { return world.Replace(underground, underground + size, stone, dirt); }},
+        {"PasteRegion", sky, [&] { return world.PasteRegion(terrain, sky); }},
+    };
+
+    std::cout << EDIT_SIZE << "^3 boxes on " << world.GetChunkCount() << " lit chunks, undoing includes its lighting"
+              << std::endl;
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::left << std::setw(20) << "Edit" << std::right << std::setw(9) << "changed" << std::setw(10)
+              << "edit ms" << std::setw(10) << "light ms" << std::setw(10) << "undo ms" << std::setw(12)
+              << "journal KiB" << std::endl;
+    bool restored = true;
+    for (const EditCase &edit : cases)
+    {
+        const BlockRegion before = world.CopyRegion(edit.Min, edit.Min + size);
+        EditJournal journal;
+        const double editTime = Measure([&] { journal = edit.Edit(); });
+        const double lightTime = Measure([&] { world.GetLightEngine().Propagate(); });
+        const double undoTime = Measure([&] {
+            world.ApplyJournal(journal);
+            world.GetLightEngine().Propagate();
+        });
+
+        const BlockRegion after = world.CopyRegion(edit.Min, edit.Min + size);
+        if (after.Blocks != before.Blocks || after.Metadata != before.Metadata)
+        {
+            std::cerr << edit.Name << " wasn't undone" << std::endl;
+            restored = false;
+        }
+
+        const double journalSize = static_cast<double>(journal.Runs.size() * sizeof(EditJournal::Run) +
+                                                       journal.Sections.size() * sizeof(EditJournal::Section));
+        std::cout << std::left << std::setw(20) << edit.Name << std::right << std::setw(9) << journal.ChangedCount
+                  << std::fixed << std::setprecision(2) << std::setw(10) << editTime * 1000.0 << std::setw(10)
+                  << lightTime * 1000.0 << std::setw(10) << undoTime * 1000.0 << std::setw(12)
+                  << journalSize / 1024.0 << std::defaultfloat << std::endl;
+    }
+    std::cout << std::setprecision(precision);
+    return restored;
+}
+
+} // namespace BloxxBench
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+// Benchmarks of the GL free world code. Run without arguments for all of them, or name the ones to run.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+
+struct Benchmark
+{
+    const char *Name;
+    bool (*Run)();
+};
+
+constexpr Benchmark BENCHMARKS[] = {
+    {"raycast", BloxxBench::RunRaycastBenchmark},
+    {"collision", BloxxBench::RunCollisionBenchmark},
+    {"occupancy", BloxxBench::RunOccupancyBenchmark},
+    {"spatialgrid", BloxxBench::RunSpatialGridBenchmark},
+    {"replication", BloxxBench::RunReplicationBenchmark},
+    {"edit", BloxxBench::RunEditBenchmark},
+    {"tick", BloxxBench::RunTickBenchmark},
+    {"relight", BloxxBench::RunRelightBenchmark},
+};
+
+} // namespace
+
+int main(const int argc, char **argv)
+{
+    bool passed = true;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::ranges::none_of(BENCHMARKS, [&](const Benchmark &benchmark) {
+                return std::strcmp(benchmark.Name, argv[i]) == 0;
+            }))
+        {
+            std::cerr << "Unknown benchmark " << argv[i] << ", available:";
+            for (const Benchmark &benchmark : BENCHMARKS)
+                std::cerr << ' ' << benchmark.Name;
+            std::cerr << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (const Benchmark &benchmark : BENCHMARKS)
+    {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc; i++)
+            selected |= std::strcmp(benchmark.Name, argv[i]) == 0;
+        if (!selected)
+            continue;
+
+        std::cout << "== " << benchmark.Name << std::endl;
+        if (!benchmark.Run())
+        {
+            std::cerr << benchmark.Name << " failed its checks" << std::endl;
+            passed = false;
+        }
+    }
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
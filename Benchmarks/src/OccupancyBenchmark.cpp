@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Benchmark.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace BloxxBench
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+constexpr int TERRAIN_RADIUS = 8;
+constexpr int EDIT_COUNT = 3000;
+constexpr size_t RAY_COUNT = 200000;
+constexpr int QUERY_COUNT = 2000;
+constexpr int QUERY_RADIUS = 24;
+
+// The nearest matching block by looking at every block in range
+std::optional<int> BruteForceNearest(const World &world, const glm::ivec3 &center, const int radius,
+                                     const uint8_t flagMask)
+{
+    std::optional<int> nearest;
+    for (int x = center.x - radius; x <= center.x + radius; x++)
+    {
+        for (int y = center.y - radius; y <= center.y + radius; y++)
+        {
+            for (int z = center.z - radius; z <= center.z + radius; z++)
+            {
+                const BlockId id = world.GetBlock(x, y, z);
+                if (id == BLOCK_AIR || !(world.GetBlockRegistry().GetFlags(id) & flagMask))
+                    continue;
+                const glm::ivec3 offset = glm::ivec3(x, y, z) - center;
+                const int distance = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+                if (!nearest || distance < *nearest)
+                    nearest = distance;
+            }
+        }
+    }
+    return nearest;
+}
+} // namespace
+
+bool RunOccupancyBenchmark()
+{
+    ThreadPool threadPool;
+    World world(&threadPool);
+    const int maxHeight = GenerateTerrain(world, threadPool, TERRAIN_RADIUS);
+
+    // Holes in the ground and blocks floating in the air, so bricks are mixed and not only full or empty
+    std::mt19937 random(3000);
+    const int extent = TERRAIN_RADIUS * SECTION_SIZE;
+    std::uniform_int_distribution<int> horizontal(-extent, extent - 1);
+    std::uniform_int_distribution<int> height(0, maxHeight + 32);
+    const BlockId stone = world.GetBlock(0, 0, 0);
+    for (int i = 0; i < EDIT_COUNT; i++)
+    {
+        const int x = horizontal(random), y = height(random), z = horizontal(random);
+        world.SetBlock(x, y, z, world.GetBlock(x, y, z) == BLOCK_AIR ? stone : BLOCK_AIR);
+    }
+
+    // The same rays with and without skipping have to hit exactly the same blocks
+    std::vector<Ray> rays = GenerateRays(RAY_COUNT, TERRAIN_RADIUS, maxHeight, 39);
+    std::vector<RaycastHit> skippingHits(rays.size()), flatHits(rays.size());
+    const double skippingTime = Measure([&] {
+        for (size_t i = 0; i < rays.size(); i++)
+            skippingHits[i] = world.Raycast(rays[i]);
+    });
+    for (Ray &ray : rays)
+        ray.SkipEmptySpace = false;
+    const double flatTime = Measure([&] {
+        for (size_t i = 0; i < rays.size(); i++)
+            flatHits[i] = world.Raycast(rays[i]);
+    });
+
+    size_t rayMismatches = 0;
+    for (size_t i = 0; i < rays.size(); i++)
+        rayMismatches += !SameHit(skippingHits[i], flatHits[i]);
+
+    std::cout << rays.size() << " rays over " << world.GetChunkCount() << " chunks after " << EDIT_COUNT << " edits"
+              << std::endl;
+    std::cout << "Voxel by voxel:     " << flatTime * 1000.0 << " ms, " << static_cast<double>(RAY_COUNT) / flatTime
+              << " rays/s" << std::endl;
+    std::cout << "Skipping empty:     " << skippingTime * 1000.0 << " ms, "
+              << static_cast<double>(RAY_COUNT) / skippingTime << " rays/s" << std::endl;
+
+    // Centers anywhere from deep underground to high in the air, where the nearest solid block is far or missing
+    std::vector<glm::ivec3> centers(QUERY_COUNT);
+    for (glm::ivec3 &center : centers)
+        center = {horizontal(random), height(random), horizontal(random)};
+
+    std::vector<std::optional<glm::ivec3>> found(centers.size());
+    const double treeTime = Measure([&] {
+        for (size_t i = 0; i < centers.size(); i++)
+            found[i] = world.FindNearestBlock(centers[i], QUERY_RADIUS, BlockFlag_Solid);
+    });
+    std::vector<std::optional<int>> expected(centers.size());
+    const double bruteForceTime = Measure([&] {
+        for (size_t i = 0; i < centers.size(); i++)
+            expected[i] = BruteForceNearest(world, centers[i], QUERY_RADIUS, BlockFlag_Solid);
+    });
+
+    // Several blocks can be equally near, so the distances are compared and the block found has to match
+    size_t nearestMismatches = 0;
+    for (size_t i = 0; i < centers.size(); i++)
+    {
+        std::optional<int> distance;
+        if (found[i])
+        {
+            const glm::ivec3 offset = *found[i] - centers[i];
+            distance = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+            nearestMismatches += !world.GetBlockRegistry().IsSolid(world.GetBlock(found[i]->x, found[i]->y,
+                                                                                   found[i]->z));
+        }
+        nearestMismatches += distance != expected[i];
+    }
+
+    std::cout << "Nearest solid block within " << QUERY_RADIUS << ", " << QUERY_COUNT << " queries:" << std::endl;
+    std::cout << "Brute force:        " << bruteForceTime / QUERY_COUNT * 1000.0 << " ms per query" << std::endl;
+    std::cout << "Occupancy tree:     " << treeTime / QUERY_COUNT * 1000.0 << " ms per query" << std::endl;
+
+    if (rayMismatches)
+        std::cerr << rayMismatches << " rays hit differently when skipping empty space" << std::endl;
+    if (nearestMismatches)
+        std::cerr << nearestMismatches << " nearest block queries differ from the brute force scan" << std::endl;
+    return rayMismatches == 0 && nearestMismatches == 0;
+}
+
+} // namespace BloxxBench
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Benchmark.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace BloxxBench
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+constexpr int TERRAIN_RADIUS = 8; // 16x16 chunks
+constexpr size_t RAY_COUNT = 200000;
+} // namespace
+
+std::vector<Ray> GenerateRays(const size_t count, const int radius, const int maxHeight, const uint32_t seed)
+{
+    // Eye height over the terrain up to well above it, looking in any direction: a mix of short hits on the ground
+    // and long misses through the air
+    std::mt19937 random(seed);
+    const auto extent = static_cast<float>(radius * SECTION_SIZE);
+    std::uniform_real_distribution<float> horizontal(-extent, extent);
+    std::uniform_real_distribution<float> height(static_cast<float>(maxHeight) - 16.0f,
+                                                 static_cast<float>(maxHeight) + 48.0f);
+    std::normal_distribution<float> direction;
+
+    std::vector<Ray> rays(count);
+    for (Ray &ray : rays)
+    {
+        ray.Origin = {horizontal(random), height(random), horizontal(random)};
+        ray.Direction = {direction(random), direction(random), direction(random)};
+        ray.MaxDistance = 96.0f;
+    }
+    return rays;
+}
+
+bool SameHit(const RaycastHit &a, const RaycastHit &b)
+{
+    return a.Hit == b.Hit && (!a.Hit || (a.Position == b.Position && a.Normal == b.Normal && a.Face == b.Face &&
+                                         a.Distance == b.Distance && a.Id == b.Id));
+}
+
+bool RunRaycastBenchmark()
+{
+    ThreadPool threadPool;
+    World world(&threadPool);
+    const int maxHeight = GenerateTerrain(world, threadPool, TERRAIN_RADIUS);
+    const std::vector<Ray> rays = GenerateRays(RAY_COUNT, TERRAIN_RADIUS, maxHeight, 42);
+
+    std::vector<RaycastHit> serialHits(rays.size());
+    const double serialTime = Measure([&] {
+        for (size_t i = 0; i < rays.size(); i++)
+            serialHits[i] = world.Raycast(rays[i]);
+    });
+
+    std::vector<RaycastHit> batchHits(rays.size());
+    const double batchTime = Measure([&] { world.RaycastBatch(rays, batchHits, threadPool); });
+
+    size_t hitCount = 0, mismatches = 0;
+    for (size_t i = 0; i < rays.size(); i++)
+    {
+        hitCount += serialHits[i].Hit;
+        mismatches += !SameHit(serialHits[i], batchHits[i]);
+    }
+
+    const auto raysPerSecond = [](const double seconds) { return static_cast<double>(RAY_COUNT) / seconds; };
+    std::cout << rays.size() << " rays over " << world.GetChunkCount() << " chunks, " << hitCount << " hit"
+              << std::endl;
+    std::cout << "Raycast:      " << serialTime * 1000.0 << " ms, " << raysPerSecond(serialTime) << " rays/s"
+              << std::endl;
+    std::cout << "RaycastBatch: " << batchTime * 1000.0 << " ms, " << raysPerSecond(batchTime) << " rays/s on "
+              << threadPool.GetWorkerCount() + 1 << " threads" << std::endl;
+
+    if (mismatches)
+        std::cerr << mismatches << " batched rays differ from the serial ones" << std::endl;
+    return mismatches == 0;
+}
+
+} // namespace BloxxBench
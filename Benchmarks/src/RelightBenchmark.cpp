@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Benchmark.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace BloxxBench
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+constexpr int TERRAIN_RADIUS = 8;
+constexpr int EDIT_COUNT = 3000;
+
+struct Edit
+{
+    glm::ivec3 Position;
+    BlockId Id;
+    BlockId Previous = BLOCK_AIR;
+};
+
+struct EditKind
+{
+    const char *Name;
+    BlockId Id;
+    int Height; // Above the highest block of the column
+    std::vector<Edit> Edits;
+};
+
+// Sky and block light of every loaded block, chunk by chunk
+std::vector<uint8_t> CopyLight(World &world)
+{
+    std::vector<uint8_t> light;
+    for (int chunkX = -TERRAIN_RADIUS; chunkX < TERRAIN_RADIUS; chunkX++)
+    {
+        for (int chunkZ = -TERRAIN_RADIUS; chunkZ < TERRAIN_RADIUS; chunkZ++)
+        {
+            const Chunk &chunk = *world.GetChunk(chunkX, chunkZ);
+            for (int y = 0; y < CHUNK_HEIGHT; y++)
+            {
+                for (int z = 0; z < CHUNK_DEPTH; z++)
+                {
+                    for (int x = 0; x < CHUNK_WIDTH; x++)
+                        light.push_back(static_cast<uint8_t>(chunk.GetSkyLight(x, y, z) << 4 |
+                                                             chunk.GetBlockLight(x, y, z)));
+                }
+            }
+        }
+    }
+    return light;
+}
+} // namespace
+
+bool RunRelightBenchmark()
+{
+    ThreadPool threadPool;
+    World world(&threadPool);
+    const int maxHeight = GenerateTerrain(world, threadPool, TERRAIN_RADIUS);
+    LightWorld(world);
+    const std::vector<uint8_t> lit = CopyLight(world);
+
+    auto &registry = world.GetBlockRegistry();
+    const BlockId stone = world.GetBlock(0, 0, 0);
+    const BlockId lamp = registry.Register("lamp", BlockType::Solid);
+    registry.SetLightEmission(lamp, 14);
+
+    // Blocks right on the surface, where an edit changes the most light: one placed on top of the ground, a hole
+    // dug into the ground and a lamp placed on top
+    std::mt19937 random(34);
+    const int extent = TERRAIN_RADIUS * SECTION_SIZE;
+    std::uniform_int_distribution<int> horizontal(-extent, extent - 1);
+    EditKind kinds[] = {{"Place stone", stone, 1, {}}, {"Dig", BLOCK_AIR, 0, {}}, {"Place lamp", lamp, 1, {}}};
+    for (EditKind &kind : kinds)
+    {
+        for (int i = 0; i < EDIT_COUNT; i++)
+        {
+            const int x = horizontal(random), z = horizontal(random);
+            int y = maxHeight;
+            while (y > 0 && world.GetBlock(x, y, z) == BLOCK_AIR)
+                y--;
+            kind.Edits.push_back({{x, y + kind.Height, z}, kind.Id});
+        }
+    }
+
+    std::cout << EDIT_COUNT << " single block edits per kind on " << world.GetChunkCount()
+              << " lit chunks, each relit on its own" << std::endl;
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::left << std::setw(14) << "Edit" << std::right << std::setw(10) << "avg us" << std::setw(10)
+              << "p99 us" << std::setw(10) << "max us" << std::setw(14) << "voxels/edit" << std::endl;
+    bool restored = true;
+    for (EditKind &kind : kinds)
+    {
+        std::vector<double> times;
+        size_t updated = 0;
+        for (Edit &edit : kind.Edits)
+        {
+            edit.Previous = world.GetBlock(edit.Position.x, edit.Position.y, edit.Position.z);
+            times.push_back(Measure([&] {
+                world.SetBlock(edit.Position.x, edit.Position.y, edit.Position.z, edit.Id);
+                world.GetLightEngine().Propagate();
+            }));
+            updated += world.GetLightEngine().GetLastUpdateCount();
+        }
+
+        // Undoing the edits in reverse has to bring back the light of the freshly lit world
+        for (auto edit = kind.Edits.rbegin(); edit != kind.Edits.rend(); ++edit)
+            world.SetBlock(edit->Position.x, edit->Position.y, edit->Position.z, edit->Previous);
+        world.GetLightEngine().Propagate();
+        if (CopyLight(world) != lit)
+        {
+            std::cerr << "Undoing " << kind.Name << " didn't restore the light" << std::endl;
+            restored = false;
+        }
+
+        double total = 0.0;
+        for (const double time : times)
+            total += time;
+        std::ranges::sort(times);
+        std::cout << std::left << std::setw(14) << kind.Name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << total / static_cast<double>(times.size()) * 1e6 << std::setw(10)
+                  << times[times.size() * 99 / 100] * 1e6 << std::setw(10) << times.back() * 1e6 << std::setw(14)
+                  << static_cast<double>(updated) / static_cast<double>(times.size()) << std::defaultfloat
+                  << std::endl;
+    }
+    std::cout << std::setprecision(precision);
+    return restored;
+}
+
+} // namespace BloxxBench
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Benchmark.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/DefaultBlocks.h"
+#include "BloxxEngine/World/World.h"
+#include "BloxxEngine/World/WorldReplication.h"
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace BloxxBench
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+constexpr int TERRAIN_RADIUS = 8;
+constexpr int CHUNK_ROUNDS = 4;
+constexpr int SCATTERED_EDITS = 2000;
+
+struct EditCase
+{
+    const char *Name;
+    std::function<void()> Edit;
+};
+
+// Every block and its metadata of the chunks of the server, compared with the client
+size_t CountDifferences(World &server, const World &client)
+{
+    size_t differences = 0;
+    server.ForEachChunk([&](const Chunk &chunk) {
+        const Chunk *replica = client.GetChunk(chunk.GetChunkX(), chunk.GetChunkZ());
+        if (!replica)
+        {
+            differences++;
+            return;
+        }
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+        {
+            for (int y = 0; y < CHUNK_HEIGHT; y++)
+            {
+                for (int z = 0; z < CHUNK_DEPTH; z++)
+                {
+                    differences += chunk.GetBlock(x, y, z) != replica->GetBlock(x, y, z) ||
+                                   chunk.GetMetadata(x, y, z) != replica->GetMetadata(x, y, z);
+                }
+            }
+        }
+    });
+    return differences;
+}
+} // namespace
+
+bool RunReplicationBenchmark()
+{
+    ThreadPool threadPool;
+    World server(&threadPool);
+    World client;
+    const int maxHeight = GenerateTerrain(server, threadPool, TERRAIN_RADIUS);
+    const TerrainGenerator::Settings terrain = RegisterDefaultBlocks(client);
+    WorldReplicator replicator(server);
+    WorldReplica replica(client);
+
+    // Whole chunks, as sent to clients that start watching them
+    std::vector<uint8_t> packet;
+    const double encodeTime = Measure([&] {
+        for (int round = 0; round < CHUNK_ROUNDS; round++)
+        {
+            packet.clear();
+            for (int chunkX = -TERRAIN_RADIUS; chunkX < TERRAIN_RADIUS; chunkX++)
+            {
+                for (int chunkZ = -TERRAIN_RADIUS; chunkZ < TERRAIN_RADIUS; chunkZ++)
+                    replicator.WriteChunk(chunkX, chunkZ, packet);
+            }
+        }
+    });
+    bool applied = true;
+    const double decodeTime = Measure([&] {
+        for (int round = 0; round < CHUNK_ROUNDS; round++)
+            applied &= replica.Apply(packet);
+    });
+
+    const double chunks = static_cast<double>(server.GetChunkCount()) * CHUNK_ROUNDS;
+    std::cout << server.GetChunkCount() << " chunks, " << static_cast<double>(packet.size()) / 1024.0 << " KiB, "
+              << static_cast<double>(packet.size()) / static_cast<double>(server.GetChunkCount()) << " bytes per chunk"
+              << std::endl;
+    std::cout << "Encode: " << chunks / encodeTime << " chunks/s" << std::endl;
+    std::cout << "Decode: " << chunks / decodeTime << " chunks/s, lighting included" << std::endl;
+
+    // Changes of a tick, in the encoding each section picks
+    std::mt19937 random(47);
+    const int extent = TERRAIN_RADIUS * SECTION_SIZE;
+    std::uniform_int_distribution<int> horizontal(-extent, extent - 1);
+    std::uniform_int_distribution<int> height(0, maxHeight);
+    const EditCase cases[] = {
+        {"Scattered SetBlock",
+         [&] {
+             for (int i = 0; i < SCATTERED_EDITS; i++)
+                 server.SetBlock(horizontal(random), height(random), horizontal(random), terrain.Grass, 1);
+         }},
+        {"FillBox 48x16x48", [&] { server.FillBox({-24, 40, -24}, {23, 55, 23}, BLOCK_AIR); }},
+        {"FillBox wall", [&] { server.FillBox({-extent, 70, 5}, {extent - 1, 90, 5}, terrain.Stone); }},
+        {"FillSphere r10", [&] { server.FillSphere({40, 60, -40}, 10, terrain.Dirt, 3); }},
+        {"Replace 64^3", [&] { server.Replace({-32, 0, -32}, {31, 63, 31}, terrain.Stone, terrain.Dirt); }},
+    };
+
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::left << std::setw(20) << "Edit" << std::right << std::setw(8) << "changed" << std::setw(8)
+              << "bytes" << std::setw(12) << "bytes/edit" << std::setw(8) << "deltas" << std::setw(6) << "runs"
+              << std::setw(10) << "sections" << std::endl;
+    for (const EditCase &edit : cases)
+    {
+        edit.Edit();
+        packet.clear();
+        replicator.WriteChanges(packet);
+        applied &= replica.Apply(packet);
+
+        const WorldReplicator::Stats &stats = replicator.GetLastStats();
+        const double perEdit = stats.ChangedBlocks ? static_cast<double>(stats.Bytes) / stats.ChangedBlocks : 0.0;
+        std::cout << std::left << std::setw(20) << edit.Name << std::right << std::setw(8) << stats.ChangedBlocks
+                  << std::setw(8) << stats.Bytes << std::setw(12) << std::fixed << std::setprecision(3) << perEdit
+                  << std::defaultfloat << std::setw(8) << stats.SectionDeltas << std::setw(6)
+                  << stats.MultiBlockChanges << std::setw(10) << stats.SectionDatas << std::endl;
+    }
+    std::cout << std::setprecision(precision);
+
+    const size_t differences = CountDifferences(server, client);
+    if (!applied)
+        std::cerr << "The client rejected a packet" << std::endl;
+    if (differences)
+        std::cerr << differences << " blocks differ between the server and the client" << std::endl;
+    return applied && differences == 0;
+}
+
+} // namespace BloxxBench
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Benchmark.h"
+
+#include "BloxxEngine/ECS/SpatialGrid.h"
+#include "BloxxEngine/ThreadPool.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace BloxxBench
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+constexpr size_t ENTITY_COUNT = 50000;
+constexpr int TICK_COUNT = 60;
+constexpr int QUERIES_PER_TICK = 200;
+constexpr float WORLD_SIZE = 512.0f;
+constexpr float WORLD_HEIGHT = 64.0f;
+constexpr float QUERY_RADIUS = 12.0f;
+constexpr float DELTA_TIME = 1.0f / 20.0f;
+
+bool SameEntities(std::vector<Entity> &a, std::vector<Entity> &b)
+{
+    auto byIndex = [](const Entity &left, const Entity &right) { return left.Index < right.Index; };
+    std::ranges::sort(a, byIndex);
+    std::ranges::sort(b, byIndex);
+    return a == b;
+}
+} // namespace
+
+bool RunSpatialGridBenchmark()
+{
+    ThreadPool threadPool;
+    SpatialGrid grid;
+
+    std::mt19937 random(43);
+    std::uniform_real_distribution<float> horizontal(0.0f, WORLD_SIZE);
+    std::uniform_real_distribution<float> vertical(0.0f, WORLD_HEIGHT);
+    std::uniform_real_distribution<float> speed(-8.0f, 8.0f);
+
+    std::vector<Entity> entities(ENTITY_COUNT);
+    std::vector<glm::vec3> positions(ENTITY_COUNT);
+    std::vector<glm::vec3> velocities(ENTITY_COUNT);
+    for (size_t i = 0; i < ENTITY_COUNT; i++)
+    {
+        entities[i] = {static_cast<uint32_t>(i), 0};
+        positions[i] = {horizontal(random), vertical(random), horizontal(random)};
+        velocities[i] = {speed(random), speed(random) * 0.25f, speed(random)};
+        grid.Insert(entities[i], positions[i]);
+    }
+
+    std::vector<Entity> results(ENTITY_COUNT), gridMatches, bruteForceMatches;
+    double updateTime = 0.0, gridTime = 0.0, bruteForceTime = 0.0;
+    size_t cellChanges = 0, matches = 0, mismatches = 0;
+
+    for (int tick = 0; tick < TICK_COUNT; tick++)
+    {
+        // Everyone moves every tick, bouncing off the edges of the volume
+        updateTime += Measure([&] {
+            threadPool.ParallelFor(ENTITY_COUNT, 1024, [&](const size_t begin, const size_t end) {
+                for (size_t i = begin; i < end; i++)
+                {
+                    glm::vec3 &position = positions[i];
+                    position += velocities[i] * DELTA_TIME;
+                    for (int axis = 0; axis < 3; axis++)
+                    {
+                        const float limit = axis == 1 ? WORLD_HEIGHT : WORLD_SIZE;
+                        if (position[axis] < 0.0f || position[axis] > limit)
+                        {
+                            velocities[i][axis] = -velocities[i][axis];
+                            position[axis] = std::clamp(position[axis], 0.0f, limit);
+                        }
+                    }
+                    grid.Move(entities[i], position);
+                }
+            });
+            grid.ApplyUpdates();
+        });
+        cellChanges += grid.GetLastCellChanges();
+
+        for (int query = 0; query < QUERIES_PER_TICK; query++)
+        {
+            const glm::vec3 center(horizontal(random), vertical(random), horizontal(random));
+            const glm::vec3 min = center - glm::vec3(QUERY_RADIUS, QUERY_RADIUS * 0.5f, QUERY_RADIUS);
+            const glm::vec3 max = center + glm::vec3(QUERY_RADIUS, QUERY_RADIUS * 0.5f, QUERY_RADIUS);
+            const bool box = query % 2;
+
+            gridTime += Measure([&] {
+                const size_t count = box ? grid.QueryBox(min, max, results)
+                                         : grid.QueryRadius(center, QUERY_RADIUS, results);
+                gridMatches.assign(results.begin(), results.begin() + static_cast<std::ptrdiff_t>(count));
+            });
+            bruteForceTime += Measure([&] {
+                bruteForceMatches.clear();
+                for (size_t i = 0; i < ENTITY_COUNT; i++)
+                {
+                    const glm::vec3 &p = positions[i];
+                    const glm::vec3 offset = p - center;
+                    const bool inside = box ? p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y &&
+                                                  p.z >= min.z && p.z <= max.z
+                                            : glm::dot(offset, offset) <= QUERY_RADIUS * QUERY_RADIUS;
+                    if (inside)
+                        bruteForceMatches.push_back(entities[i]);
+                }
+            });
+
+            matches += gridMatches.size();
+            mismatches += !SameEntities(gridMatches, bruteForceMatches);
+        }
+    }
+
+    const double queryCount = static_cast<double>(TICK_COUNT) * QUERIES_PER_TICK;
+    std::cout << ENTITY_COUNT << " moving entities in " << grid.GetCellCount() << " cells, " << TICK_COUNT
+              << " ticks, " << static_cast<double>(cellChanges) / TICK_COUNT << " cell changes per tick" << std::endl;
+    std::cout << "Move + ApplyUpdates: " << updateTime / TICK_COUNT * 1000.0 << " ms per tick on "
+              << threadPool.GetWorkerCount() + 1 << " threads" << std::endl;
+    std::cout << "Grid queries:        " << gridTime / queryCount * 1e6 << " us per query, "
+              << static_cast<double>(matches) / queryCount << " matches" << std::endl;
+    std::cout << "Brute force:         " << bruteForceTime / queryCount * 1e6 << " us per query" << std::endl;
+
+    if (mismatches)
+        std::cerr << mismatches << " grid queries differ from the brute force scan" << std::endl;
+    return mismatches == 0;
+}
+
+} // namespace BloxxBench
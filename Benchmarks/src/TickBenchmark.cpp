@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Benchmark.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace BloxxBench
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+constexpr int TERRAIN_RADIUS = 8;
+constexpr int TICK_COUNT = 50;
+constexpr int RANDOM_TICKS_PER_SECTION = 64;
+// Layers of sand above the highest column, every block falls a block per tick until it lands
+constexpr int SAND_LAYERS = 2;
+constexpr int SAND_SPACING = 4; // Blocks between two sand columns
+
+struct TickRun
+{
+    double Time = 0.0;
+    size_t Handled = 0;
+    uint64_t Hash = 0; // Of every block after the last tick, the same whatever the worker count
+};
+
+uint64_t HashBlocks(const World &world)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (int chunkX = -TERRAIN_RADIUS; chunkX < TERRAIN_RADIUS; chunkX++)
+    {
+        for (int chunkZ = -TERRAIN_RADIUS; chunkZ < TERRAIN_RADIUS; chunkZ++)
+        {
+            const Chunk *chunk = world.GetChunk(chunkX, chunkZ);
+            for (int sectionY = 0; sectionY < CHUNK_SECTION_COUNT; sectionY++)
+            {
+                const ChunkSection *section = chunk->GetSection(sectionY);
+                for (int i = 0; section && i < SECTION_VOLUME; i++)
+                    hash = (hash ^ (section->Blocks[i] | section->Metadata[i] << 16)) * 0x100000001b3ull;
+            }
+        }
+    }
+    return hash;
+}
+
+// Without a worker count the ticks run on the calling thread
+TickRun RunTicks(const std::optional<unsigned> workerCount)
+{
+    ThreadPool generationPool;
+    std::unique_ptr<ThreadPool> threadPool;
+    if (workerCount)
+        threadPool = std::make_unique<ThreadPool>(*workerCount);
+    World world(threadPool.get());
+    const int maxHeight = GenerateTerrain(world, generationPool, TERRAIN_RADIUS);
+
+    // Falling sand for the scheduled ticks, the grass of the default blocks dies off under it in random ticks
+    const BlockId sand = world.GetBlockRegistry().Register("sand", BlockType::Solid);
+    BlockTicker &ticker = world.GetBlockTicker();
+    ticker.SetSettings({.TickInterval = 0.05f, .RandomTicksPerSection = RANDOM_TICKS_PER_SECTION});
+    ticker.SetScheduledTickHandler(sand, [sand](BlockTickContext &context, const glm::ivec3 &position) {
+        if (context.GetBlock(position.x, position.y - 1, position.z) != BLOCK_AIR)
+            return;
+        context.SetBlock(position.x, position.y, position.z, BLOCK_AIR);
+        context.SetBlock(position.x, position.y - 1, position.z, sand);
+        context.ScheduleTick(position.x, position.y - 1, position.z, 1);
+    });
+
+    const int extent = TERRAIN_RADIUS * SECTION_SIZE;
+    for (int x = -extent; x < extent; x += SAND_SPACING)
+    {
+        for (int z = -extent; z < extent; z += SAND_SPACING)
+        {
+            for (int layer = 0; layer < SAND_LAYERS; layer++)
+                world.SetBlock(x, maxHeight + 2 + 2 * layer, z, sand);
+        }
+    }
+
+    TickRun run;
+    for (int i = 0; i < TICK_COUNT; i++)
+    {
+        run.Time += Measure([&ticker] { ticker.Tick(); });
+        run.Handled += ticker.GetLastTickCount();
+        // The relighting of the moved blocks isn't part of the ticks
+        world.GetLightEngine().Propagate();
+    }
+    run.Hash = HashBlocks(world);
+    return run;
+}
+} // namespace
+
+bool RunTickBenchmark()
+{
+    const unsigned hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<std::optional<unsigned>> workerCounts = {std::nullopt};
+    for (unsigned workers = 1; workers < hardwareThreads; workers *= 2)
+        workerCounts.emplace_back(workers);
+    if (hardwareThreads > 1)
+        workerCounts.emplace_back(hardwareThreads - 1);
+
+    std::cout << TICK_COUNT << " ticks of falling sand and " << RANDOM_TICKS_PER_SECTION
+              << " random ticks per section, " << hardwareThreads << " hardware threads" << std::endl;
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::left << std::setw(10) << "Workers" << std::right << std::setw(12) << "ms/tick" << std::setw(14)
+              << "handlers/s" << std::setw(10) << "speedup" << std::endl;
+
+    bool deterministic = true;
+    std::optional<TickRun> baseline;
+    for (const std::optional<unsigned> &workers : workerCounts)
+    {
+        const TickRun run = RunTicks(workers);
+        if (!baseline)
+            baseline = run;
+        if (run.Handled != baseline->Handled || run.Hash != baseline->Hash)
+        {
+            std::cerr << "Ticking with " << (workers ? *workers : 0)
+                      << " workers ended up with different blocks than on the calling thread" << std::endl;
+            deterministic = false;
+        }
+
+        // The calling thread takes part in the work next to the workers
+        std::cout << std::left << std::setw(10) << (workers ? std::to_string(*workers) + " + 1" : "caller")
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(12)
+                  << run.Time / TICK_COUNT * 1000.0 << std::setprecision(0) << std::setw(14)
+                  << static_cast<double>(run.Handled) / run.Time << std::setprecision(2) << std::setw(10)
+                  << baseline->Time / run.Time << std::defaultfloat << std::endl;
+    }
+    std::cout << std::setprecision(precision);
+    return deterministic;
+}
+
+} // namespace BloxxBench
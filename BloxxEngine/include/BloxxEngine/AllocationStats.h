@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <cstdint>
+
+namespace BloxxEngine
+{
+
+struct AllocationCounters
+{
+    uint64_t Count = 0;
+    uint64_t Bytes = 0;
+};
+
+/**
+ * Heap allocations made through operator new since startup, by any thread. The engine replaces the global operator
+ * new to count them, so the difference between two calls shows what a frame allocated.
+ */
+[[nodiscard]] AllocationCounters GetAllocationCounters();
+
+} // namespace BloxxEngine
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Asset processing shared by the AssetPacker and the hot reload path, so a reloaded asset matches a packed one. This
+ * header must stay free of GL and engine dependencies.
+ */
+namespace BloxxEngine
+{
+
+/**
+ * Resolves #include "file" directives relative to the including file, strips comments and blank lines.
+ * @param files when given, receives every file that was read, the shader itself included
+ */
+inline bool PreprocessShader(const std::filesystem::path &path, std::string &out,
+                             std::set<std::filesystem::path> &includeStack,
+                             std::vector<std::filesystem::path> *files = nullptr)
+{
+    const std::filesystem::path canonical = std::filesystem::weakly_canonical(path);
+    if (includeStack.contains(canonical))
+    {
+        std::cerr << "Recursive include of " << path.string() << std::endl;
+        return false;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Could not open shader " << path.string() << std::endl;
+        return false;
+    }
+    includeStack.insert(canonical);
+    if (files)
+        files->push_back(path.lexically_normal());
+
+    const std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Remove comments first so commented out includes are ignored
+    std::string stripped;
+    stripped.reserve(source.size());
+    for (size_t i = 0; i < source.size(); i++)
+    {
+        if (source.compare(i, 2, "//") == 0)
+        {
+            while (i < source.size() && source[i] != '\n')
+                i++;
+            stripped += '\n';
+        }
+        else if (source.compare(i, 2, "/*") == 0)
+        {
+            const size_t end = source.find("*/", i + 2);
+            i = end == std::string::npos ? source.size() : end + 1;
+        }
+        else if (source[i] != '\r')
+        {
+            stripped += source[i];
+        }
+    }
+
+    size_t lineStart = 0;
+    while (lineStart < stripped.size())
+    {
+        size_t lineEnd = stripped.find('\n', lineStart);
+        if (lineEnd == std::string::npos)
+            lineEnd = stripped.size();
+
+        std::string line = stripped.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
+        line.erase(line.find_last_not_of(" \t") + 1);
+        const size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos)
+            continue;
+
+        if (line.compare(first, 8, "#include") == 0)
+        {
+            const size_t open = line.find('"', first);
+            const size_t close = line.find('"', open + 1);
+            if (open == std::string::npos || close == std::string::npos)
+            {
+                std::cerr << path.string() << ": malformed #include" << std::endl;
+                return false;
+            }
+            if (!PreprocessShader(path.parent_path() / line.substr(open + 1, close - open - 1), out, includeStack,
+                                  files))
+                return false;
+            continue;
+        }
+
+        out += line;
+        out += '\n';
+    }
+
+    includeStack.erase(canonical);
+    return true;
+}
+
+/**
+ * Appends box filtered levels to a tightly packed RGBA8 mip chain until it reaches 1x1 or holds maxLevels levels.
+ * levels and sizes start out with the full size image only.
+ */
+inline void GenerateMips(std::vector<std::vector<uint8_t>> &levels, std::vector<std::pair<int, int>> &sizes,
+                         const size_t maxLevels)
+{
+    while ((sizes.back().first > 1 || sizes.back().second > 1) && levels.size() < maxLevels)
+    {
+        const auto [srcW, srcH] = sizes.back();
+        const int dstW = std::max(1, srcW / 2);
+        const int dstH = std::max(1, srcH / 2);
+        const std::vector<uint8_t> &src = levels.back();
+        std::vector<uint8_t> dst(static_cast<size_t>(dstW) * dstH * 4);
+
+        for (int y = 0; y < dstH; y++)
+        {
+            const int y0 = std::min(y * 2, srcH - 1);
+            const int y1 = std::min(y * 2 + 1, srcH - 1);
+            for (int x = 0; x < dstW; x++)
+            {
+                const int x0 = std::min(x * 2, srcW - 1);
+                const int x1 = std::min(x * 2 + 1, srcW - 1);
+                for (int c = 0; c < 4; c++)
+                {
+                    const int sum = src[(y0 * srcW + x0) * 4 + c] + src[(y0 * srcW + x1) * 4 + c] +
+                                    src[(y1 * srcW + x0) * 4 + c] + src[(y1 * srcW + x1) * 4 + c];
+                    dst[(y * dstW + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+
+        levels.push_back(std::move(dst));
+        sizes.emplace_back(dstW, dstH);
+    }
+}
+
+} // namespace BloxxEngine
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+/**
+ * On-disk layout of the packed asset archive (.bxpak).
+ *
+ * This header is shared between the runtime and the AssetPacker tool, so it must stay free of GL and engine
+ * dependencies. All offsets are absolute file offsets, all data blocks are aligned to ASSET_ARCHIVE_ALIGNMENT so
+ * they can be handed to the driver straight from the mapped file.
+ */
+namespace BloxxEngine
+{
+
+constexpr uint32_t ASSET_ARCHIVE_MAGIC = 0x4B505842; // "BXPK"
+constexpr uint32_t ASSET_ARCHIVE_VERSION = 1;
+constexpr uint64_t ASSET_ARCHIVE_ALIGNMENT = 16;
+constexpr uint32_t ASSET_MAX_MIP_LEVELS = 16;
+
+enum class AssetKind : uint32_t
+{
+    Raw = 0,
+    Texture,
+    Shader,
+    Mesh,
+};
+
+enum class TextureFormat : uint32_t
+{
+    RGBA8 = 0,
+};
+
+#pragma pack(push, 1)
+struct AssetArchiveHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t EntryCount;
+    uint32_t Reserved;
+    uint64_t EntryTableOffset;
+    uint64_t StringTableOffset;
+    uint64_t StringTableSize;
+};
+
+/**
+ * Entries are sorted by PathHash so lookups are a binary search over the mapped table.
+ */
+struct AssetArchiveEntry
+{
+    uint64_t PathHash;
+    uint32_t PathOffset; // Relative to the string table
+    uint32_t PathLength;
+    AssetKind Kind;
+    uint32_t Reserved;
+    uint64_t DataOffset;
+    uint64_t DataSize;
+};
+
+struct TextureMipHeader
+{
+    uint32_t Width;
+    uint32_t Height;
+    uint64_t DataOffset; // Absolute file offset of the tightly packed pixel rows
+    uint64_t DataSize;
+};
+
+/**
+ * Payload of an AssetKind::Texture entry. Pixels are stored bottom row first (the same orientation stb_image
+ * produces with vertical flipping enabled), so they can be passed to glTexImage2D as is.
+ */
+struct TextureAssetHeader
+{
+    uint32_t Width;
+    uint32_t Height;
+    TextureFormat Format;
+    uint32_t MipCount;
+    TextureMipHeader Mips[ASSET_MAX_MIP_LEVELS];
+};
+
+/**
+ * Vertex of a cooked mesh, bound as is by the runtime. The normal, tangent and bitangent are signed normalised
+ * 10:10:10:2 (GL_INT_2_10_10_10_REV), texture coordinates are half floats.
+ */
+struct PackedMeshVertex
+{
+    float Position[3];
+    uint32_t Normal;
+    uint32_t Tangent;
+    uint32_t Bitangent;
+    uint16_t TexCoords[2];
+    uint8_t AmbientOcclusion; // Unsigned normalised
+    uint8_t Reserved[3];
+};
+
+/**
+ * Payload of an AssetKind::Mesh entry, a triangle list with its tangent frames computed by the packer.
+ */
+struct MeshAssetHeader
+{
+    uint32_t VertexCount;
+    uint32_t IndexCount;
+    uint32_t IndexSize; // 2 or 4 bytes, 2 when all vertices can be addressed with 16 bits
+    uint32_t Reserved;
+    float BoundsMin[3];
+    float BoundsMax[3];
+    uint64_t VertexOffset; // Absolute file offsets of the aligned vertex and index arrays
+    uint64_t IndexOffset;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PackedMeshVertex) == 32);
+
+/**
+ * FNV-1a hash of a normalised archive path ("textures/Stone_basecolor.png").
+ */
+constexpr uint64_t HashAssetPath(const std::string_view path)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char c : path)
+    {
+        hash ^= static_cast<uint8_t>(c == '\\' ? '/' : c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+} // namespace BloxxEngine
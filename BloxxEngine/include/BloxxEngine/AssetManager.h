@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "AsyncTask.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+enum class AssetState : uint8_t
+{
+    Loading,
+    Ready,
+    Failed,
+};
+
+template <typename T> struct AssetSlot
+{
+    std::string Path;
+    std::unique_ptr<T> Asset; // Only touched on the main thread
+    T *Placeholder = nullptr;
+    std::atomic<AssetState> State{AssetState::Loading};
+};
+
+/**
+ * Reference-counted handle to an asset owned by the AssetManager. Until loading finishes Get() returns the
+ * placeholder, so a handle can be used for rendering right away. The asset is freed when the last handle goes.
+ */
+template <typename T> class AssetHandle
+{
+  public:
+    AssetHandle() = default;
+
+    [[nodiscard]] T *Get() const
+    {
+        if (!m_Slot)
+            return nullptr;
+        return m_Slot->Asset ? m_Slot->Asset.get() : m_Slot->Placeholder;
+    }
+    T *operator->() const
+    {
+        return Get();
+    }
+    explicit operator bool() const
+    {
+        return m_Slot != nullptr;
+    }
+
+    [[nodiscard]] bool IsReady() const
+    {
+        return m_Slot && m_Slot->State == AssetState::Ready;
+    }
+    [[nodiscard]] const std::string &GetPath() const
+    {
+        return m_Slot->Path;
+    }
+
+  private:
+    friend class AssetManager;
+    explicit AssetHandle(std::shared_ptr<AssetSlot<T>> slot) : m_Slot(std::move(slot))
+    {
+    }
+
+    std::shared_ptr<AssetSlot<T>> m_Slot;
+};
+
+/**
+ * Loads shaders and textures asynchronously. File reads and image decoding happen on the thread pool, only the
+ * GL upload resumes on the main thread inside Update(). Requests for the same path share one asset, textures only
+ * when they also ask for the same filter and wrap modes.
+ */
+class AssetManager
+{
+  public:
+    explicit AssetManager(ThreadPool &threadPool);
+    ~AssetManager();
+
+    AssetManager(AssetManager &) = delete;
+    AssetManager(AssetManager &&) = delete;
+    AssetManager &operator=(AssetManager &) = delete;
+    AssetManager &operator=(AssetManager &&) = delete;
+
+    /**
+     * @param placeholderColor 0xRRGGBBAA colour of the 1x1 texture returned while loading
+     */
+    AssetHandle<Texture> LoadTexture(const std::string &path, Texture::FilterMode filterMode = Texture::FilterMode::Linear,
+                                     Texture::WrapMode wrapMode = Texture::WrapMode::Clamp,
+                                     uint32_t placeholderColor = 0xFFFFFFFF);
+    AssetHandle<Shader> LoadShader(const std::string &vertexPath, const std::string &fragmentPath);
+
+    /**
+     * Makes reloads of assets below mountPoint read from sourceDir on disk, bypassing mounted archives.
+     */
+    void SetReloadSource(const std::string &mountPoint, const std::string &sourceDir);
+
+    /**
+     * Rebuilds every loaded asset that uses the given file, in place. Existing handles stay valid and keep
+     * returning the old asset until the new one is uploaded; on failure the old asset is kept.
+     */
+    void Reload(const std::string &path);
+
+    /**
+     * Runs queued main thread continuations (GL uploads) until the time budget is used up.
+     * Must be called on the thread owning the GL context, once per frame.
+     */
+    void Update(double budgetSeconds = 0.002);
+
+    [[nodiscard]] int GetPendingCount() const
+    {
+        return m_PendingCount;
+    }
+
+    // Awaitables used by the loader coroutines to hop between threads
+    struct WorkerAwaiter
+    {
+        AssetManager *Manager;
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle) const;
+        void await_resume() const noexcept
+        {
+        }
+    };
+    struct MainThreadAwaiter
+    {
+        AssetManager *Manager;
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle) const;
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    WorkerAwaiter ResumeOnWorker()
+    {
+        return {this};
+    }
+    MainThreadAwaiter ResumeOnMainThread()
+    {
+        return {this};
+    }
+
+  private:
+    struct TextureRequest
+    {
+        std::weak_ptr<AssetSlot<Texture>> Slot;
+        std::string Path;
+        Texture::FilterMode FilterMode;
+        Texture::WrapMode WrapMode;
+    };
+    struct ShaderRequest
+    {
+        std::weak_ptr<AssetSlot<Shader>> Slot;
+        std::string VertexPath;
+        std::string FragmentPath;
+        std::vector<std::string> Files; // Both stages and their includes, when read from disk
+    };
+
+    AsyncTask LoadTextureAsync(std::shared_ptr<AssetSlot<Texture>> slot, Texture::FilterMode filterMode,
+                               Texture::WrapMode wrapMode, bool fromSource);
+    AsyncTask LoadShaderAsync(std::shared_ptr<AssetSlot<Shader>> slot, std::string vertexPath,
+                              std::string fragmentPath, bool fromSource);
+
+    // Forgets requests whose assets were freed
+    void PruneRequests();
+    [[nodiscard]] std::string GetSourcePath(const std::string &path) const;
+    // The inverse of GetSourcePath()
+    [[nodiscard]] std::string GetAssetPath(const std::filesystem::path &sourcePath) const;
+    Texture *GetPlaceholderTexture(uint32_t color);
+
+    ThreadPool &m_ThreadPool;
+
+    std::mutex m_MainThreadMutex;
+    std::vector<std::coroutine_handle<>> m_MainThreadQueue;
+    std::atomic<int> m_PendingCount{0};
+
+    std::unordered_map<std::string, TextureRequest> m_Textures; // Keyed by path, filter and wrap mode
+    std::unordered_map<std::string, ShaderRequest> m_Shaders;   // Keyed by both paths
+
+    std::string m_ReloadMountPoint;
+    std::string m_ReloadSourceDir;
+
+    std::unordered_map<uint32_t, std::unique_ptr<Texture>> m_PlaceholderTextures;
+    std::unique_ptr<Shader> m_PlaceholderShader;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <coroutine>
+#include <exception>
+
+namespace BloxxEngine
+{
+
+/**
+ * Fire-and-forget coroutine type. The coroutine starts running immediately and frees its own frame when it
+ * finishes; where it continues after a co_await is decided by the awaitable (see AssetManager).
+ */
+struct AsyncTask
+{
+    struct promise_type
+    {
+        AsyncTask get_return_object() noexcept
+        {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() noexcept
+        {
+        }
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+} // namespace BloxxEngine
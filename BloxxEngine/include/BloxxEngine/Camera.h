@@ -34,6 +34,8 @@ class Camera
 
     void Move(Movement direction, float deltaTime);
     void Rotate(float xOffset, float yOffset, bool constrainPitch = true);
+    // Sets the Euler angles directly, in degrees
+    void SetOrientation(float yaw, float pitch);
     void Zoom(float yOffset);
 
     // Camera attributes
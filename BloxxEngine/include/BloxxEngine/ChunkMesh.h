@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Mesh.h"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+class Chunk;
+class World;
+
+// Level n meshes a grid downsampled by 2^n on every axis
+constexpr int CHUNK_LOD_COUNT = 4;
+
+/**
+ * The geometry of one chunk, on the CPU and in GL buffers. Owned by the WorldRenderer, the chunks themselves only
+ * hold blocks so the world runs without GL.
+ */
+class ChunkMesh
+{
+  public:
+    ChunkMesh() = default;
+    ~ChunkMesh();
+
+    ChunkMesh(ChunkMesh &) = delete;
+    ChunkMesh &operator=(ChunkMesh &) = delete;
+
+    // Drops the geometry for reuse by another chunk, the mesh buffers and the GL buffers are kept
+    void Reset();
+
+    /**
+     * Builds the chunk geometry on the CPU, neighbouring chunks are read for the faces and occlusion at the borders.
+     * Safe to run on a worker while the world isn't modified, the GL upload happens in the next Draw().
+     *
+     * Above level of detail 0 the blocks are downsampled by majority first. Borders towards neighbours at another
+     * level get skirts, indexed [x or z][positive side]: side faces kept one cell below the neighbour's surface,
+     * hiding the cracks between the two.
+     */
+    void Generate(const World &world, const Chunk &chunk, const bool (&skirts)[2][2]);
+    // Draws the opaque geometry, returns false when there was nothing to draw
+    bool Draw();
+
+    /**
+     * Re-sorts the translucent quads of each section back to front, for the sections the camera moved to another
+     * voxel relative to since their last sort. Only the indices are uploaded again. Touches nothing but this mesh,
+     * so meshes can be sorted on different workers. Returns the number of sections that were re-sorted.
+     */
+    int SortTranslucent(const glm::vec3 &cameraPosition);
+    // Draws the translucent sections far to near, returns the number of draw calls
+    int DrawTranslucent(const glm::vec3 &cameraPosition);
+    [[nodiscard]] bool HasTranslucent() const { return m_Mesh.TranslucentCount != 0; }
+
+    // Level of detail used by the next Generate()
+    void SetLod(const int lod) { m_Lod = lod; }
+    [[nodiscard]] int GetLod() const { return m_Lod; }
+
+  private:
+    // Translucent quads of one section, their indices follow the opaque ones in the index buffer
+    struct TranslucentSection
+    {
+        int SectionIndex = 0;
+        std::vector<glm::vec3> QuadCenters;
+        std::vector<GLuint> QuadIndices; // Six per quad, in mesh order
+        std::vector<GLuint> Indices;     // The quads in the last sorted order
+        std::vector<std::pair<float, uint32_t>> Order;
+        size_t IndexOffset = 0;
+        glm::ivec3 SortVoxel{std::numeric_limits<int>::min()};
+        bool NeedsUpload = false;
+    };
+
+    /**
+     * CPU side of the mesh. Generate() builds it in a scratch kept per thread and swaps it in, so neither side gives
+     * up its capacity and remeshing stops allocating once the buffers have grown.
+     */
+    struct MeshData
+    {
+        std::vector<Vertex> Vertices;
+        std::vector<GLuint> Indices; // Opaque geometry
+        std::vector<TranslucentSection> Translucent;
+        size_t TranslucentCount = 0; // Sections in use, the ones after them are kept for their capacity
+
+        void Clear();
+        TranslucentSection &AddTranslucent(int sectionIndex);
+        [[nodiscard]] std::span<TranslucentSection> GetTranslucent() { return {Translucent.data(), TranslucentCount}; }
+    };
+
+    int m_ChunkX = 0, m_ChunkZ = 0; // Of the last Generate()
+    MeshData m_Mesh;
+    GLuint m_VAO = 0, m_VBO = 0, m_EBO = 0;
+    size_t m_VertexBufferSize = 0, m_IndexBufferSize = 0; // Allocated GL buffer sizes, in bytes
+    size_t m_IndexCount = 0;
+    int m_Lod = 0;
+    bool m_NeedsUpload = false;
+
+    void SetupMesh();
+    void UploadTranslucentIndices();
+    static void AddQuad(MeshData &mesh, std::vector<GLuint> &indices, const std::array<glm::vec3, 4> &corners,
+                        const glm::vec3 &normal, const glm::vec3 &tangent, const glm::vec3 &bitangent,
+                        const glm::vec2 &size, const std::array<uint8_t, 4> &ambientOcclusion);
+};
+
+} // namespace BloxxEngine
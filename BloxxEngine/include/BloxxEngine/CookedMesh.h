@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "AssetFormat.h"
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace BloxxEngine
+{
+
+/**
+ * A mesh cooked by the AssetPacker, ready to be uploaded without touching the vertices. The arrays are not owned,
+ * they point into a mapped asset archive.
+ */
+struct CookedMesh
+{
+    uint32_t VertexCount = 0;
+    uint32_t IndexCount = 0;
+    uint32_t IndexSize = 4; // Bytes per index, 2 or 4
+    glm::vec3 BoundsMin{0};
+    glm::vec3 BoundsMax{0};
+    const PackedMeshVertex *Vertices = nullptr;
+    const void *Indices = nullptr;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Entity.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+/**
+ * Sparse set of the entities holding one component type. The sparse array maps an entity index to its position in
+ * the dense arrays, which hold the entities and their components packed without gaps, in the same order.
+ */
+class ComponentPoolBase
+{
+  public:
+    virtual ~ComponentPoolBase() = default;
+
+    [[nodiscard]] bool Contains(const uint32_t index) const
+    {
+        return index < m_Sparse.size() && m_Sparse[index] != Absent;
+    }
+    [[nodiscard]] size_t GetSize() const { return m_Entities.size(); }
+    [[nodiscard]] std::span<const Entity> GetEntities() const { return m_Entities; }
+
+    // Swaps the last component into the gap, so the order of the others changes
+    virtual void Remove(uint32_t index) = 0;
+
+  protected:
+    static constexpr uint32_t Absent = ~0u;
+
+    // Returns the dense position of a new entity
+    uint32_t Insert(const Entity entity)
+    {
+        if (m_Sparse.size() <= entity.Index)
+            m_Sparse.resize(entity.Index + 1, Absent);
+        m_Sparse[entity.Index] = static_cast<uint32_t>(m_Entities.size());
+        m_Entities.push_back(entity);
+        return m_Sparse[entity.Index];
+    }
+
+    // Returns the dense position that was freed, the last entity has been moved there
+    uint32_t Erase(const uint32_t index)
+    {
+        const uint32_t position = m_Sparse[index];
+        const Entity last = m_Entities.back();
+        m_Entities[position] = last;
+        m_Sparse[last.Index] = position;
+        m_Entities.pop_back();
+        m_Sparse[index] = Absent;
+        return position;
+    }
+
+    std::vector<uint32_t> m_Sparse;
+    std::vector<Entity> m_Entities;
+};
+
+/**
+ * Components of type T in one contiguous array, so systems run over them linearly. Adding or removing components
+ * of this type invalidates references to them.
+ */
+template <typename T> class ComponentPool final : public ComponentPoolBase
+{
+  public:
+    // Replaces the component when the entity already has one
+    template <typename... Args> T &Emplace(const Entity entity, Args &&...args)
+    {
+        if (Contains(entity.Index))
+            return m_Components[m_Sparse[entity.Index]] = T(std::forward<Args>(args)...);
+
+        Insert(entity);
+        return m_Components.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void Remove(const uint32_t index) override
+    {
+        if (!Contains(index))
+            return;
+
+        const uint32_t position = Erase(index);
+        if (position != m_Components.size() - 1)
+            m_Components[position] = std::move(m_Components.back());
+        m_Components.pop_back();
+    }
+
+    [[nodiscard]] T &Get(const uint32_t index) { return m_Components[m_Sparse[index]]; }
+    [[nodiscard]] const T &Get(const uint32_t index) const { return m_Components[m_Sparse[index]]; }
+
+    [[nodiscard]] std::span<T> GetComponents() { return m_Components; }
+    [[nodiscard]] std::span<const T> GetComponents() const { return m_Components; }
+
+    void Reserve(const size_t count)
+    {
+        m_Entities.reserve(count);
+        m_Components.reserve(count);
+    }
+
+  private:
+    std::vector<T> m_Components;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <cstdint>
+
+namespace BloxxEngine
+{
+
+/**
+ * Handle to an entity of an EntityRegistry. Indices are reused once an entity is destroyed, the generation tells a
+ * stale handle apart from the entity that took its index over.
+ */
+struct Entity
+{
+    static constexpr uint32_t NullIndex = ~0u;
+
+    uint32_t Index = NullIndex;
+    uint32_t Generation = 0;
+
+    [[nodiscard]] bool IsNull() const { return Index == NullIndex; }
+
+    bool operator==(const Entity &) const = default;
+};
+
+constexpr Entity NullEntity{};
+
+} // namespace BloxxEngine
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "BloxxEngine/ThreadPool.h"
+#include "ComponentPool.h"
+#include "Entity.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+// Dense ids for the component types, handed out the first time a type is used
+uint32_t NextComponentTypeId();
+template <typename T> uint32_t ComponentTypeId()
+{
+    static const uint32_t id = NextComponentTypeId();
+    return id;
+}
+
+/**
+ * The entities holding all of Ts. Iteration walks the dense array of the smallest pool and looks the other components
+ * up through their sparse arrays, a view over a single type is a plain loop over its component array.
+ *
+ * Components can be modified while iterating, but no entities or components may be added or removed.
+ */
+template <typename... Ts> class EntityView
+{
+  public:
+    explicit EntityView(ComponentPool<Ts> *...pools) : m_Pools(pools...)
+    {
+        m_Lead = std::get<0>(m_Pools);
+        ((m_Lead = pools->GetSize() < m_Lead->GetSize() ? pools : m_Lead), ...);
+    }
+
+    // Calls func(entity, components...) for every matching entity
+    template <typename F> void Each(F &&func) const { EachInRange(0, m_Lead->GetSize(), func); }
+
+    /**
+     * Runs Each() over batches of grainSize candidates on the pool. func is called concurrently for different
+     * entities.
+     */
+    template <typename F> void ParallelEach(ThreadPool &threadPool, const size_t grainSize, F &&func) const
+    {
+        threadPool.ParallelFor(m_Lead->GetSize(), grainSize,
+                               [this, &func](const size_t begin, const size_t end) { EachInRange(begin, end, func); });
+    }
+
+    // Upper bound of the matching entities: the size of the smallest pool
+    [[nodiscard]] size_t GetCandidateCount() const { return m_Lead->GetSize(); }
+
+  private:
+    template <typename F> void EachInRange(const size_t begin, const size_t end, F &func) const
+    {
+        const std::span<const Entity> entities = m_Lead->GetEntities();
+        if constexpr (sizeof...(Ts) == 1)
+        {
+            const auto components = std::get<0>(m_Pools)->GetComponents();
+            for (size_t i = begin; i < end; i++)
+                func(entities[i], components[i]);
+        }
+        else
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const Entity entity = entities[i];
+                std::apply(
+                    [&](ComponentPool<Ts> *...pools) {
+                        if ((pools->Contains(entity.Index) && ...))
+                            func(entity, pools->Get(entity.Index)...);
+                    },
+                    m_Pools);
+            }
+        }
+    }
+
+    std::tuple<ComponentPool<Ts> *...> m_Pools;
+    const ComponentPoolBase *m_Lead;
+};
+
+/**
+ * Entities and their components, stored as a sparse set per component type: every component type lives in its own
+ * contiguous array instead of in per-entity objects.
+ *
+ * Not synchronised, entities and components are created and destroyed from one thread. Views can run their
+ * systems in parallel.
+ */
+class EntityRegistry
+{
+  public:
+    EntityRegistry() = default;
+
+    EntityRegistry(EntityRegistry &) = delete;
+    EntityRegistry &operator=(EntityRegistry &) = delete;
+
+    Entity Create();
+    // Removes all of its components, the handle and any copies of it are no longer alive afterwards
+    void Destroy(Entity entity);
+    [[nodiscard]] bool IsAlive(Entity entity) const;
+    [[nodiscard]] size_t GetAliveCount() const { return m_Generations.size() - m_FreeIndices.size(); }
+
+    // The entity has to be alive, a stale handle would write into the entity that reuses its index. Replaces the
+    // component when the entity already has one.
+    template <typename T, typename... Args> T &Add(const Entity entity, Args &&...args)
+    {
+        assert(IsAlive(entity) && "Adding a component to a destroyed entity");
+        return GetPool<T>().Emplace(entity, std::forward<Args>(args)...);
+    }
+    template <typename T> void Remove(const Entity entity)
+    {
+        if (IsAlive(entity))
+            GetPool<T>().Remove(entity.Index);
+    }
+
+    template <typename T> [[nodiscard]] bool Has(const Entity entity) const
+    {
+        const ComponentPool<T> *pool = FindPool<T>();
+        return pool && IsAlive(entity) && pool->Contains(entity.Index);
+    }
+    // The entity has to be alive and have the component
+    template <typename T> [[nodiscard]] T &Get(const Entity entity)
+    {
+        assert(IsAlive(entity) && "Getting a component of a destroyed entity");
+        return GetPool<T>().Get(entity.Index);
+    }
+    template <typename T> [[nodiscard]] T *TryGet(const Entity entity)
+    {
+        ComponentPool<T> *pool = FindPool<T>();
+        return pool && IsAlive(entity) && pool->Contains(entity.Index) ? &pool->Get(entity.Index) : nullptr;
+    }
+
+    template <typename... Ts> [[nodiscard]] EntityView<Ts...> View() { return EntityView<Ts...>(&GetPool<Ts>()...); }
+
+    template <typename T> ComponentPool<T> &GetPool()
+    {
+        const uint32_t id = ComponentTypeId<T>();
+        if (m_Pools.size() <= id)
+            m_Pools.resize(id + 1);
+        if (!m_Pools[id])
+            m_Pools[id] = std::make_unique<ComponentPool<T>>();
+        return static_cast<ComponentPool<T> &>(*m_Pools[id]);
+    }
+
+  private:
+    template <typename T> ComponentPool<T> *FindPool() const
+    {
+        const uint32_t id = ComponentTypeId<T>();
+        return id < m_Pools.size() ? static_cast<ComponentPool<T> *>(m_Pools[id].get()) : nullptr;
+    }
+
+    std::vector<uint32_t> m_Generations; // Per entity index
+    std::vector<uint32_t> m_FreeIndices;
+    std::vector<std::unique_ptr<ComponentPoolBase>> m_Pools; // By component type id
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "BloxxEngine/Frustum.h"
+#include "Entity.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+/**
+ * Uniform grid over entity positions for proximity queries. Cells default to the size of a chunk section, so a cell
+ * lines up with the blocks around it. Each cell keeps its entities and their positions in two packed arrays.
+ *
+ * Insert() and Remove() take effect right away. Move() only records the new position, which can be done from
+ * several threads at once for different entities, and ApplyUpdates() moves the entities between cells once per
+ * tick. Queries see the positions of the last ApplyUpdates(), so they give the same answers throughout a tick.
+ *
+ * Queries write the matches to a caller-provided buffer and return the total number of matches, the ones beyond
+ * the end of the buffer are dropped.
+ */
+class SpatialGrid
+{
+  public:
+    explicit SpatialGrid(float cellSize = 16.0f);
+
+    void Insert(Entity entity, const glm::vec3 &position);
+    void Remove(Entity entity);
+    void Move(Entity entity, const glm::vec3 &position);
+    void ApplyUpdates();
+
+    [[nodiscard]] bool Contains(Entity entity) const;
+
+    // Entities within radius of center
+    size_t QueryRadius(const glm::vec3 &center, float radius, std::span<Entity> results) const;
+    // Entities inside the box, bounds included
+    size_t QueryBox(const glm::vec3 &min, const glm::vec3 &max, std::span<Entity> results) const;
+    // Entities whose bounding sphere of the given radius overlaps the frustum
+    size_t QueryFrustum(const Frustum &frustum, float radius, std::span<Entity> results) const;
+
+    [[nodiscard]] size_t GetCount() const { return m_Count; }
+    [[nodiscard]] size_t GetCellCount() const { return m_Cells.size(); }
+    // Entities that changed cells in the last ApplyUpdates()
+    [[nodiscard]] size_t GetLastCellChanges() const { return m_LastCellChanges; }
+
+  private:
+    struct Cell
+    {
+        glm::ivec3 Coordinate;
+        std::vector<Entity> Entities;
+        std::vector<glm::vec3> Positions;
+    };
+
+    // Per entity index
+    struct Item
+    {
+        Entity Handle = NullEntity;
+        Cell *Owner = nullptr;   // nullptr when not in the grid
+        glm::ivec3 Coordinate{}; // Of the owning cell, kept here so moves within the cell don't have to look
+        uint32_t Slot = 0;       // Index in the arrays of the cell
+        glm::vec3 Target{0};     // Position passed to the last Move()
+        bool Moved = false;
+    };
+
+    struct CellKeyHash
+    {
+        size_t operator()(uint64_t key) const;
+    };
+
+    [[nodiscard]] glm::ivec3 ToCell(const glm::vec3 &position) const;
+    [[nodiscard]] static uint64_t CellKey(const glm::ivec3 &cell);
+
+    Cell &GetOrCreateCell(const glm::ivec3 &coordinate);
+    void AddToCell(Item &item, Cell &cell, const glm::vec3 &position);
+    void RemoveFromCell(const Item &item);
+
+    // Calls visit(cell) for the existing cells overlapping the box
+    template <typename F> void ForEachCell(const glm::vec3 &min, const glm::vec3 &max, F &&visit) const;
+
+    float m_CellSize;
+    float m_InverseCellSize;
+
+    // Cells stay allocated once created, so entities going back and forth between two cells don't reallocate
+    std::unordered_map<uint64_t, Cell, CellKeyHash> m_Cells;
+    std::vector<Item> m_Items;
+    size_t m_Count = 0;
+    size_t m_LastCellChanges = 0;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Events/Event.h"
+#include "FrameArena.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <span>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+/**
+ * Queued event bus. Events are posted from any thread into per-type queues and delivered in batches, one type at a
+ * time, when the main thread calls Dispatch() once per frame.
+ *
+ * Storage for every queue is carved out of two frame arenas when a type is first subscribed to, so posting never
+ * allocates and never takes a lock: it reserves a slot with an atomic increment. One arena is written while the
+ * other one is dispatched. Types with IsCoalesced are merged into a single event before delivery.
+ */
+class EventBus
+{
+  public:
+    /**
+     * @param eventsPerType how many events of one type a single frame can hold, the rest is dropped
+     */
+    explicit EventBus(uint32_t eventsPerType = 1024);
+
+    EventBus(EventBus &) = delete;
+    EventBus(EventBus &&) = delete;
+    EventBus &operator=(EventBus &) = delete;
+    EventBus &operator=(EventBus &&) = delete;
+
+    /**
+     * Registers a batch handler. All subscriptions have to be made before events are posted.
+     */
+    template <typename T> void Subscribe(std::function<void(std::span<const T>)> handler);
+
+    /**
+     * Queues an event for the next Dispatch(). Safe to call from any thread.
+     * @return false if nobody subscribed to T or this frame's queue for T is full
+     */
+    template <typename T, typename... Args> bool Post(Args &&...args);
+
+    /**
+     * Delivers everything posted since the previous call. Main thread only.
+     */
+    void Dispatch();
+
+    [[nodiscard]] uint64_t GetDroppedCount() const
+    {
+        return m_DroppedCount;
+    }
+
+  private:
+    struct Channel
+    {
+        size_t EventSize;
+        std::array<std::byte *, 2> Buffers;
+        std::array<std::atomic<uint32_t>, 2> Counts{};
+        std::vector<std::function<void(const std::byte *, uint32_t)>> Handlers;
+        void (*Deliver)(Channel &channel, std::byte *events, uint32_t count);
+    };
+
+    template <typename T> static void Deliver(Channel &channel, std::byte *events, uint32_t count);
+
+    const uint32_t m_EventsPerType;
+    std::array<FrameArena, 2> m_Arenas;
+    std::array<std::unique_ptr<Channel>, EventTypeCount> m_Channels;
+
+    std::atomic<uint32_t> m_WriteFrame{0};
+    std::array<std::atomic<int>, 2> m_Writers{};
+    std::atomic<uint64_t> m_DroppedCount{0};
+};
+
+template <typename T> void EventBus::Subscribe(std::function<void(std::span<const T>)> handler)
+{
+    auto &channel = m_Channels[static_cast<size_t>(T::GetStaticType())];
+    if (!channel)
+    {
+        channel = std::make_unique<Channel>();
+        channel->EventSize = sizeof(T);
+        channel->Deliver = &Deliver<T>;
+        for (size_t frame = 0; frame < 2; frame++)
+            channel->Buffers[frame] = m_Arenas[frame].Allocate(sizeof(T) * m_EventsPerType, alignof(T));
+    }
+
+    channel->Handlers.emplace_back([handler = std::move(handler)](const std::byte *events, const uint32_t count) {
+        handler(std::span<const T>(std::launder(reinterpret_cast<const T *>(events)), count));
+    });
+}
+
+template <typename T, typename... Args> bool EventBus::Post(Args &&...args)
+{
+    Channel *channel = m_Channels[static_cast<size_t>(T::GetStaticType())].get();
+    if (!channel || !channel->Buffers[0])
+        return false;
+
+    while (true)
+    {
+        // Announce the write before double checking the frame, Dispatch() waits for writers of the frame it flips
+        const uint32_t frame = m_WriteFrame.load();
+        m_Writers[frame].fetch_add(1);
+        if (m_WriteFrame.load() != frame)
+        {
+            m_Writers[frame].fetch_sub(1);
+            continue;
+        }
+
+        const uint32_t index = channel->Counts[frame].fetch_add(1);
+        const bool stored = index < m_EventsPerType;
+        if (stored)
+            new (channel->Buffers[frame] + index * sizeof(T)) T(std::forward<Args>(args)...);
+        else
+            m_DroppedCount++;
+
+        m_Writers[frame].fetch_sub(1);
+        return stored;
+    }
+}
+
+template <typename T> void EventBus::Deliver(Channel &channel, std::byte *events, uint32_t count)
+{
+    T *typed = std::launder(reinterpret_cast<T *>(events));
+
+    if constexpr (T::IsCoalesced)
+    {
+        for (uint32_t i = 1; i < count; i++)
+            typed[0].Merge(typed[i]);
+        count = 1;
+    }
+
+    for (const auto &handler : channel.Handlers)
+        handler(events, count);
+}
+
+} // namespace BloxxEngine
@@ -4,6 +4,7 @@
  */
 
 #pragma once
+#include <cstddef>
 
 namespace BloxxEngine
 {
@@ -14,11 +15,18 @@ enum class EventType
     MouseMoved, MouseScrolled,
     WindowResized,
     // Add more as needed
+
+    Count, // Keep last
 };
 
+constexpr size_t EventTypeCount = static_cast<size_t>(EventType::Count);
+
 class Event
 {
 public:
+    // High frequency events set this and implement Merge(), the EventBus then delivers one event per frame
+    static constexpr bool IsCoalesced = false;
+
     [[nodiscard]] virtual EventType GetEventType() const = 0;
     virtual ~Event() = default;
 };
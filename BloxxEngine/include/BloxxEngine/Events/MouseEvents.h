@@ -15,6 +15,14 @@ class MouseMovedEvent final : public Event
 
     MouseMovedEvent(const float x, const float y) : X(x), Y(y) {}
 
+    // X and Y are offsets since the previous event, so merging sums them
+    static constexpr bool IsCoalesced = true;
+    void Merge(const MouseMovedEvent &other)
+    {
+        X += other.X;
+        Y += other.Y;
+    }
+
     static EventType GetStaticType() { return EventType::MouseMoved; }
     [[nodiscard]] EventType GetEventType() const override { return GetStaticType(); }
 };
@@ -27,6 +35,13 @@ class MouseScrolledEvent final : public Event
     MouseScrolledEvent(const float offsetX, const float offsetY) : OffsetX(offsetX), OffsetY(offsetY)
     {
     }
+
+    static constexpr bool IsCoalesced = true;
+    void Merge(const MouseScrolledEvent &other)
+    {
+        OffsetX += other.OffsetX;
+        OffsetY += other.OffsetY;
+    }
     static EventType GetStaticType() { return EventType::MouseScrolled; }
     [[nodiscard]] EventType GetEventType() const override { return GetStaticType(); }
 };
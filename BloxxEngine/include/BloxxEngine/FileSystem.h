@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "CookedMesh.h"
+#include "Image.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace BloxxEngine
+{
+
+/**
+ * Virtual file system over memory-mapped asset archives.
+ *
+ * An archive is mounted under a path prefix, e.g. "Resources", after which "Resources/shaders/block.vert.glsl" is
+ * served from the mapped archive instead of the disk. Everything returned by the Find functions points straight
+ * into the mapping and stays valid until UnmountAll().
+ */
+class FileSystem
+{
+  public:
+    static bool Mount(const std::string &mountPoint, const std::string &archivePath);
+    static void UnmountAll();
+
+    /**
+     * Looks up a shader or raw text asset in the mounted archives.
+     * @return a view of the stored text, or std::nullopt if no archive contains the path
+     */
+    [[nodiscard]] static std::optional<std::string_view> FindText(const std::string &path);
+
+    /**
+     * Looks up a pre-decoded texture in the mounted archives.
+     * @return true and fills image if found
+     */
+    static bool FindImage(const std::string &path, Image &image);
+
+    /**
+     * Looks up a cooked mesh in the mounted archives.
+     * @return true and fills mesh if found
+     */
+    static bool FindMesh(const std::string &path, CookedMesh &mesh);
+
+    /**
+     * Reads a file from the mounted archives, falling back to the disk.
+     */
+    [[nodiscard]] static std::optional<std::string> ReadFile(const std::string &path);
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <cstddef>
+#include <memory>
+
+namespace BloxxEngine
+{
+
+/**
+ * Linear allocator over a fixed block of memory. Allocations are a pointer bump and are released all at once by
+ * Reset(), which keeps the block for reuse.
+ */
+class FrameArena
+{
+  public:
+    explicit FrameArena(size_t capacity) : m_Memory(std::make_unique<std::byte[]>(capacity)), m_Capacity(capacity)
+    {
+    }
+
+    /**
+     * @return the allocated memory, or nullptr when the arena is full
+     */
+    [[nodiscard]] std::byte *Allocate(const size_t size, const size_t alignment = alignof(std::max_align_t))
+    {
+        const size_t offset = (m_Offset + alignment - 1) & ~(alignment - 1);
+        if (offset + size > m_Capacity)
+            return nullptr;
+
+        m_Offset = offset + size;
+        return m_Memory.get() + offset;
+    }
+
+    void Reset()
+    {
+        m_Offset = 0;
+    }
+
+    [[nodiscard]] size_t GetUsed() const
+    {
+        return m_Offset;
+    }
+    [[nodiscard]] size_t GetCapacity() const
+    {
+        return m_Capacity;
+    }
+
+  private:
+    std::unique_ptr<std::byte[]> m_Memory;
+    size_t m_Capacity;
+    size_t m_Offset = 0;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <array>
+#include <glm/glm.hpp>
+
+namespace BloxxEngine
+{
+
+/**
+ * The six clip planes of a view projection matrix (Gribb & Hartmann), normals pointing inwards. A point is inside
+ * when dot(plane.xyz, point) + plane.w >= 0 for every plane.
+ */
+struct Frustum
+{
+    std::array<glm::vec4, 6> Planes;
+
+    [[nodiscard]] static Frustum FromMatrix(const glm::mat4 &viewProjection)
+    {
+        auto row = [&viewProjection](const int i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        };
+
+        Frustum frustum;
+        frustum.Planes = {row(3) + row(0), row(3) - row(0), row(3) + row(1),
+                          row(3) - row(1), row(3) + row(2), row(3) - row(2)};
+        for (glm::vec4 &plane : frustum.Planes)
+            plane = plane / glm::length(glm::vec3(plane));
+        return frustum;
+    }
+
+    // The sphere overlaps the frustum, or lies close outside one of its corners
+    [[nodiscard]] bool IntersectsSphere(const glm::vec3 &center, const float radius) const
+    {
+        for (const glm::vec4 &plane : Planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                return false;
+        }
+        return true;
+    }
+
+    // The box overlaps the frustum, or lies close outside one of its corners
+    [[nodiscard]] bool IntersectsBox(const glm::vec3 &min, const glm::vec3 &max) const
+    {
+        for (const glm::vec4 &plane : Planes)
+        {
+            // The corner furthest along the plane normal
+            const glm::vec3 corner(plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y,
+                                   plane.z >= 0.0f ? max.z : min.z);
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
+
+} // namespace BloxxEngine
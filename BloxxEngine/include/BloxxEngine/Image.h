@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <vector>
+
+namespace BloxxEngine
+{
+
+struct ImageMip
+{
+    int Width;
+    int Height;
+    const unsigned char *Pixels; // Tightly packed RGBA8 rows, bottom row first
+};
+
+/**
+ * A decoded RGBA8 image, optionally with a full mip chain. The pixels are not owned, they either point into a
+ * mapped asset archive or into a buffer owned by the caller.
+ */
+struct Image
+{
+    int Width = 0;
+    int Height = 0;
+    std::vector<ImageMip> Mips;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace BloxxEngine
+{
+
+enum class RecordedInputType : uint8_t
+{
+    KeyPressed, // Repeat is set for presses from the OS key repeat
+    KeyReleased,
+    ButtonPressed,
+    ButtonReleased,
+    MouseMoved,    // Offset since the previous one, y up
+    MouseScrolled, // Scroll offsets
+};
+
+/**
+ * One input as the window delivered it, the same ones the Renderer turns into InputState updates and EventBus
+ * events.
+ */
+struct RecordedInput
+{
+    double Time = 0.0; // Seconds since the recording started
+    RecordedInputType Type = RecordedInputType::KeyPressed;
+    bool Repeat = false;
+    int Code = 0; // Key or mouse button
+    glm::vec2 Offset{0.0f};
+};
+
+struct CameraState
+{
+    glm::vec3 Position{0.0f};
+    float Yaw = 0.0f;
+    float Pitch = 0.0f;
+    float Zoom = 45.0f;
+};
+
+/**
+ * A timestamped input stream with the camera state it started from and ended at, and the seed of the world it was
+ * recorded in. Stored as a small binary file.
+ *
+ * Mouse movements arriving back to back within one frame are merged into one, the frame sums them anyway.
+ */
+class InputRecording
+{
+  public:
+    void Start(uint32_t worldSeed, const CameraState &camera);
+    void Add(const RecordedInput &input);
+    // Marks a frame boundary, movements on either side of it are kept apart
+    void NextFrame() { m_MergeMouse = false; }
+    void Finish(double duration, const CameraState &camera);
+
+    bool Save(const std::filesystem::path &path) const;
+    // Prints the reason and returns false when the file is missing or damaged
+    bool Load(const std::filesystem::path &path);
+
+    [[nodiscard]] std::span<const RecordedInput> GetInputs() const { return m_Inputs; }
+    [[nodiscard]] uint32_t GetWorldSeed() const { return m_WorldSeed; }
+    [[nodiscard]] const CameraState &GetStartCamera() const { return m_StartCamera; }
+    [[nodiscard]] const CameraState &GetEndCamera() const { return m_EndCamera; }
+    [[nodiscard]] double GetDuration() const { return m_Duration; }
+
+  private:
+    std::vector<RecordedInput> m_Inputs;
+    uint32_t m_WorldSeed = 0;
+    CameraState m_StartCamera, m_EndCamera;
+    double m_Duration = 0.0;
+    bool m_MergeMouse = false;
+};
+
+/**
+ * Plays an InputRecording back with a fixed timestep: every frame advances the replay clock by the same amount and
+ * releases the inputs that came due, so the simulation sees the same input on the same ticks on every run no matter
+ * how long the frames take. Collects the real frame times for the summary.
+ */
+class InputReplay
+{
+  public:
+    struct Summary
+    {
+        size_t Frames = 0;
+        // Frame times in milliseconds
+        double Mean = 0.0;
+        double P95 = 0.0;
+        double P99 = 0.0;
+        double Max = 0.0;
+    };
+
+    InputReplay(InputRecording recording, float fixedDeltaTime);
+
+    // Moves the replay clock one step, returns the inputs that are due by then
+    std::span<const RecordedInput> Advance();
+    [[nodiscard]] bool IsFinished() const;
+
+    void AddFrameTime(float frameTime);
+    [[nodiscard]] Summary GetSummary() const;
+    // One line per frame: index, replay time and frame time in milliseconds
+    bool WriteFrameLog(const std::filesystem::path &path) const;
+
+    [[nodiscard]] const InputRecording &GetRecording() const { return m_Recording; }
+    [[nodiscard]] float GetFixedDeltaTime() const { return m_FixedDeltaTime; }
+
+  private:
+    InputRecording m_Recording;
+    float m_FixedDeltaTime;
+    uint64_t m_Step = 0;
+    size_t m_NextInput = 0;
+    // Real frame times in milliseconds, with the replay time each one ended at
+    std::vector<float> m_FrameTimes;
+    std::vector<double> m_FrameReplayTimes;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <GLFW/glfw3.h>
+#include <bitset>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace BloxxEngine
+{
+
+/**
+ * Input state as it was when the frame sampled it.
+ */
+struct InputSnapshot
+{
+    std::bitset<GLFW_KEY_LAST + 1> Keys;
+    std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> Buttons;
+    glm::vec2 MouseDelta{0.0f};  // Cursor movement since the previous sample, y up
+    glm::vec2 ScrollDelta{0.0f}; // Scroll offsets since the previous sample
+
+    bool HasInput = false;   // Anything arrived since the previous sample
+    double InputTime = 0.0;  // Arrival time of the oldest input in this sample
+    double SampleTime = 0.0; // Time the sample was taken
+
+    [[nodiscard]] bool IsKeyDown(const int key) const
+    {
+        return key >= 0 && key <= GLFW_KEY_LAST && Keys.test(key);
+    }
+    [[nodiscard]] bool IsButtonDown(const int button) const
+    {
+        return button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST && Buttons.test(button);
+    }
+};
+
+/**
+ * Timing of one sampled input from arrival to the frame it took effect in. Times are glfwGetTime() seconds,
+ * PresentTime is taken right after the buffer swap.
+ */
+struct InputLatencySample
+{
+    uint64_t Frame;
+    double InputTime;
+    double SampleTime;
+    double PresentTime;
+};
+
+/**
+ * Held keys and buttons plus mouse movement accumulated since the last sample. Filled from the GLFW callbacks and
+ * sampled once per frame, as late as possible before the camera is updated, so motion follows the held state
+ * instead of the OS key repeat rate.
+ *
+ * Not thread safe, the callbacks and Sample() both run on the main thread.
+ */
+class InputState
+{
+  public:
+    void OnKey(int key, bool down, double time);
+    void OnMouseButton(int button, bool down, double time);
+    void OnMouseMoved(float offsetX, float offsetY, double time);
+    void OnMouseScrolled(float offsetX, float offsetY, double time);
+
+    /**
+     * Returns the current state and starts accumulating deltas for the next frame. Held keys and buttons carry over.
+     */
+    InputSnapshot Sample(double time);
+
+  private:
+    void MarkArrival(double time);
+
+    InputSnapshot m_State;
+};
+
+} // namespace BloxxEngine
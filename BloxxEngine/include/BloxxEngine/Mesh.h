@@ -5,9 +5,15 @@
 
 #pragma once
 
+#include "CookedMesh.h"
+#include "ThreadPool.h"
+
 #include <glad/gl.h>
 #include <glm/glm.hpp>
 
+#include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
 namespace BloxxEngine
@@ -22,25 +28,46 @@ struct Vertex
     glm::vec3 Tangent = {.0f, .0f, .0f}; // Tangent attribute
     glm::vec3 Bitangent = {.0f, .0f, .0f};
     ; // Bitangent attribute
+    float AmbientOcclusion = 1.0f; // Baked voxel occlusion, 1 is unoccluded
 };
 #pragma pack(pop)
 
+/**
+ * Indexed triangle mesh in GL buffers. The vertex and index data is only kept on the GPU.
+ */
 class Mesh
 {
   public:
-    Mesh(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices);
+    // Computes the tangent frames, on the thread pool when one is given, and uploads the mesh
+    Mesh(std::vector<Vertex> vertices, std::vector<GLuint> indices, ThreadPool *threadPool = nullptr);
+    // Uploads a mesh cooked by the AssetPacker as is, its tangent frames are already computed
+    explicit Mesh(const CookedMesh &mesh);
     ~Mesh();
 
+    Mesh(Mesh &) = delete;
+    Mesh &operator=(Mesh &) = delete;
+
+    /**
+     * Loads a cooked mesh from the mounted asset archives.
+     * @return the mesh, or nullptr when no archive contains it
+     */
+    static std::unique_ptr<Mesh> Load(const std::string &path);
+
     void Draw() const;
-    void CalculateTangentsAndBitangents();
+
+    /**
+     * Fills in orthonormal tangents and bitangents from the positions, normals and texture coordinates. Triangles are
+     * processed in parallel batches when a thread pool is given.
+     */
+    static void CalculateTangentsAndBitangents(std::span<Vertex> vertices, std::span<const GLuint> indices,
+                                               ThreadPool *threadPool = nullptr);
 
   private:
-    GLuint m_VAO, m_VBO, m_EBO;
+    GLuint m_VAO = 0, m_VBO = 0, m_EBO = 0;
     size_t m_IndexCount;
+    GLenum m_IndexType = GL_UNSIGNED_INT;
 
-    void SetupMesh();
-    std::vector<Vertex> m_Vertices;
-    std::vector<GLuint> m_Indices;
+    void CreateBuffers(const void *vertices, size_t vertexBytes, const void *indices, size_t indexBytes);
 };
 
 } // namespace BloxxEngine
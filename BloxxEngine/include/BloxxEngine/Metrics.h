@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+// Monotonic count, e.g. bytes uploaded or sections meshed
+class Counter
+{
+  public:
+    void Add(const uint64_t amount = 1) { m_Value.fetch_add(amount, std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t Get() const { return m_Value.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<uint64_t> m_Value{0};
+};
+
+// Current level of something, e.g. loaded chunks or a queue depth
+class Gauge
+{
+  public:
+    void Set(const double value) { m_Value.store(value, std::memory_order_relaxed); }
+    void Add(const double amount) { m_Value.fetch_add(amount, std::memory_order_relaxed); }
+    [[nodiscard]] double Get() const { return m_Value.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<double> m_Value{0.0};
+};
+
+/**
+ * Distribution of recorded values over fixed buckets. Bucket i counts the values up to and including Bounds[i] that
+ * didn't fit a lower bucket, one more bucket past the last bound takes the rest.
+ */
+class Histogram
+{
+  public:
+    explicit Histogram(std::span<const double> bounds);
+
+    void Record(double value);
+
+    [[nodiscard]] std::span<const double> GetBounds() const { return m_Bounds; }
+    [[nodiscard]] size_t GetBucketCount() const { return m_Bounds.size() + 1; }
+    [[nodiscard]] uint64_t GetBucket(const size_t index) const
+    {
+        return m_Buckets[index].load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] uint64_t GetCount() const { return m_Count.load(std::memory_order_relaxed); }
+    [[nodiscard]] double GetSum() const { return m_Sum.load(std::memory_order_relaxed); }
+    /**
+     * Estimates a percentile, 0 to 100, from the buckets: the upper bound of the bucket it falls in. Values past the
+     * last bound report that bound.
+     */
+    [[nodiscard]] double GetPercentile(double percentile) const;
+
+  private:
+    std::vector<double> m_Bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_Buckets;
+    std::atomic<uint64_t> m_Count{0};
+    std::atomic<double> m_Sum{0.0};
+};
+
+enum class MetricKind
+{
+    Counter,
+    Gauge,
+    Histogram,
+};
+
+// One metric as Metrics::ForEach() shows it
+struct MetricView
+{
+    std::string_view Name;
+    MetricKind Kind;
+    double Value = 0.0;                 // Counter total, gauge value or histogram mean
+    const Histogram *Buckets = nullptr; // Histograms only
+    /**
+     * The last Metrics::Sample() results, oldest first from HistoryOffset on, wrapping around. Counters keep the
+     * increase since the previous sample, gauges their value and histograms the mean of the values recorded since
+     * the previous sample.
+     */
+    std::span<const float> History;
+    size_t HistoryOffset = 0;
+};
+
+/**
+ * Process wide registry of named metrics. Any subsystem gets its metrics by name, typically once into a reference
+ * it keeps, and updates them from any thread without locks. Asking for a name again returns the same metric.
+ * Metrics live until the process ends.
+ *
+ * Names are dotted, subsystem first: "world.chunks_loaded", "mesh.upload_bytes".
+ */
+class Metrics
+{
+  public:
+    static Counter &GetCounter(std::string_view name);
+    static Gauge &GetGauge(std::string_view name);
+    // The bounds are taken from the first request for the name, they have to be ascending
+    static Histogram &GetHistogram(std::string_view name, std::span<const double> bounds);
+
+    // Records the current values into the histories, once per frame or report interval
+    static void Sample();
+    // Calls visitor for every metric in registration order
+    static void ForEach(const std::function<void(const MetricView &)> &visitor);
+
+    /**
+     * Appends the current values as CSV rows: time, name, kind, value. Histograms add rows for their count, mean and
+     * 50th, 95th and 99th percentile. The header is written when the file is new.
+     */
+    static bool AppendCsv(const std::filesystem::path &path, double time);
+    // Appends the current values as one JSON object per line
+    static bool AppendJson(const std::filesystem::path &path, double time);
+};
+
+/**
+ * Writes the metrics to a file every interval, for long soak tests. CSV or, for files ending in .json or .jsonl, JSON
+ * lines. Driven by Update() like the autosave.
+ */
+class MetricsDumper
+{
+  public:
+    MetricsDumper(std::filesystem::path path, double interval);
+    // Dumps once more, so the last interval isn't lost
+    ~MetricsDumper();
+
+    void Update(float deltaTime);
+    bool Dump();
+
+    MetricsDumper(MetricsDumper &) = delete;
+    MetricsDumper &operator=(MetricsDumper &) = delete;
+
+  private:
+    std::filesystem::path m_Path;
+    bool m_Json;
+    double m_Interval;
+    double m_Elapsed = 0.0; // Since the last dump
+    double m_Time = 0.0;    // Since construction, the time column of the dumps
+};
+
+} // namespace BloxxEngine
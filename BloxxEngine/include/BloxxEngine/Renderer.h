@@ -7,15 +7,26 @@
 #include <glad/gl.h>
 
 #define GLFW_INCLUDE_NONE
+#include "AllocationStats.h"
+#include "AssetManager.h"
 #include "Camera.h"
+#include "EventBus.h"
 #include "Events/KeyboardEvents.h"
 #include "Events/MouseEvents.h"
+#include "InputRecording.h"
+#include "InputState.h"
 #include "Mesh.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "ThreadPool.h"
 
 #include <GLFW/glfw3.h>
+#include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include <glm/glm.hpp>
 
@@ -24,9 +35,28 @@
 namespace BloxxEngine
 {
 
+class DirWatcher;
+class World;
+class WorldRenderer;
+class WorldSaver;
+
 class Renderer
 {
   public:
+    enum class PresentMode
+    {
+        VSync,    // Wait for vertical blank
+        Uncapped, // Present as fast as possible
+        Limited,  // No vsync, sleep to hold the frame limit
+    };
+
+    struct SimulationSettings
+    {
+        float TickRate = 60.0f;   // Fixed simulation ticks per second
+        int MaxCatchUpTicks = 5;  // Most ticks run to catch up after a long frame, older backlog is dropped
+        bool RunOnThread = false; // Run the ticks on a dedicated simulation thread
+    };
+
     Renderer();
     virtual ~Renderer();
 
@@ -34,15 +64,54 @@ class Renderer
     void Run();
     void Shutdown();
 
+    /**
+     * Watches the given resource source directory and rebuilds shaders and textures in place when they change.
+     */
+    void EnableHotReload(const std::string &sourceDir);
+
+    void SetPresentMode(PresentMode mode, int frameLimit = 144);
+    // Has to be set before Run()
+    void SetSimulationSettings(const SimulationSettings &settings);
+
+    /**
+     * Called after the buffer swap of every frame that consumed new input, to measure input to present latency.
+     */
+    void SetInputLatencyCallback(std::function<void(const InputLatencySample &)> callback);
+
+    /**
+     * Records the window input from now on, with the camera and the world seed, until StopRecording() or Shutdown()
+     * writes it to path.
+     */
+    void StartRecording(const std::string &path);
+    void StopRecording();
+
+    /**
+     * Plays a recording back instead of the window input, for reproducible performance runs. Has to be called before
+     * Initialize(), the world is generated from the recorded seed and the camera starts where the recording did.
+     * Every frame advances the simulation by fixedDeltaTime, on the main thread. Run() returns when the replay is
+     * done, after printing the mean, 95th and 99th percentile frame times and writing every frame's time to
+     * frameLogPath when one is given. Chunks saved since the recording was made still replace their terrain.
+     */
+    bool LoadReplay(const std::string &path, const std::string &frameLogPath = {},
+                    float fixedDeltaTime = 1.0f / 60.0f);
+
     virtual void OnKeyPressed(const KeyPressedEvent &event);
-    virtual void OnMouseMoved(const MouseMovedEvent &event);
     virtual void OnMouseScrolled(const MouseScrolledEvent & event);
 
   protected:
+    /**
+     * Advances the simulation by one fixed tick. Runs on the simulation thread when RunOnThread is set, with the
+     * main thread blocked from processing input and reading the simulation state.
+     */
+    virtual void OnFixedUpdate(float fixedDeltaTime);
     virtual void OnUpdate(float deltaTime);
     virtual void OnRender();
     virtual void OnImGuiRender(); // For future ImGUI integration
-    void OnEvent(Event & event);
+
+    // Subscriptions have to be made before Run()
+    EventBus &GetEventBus() { return m_EventBus; }
+    // Input sampled for the current frame, held keys are the ones to use for continuous movement
+    [[nodiscard]] const InputSnapshot &GetInput() const { return m_Input; }
 
   private:
     bool InitializeGLFW();
@@ -53,15 +122,55 @@ class Renderer
     // GLFW callbacks
     static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
     static void MouseMoveCallback(GLFWwindow* window, double xPos, double yPos);
+    static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
     static void MouseScrollCallback(GLFWwindow* window, double xOffset, double yOffset);
 
     void MainLoop();
 
-    void ProcessInput() const;
+    void GenerateWorld();
+    // Window input goes through here, it is recorded or, while replaying, ignored
+    void OnWindowInput(const RecordedInput &input);
+    // Feeds one input to the input state and the event bus
+    void SubmitInput(const RecordedInput &input, double time);
+    void ProcessInput();
+    void RecordInputLatency(double presentTime);
+
+    // Fixed timestep simulation
+    void RunFixedUpdates(float frameTime);
+    void Tick();
+    void SimulationThreadLoop();
+    void UpdateRenderState(float alpha);
+
+    [[nodiscard]] CameraState GetCameraState() const;
+    void ApplyCameraState(const CameraState &camera);
+    void FinishReplay();
+
+    void ApplyPresentMode() const;
+    void WaitForFrameLimit(double frameStart) const;
+    void RecordFrameTime(float frameTime);
 
     // GLFW window
     GLFWwindow *m_Window;
 
+    // Input events queued by the GLFW callbacks, delivered once per frame
+    EventBus m_EventBus;
+
+    // Held input and mouse movement, sampled once per frame right before the camera update
+    InputState m_InputState;
+    InputSnapshot m_Input;
+    uint64_t m_FrameIndex = 0;
+    std::function<void(const InputLatencySample &)> m_InputLatencyCallback;
+    float m_InputLatency = 0.0f;        // Last measured, in milliseconds
+    float m_AverageInputLatency = 0.0f; // Exponential moving average, in milliseconds
+
+    // Input recording and replay
+    std::unique_ptr<InputRecording> m_Recording;
+    std::string m_RecordingPath;
+    double m_RecordingStart = 0.0;
+    std::unique_ptr<InputReplay> m_Replay;
+    std::string m_FrameLogPath;
+    uint32_t m_WorldSeed = 0; // Terrain seed of the generated world
+
     // Mouse state
     static float s_LastX, s_LastY;
     static bool s_FirstMouse;
@@ -69,19 +178,75 @@ class Renderer
     //  Camera
     std::unique_ptr<Camera> m_Camera;
 
+    // Workers and asynchronous asset loading
+    std::unique_ptr<ThreadPool> m_ThreadPool;
+    std::unique_ptr<AssetManager> m_AssetManager;
+    std::unique_ptr<DirWatcher> m_DirWatcher;
+
     // Shader, Texture, and Mesh
-    std::unique_ptr<Shader> m_Shader;
-    std::unique_ptr<Texture> m_BaseColorTexture;
-    std::unique_ptr<Texture> m_NormalTexture;
-    std::unique_ptr<Texture> m_RMAHTexture;
+    AssetHandle<Shader> m_Shader;
+    AssetHandle<Texture> m_BaseColorTexture;
+    AssetHandle<Texture> m_NormalTexture;
+    AssetHandle<Texture> m_RMAHTexture;
     std::unique_ptr<Mesh> m_Mesh;
 
     // Timing
     float m_LastFrameTime;
     float m_DeltaTime{};
 
+    // Simulation state, interpolated between the last two ticks for rendering
+    struct SimulationState
+    {
+        glm::vec3 CameraPosition{0};
+        float ModelAngle = 0.0f;
+    };
+    SimulationSettings m_SimulationSettings;
+    SimulationState m_PreviousState;
+    SimulationState m_CurrentState;
+    float m_Accumulator = 0.0f;
+    double m_LastTickTime = 0.0;
+    int m_TicksLastFrame = 0;
+    std::atomic<int> m_ThreadTicks{0}; // Run by the simulation thread since the last frame took them
+    std::atomic<uint64_t> m_DroppedTicks{0};
+
+    std::mutex m_SimulationMutex;
+    std::thread m_SimulationThread;
+    std::atomic<bool> m_SimulationRunning{false};
+
+    // Statistics of the world for the overlay, copied while holding the simulation mutex since the simulation thread
+    // keeps updating them
+    struct SimulationStats
+    {
+        size_t ActiveFluidCells = 0;
+        double FluidStepTime = 0.0; // Milliseconds
+        size_t ScheduledTicks = 0;
+        size_t LastTickCount = 0;
+        double LastTickTime = 0.0; // Milliseconds
+        size_t SavedChunks = 0;
+        uint64_t SavedBytes = 0;
+        double SnapshotTime = 0.0; // Milliseconds
+        double SaveTime = 0.0;     // Milliseconds
+        bool Saving = false;
+    };
+    SimulationStats m_SimulationStats;
+
+    // Presentation
+    PresentMode m_PresentMode = PresentMode::VSync;
+    int m_FrameLimit = 144;
+
+    // Frame times for the statistics overlay, in milliseconds
+    static constexpr int FrameHistorySize = 240;
+    std::array<float, FrameHistorySize> m_FrameTimes{};
+    int m_FrameTimeIndex = 0;
+
     // MVP matrices
+    std::unique_ptr<World> m_World;
+    std::unique_ptr<WorldSaver> m_WorldSaver;
+    std::unique_ptr<WorldRenderer> m_WorldRenderer;
+    glm::vec3 m_CubePosition{0};
+
     glm::mat4 m_ModelMatrix{0};
+    glm::mat4 m_ViewMatrix{0};
     glm::mat4 m_ProjectionMatrix{0};
 
     glm::vec3 m_CameraPosition{0};
@@ -94,6 +259,10 @@ class Renderer
 
     // Statistics
     int m_DrawCalls{};
+    int m_TranslucentSorts{};
+    // Heap allocations of the last frame, and the counters at its end
+    AllocationCounters m_FrameAllocations;
+    AllocationCounters m_AllocationsAtFrameEnd;
 };
 
 } // namespace BloxxEngine
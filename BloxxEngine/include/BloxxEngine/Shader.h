@@ -7,6 +7,7 @@
 
 #include <glad/gl.h>
 #include <glm/glm.hpp>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -19,6 +20,18 @@ class Shader
     Shader(const std::string &vertexShaderPath, const std::string &fragmentShaderPath);
     ~Shader();
 
+    /**
+     * Creates a program from in-memory sources, e.g. sources read on a worker thread.
+     */
+    static std::unique_ptr<Shader> FromSource(const std::string &vertexSource, const std::string &fragmentSource,
+                                              const std::string &debugName);
+
+    /**
+     * Rebuilds the program in place from new sources. On a compile or link error the current program is kept.
+     * @return true if the new program is in use
+     */
+    bool Reload(const std::string &vertexSource, const std::string &fragmentSource);
+
     void Bind() const;
     void Unbind();
 
@@ -29,9 +42,12 @@ class Shader
     void SetUniformVec3(const std::string &name, const glm::vec3 &value);
 
   private:
-    GLuint m_RendererID;
+    Shader() = default;
+
+    GLuint m_RendererID = 0;
 
     // Helper functions
+    void Build(const std::string &vertexSource, const std::string &fragmentSource, const std::string &debugName);
     std::string LoadShaderSource(const std::string &path);
     GLuint CompileShader(GLenum type, const std::string &source);
     GLuint CreateProgram(GLuint vertexShader, GLuint fragmentShader);
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <cmath>
+#include <glm/glm.hpp>
+
+/**
+ * Tangent frame math shared by the runtime mesh setup and the AssetPacker mesh cooker, so this header must stay free
+ * of GL and engine dependencies.
+ */
+namespace BloxxEngine
+{
+
+/**
+ * Tangent and bitangent of a triangle, unnormalised so larger triangles weigh more when accumulated per vertex.
+ * Triangles without a usable uv mapping (zero determinant) give zero vectors instead of dividing by zero.
+ */
+inline void TriangleTangents(const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2, const glm::vec2 &uv0,
+                             const glm::vec2 &uv1, const glm::vec2 &uv2, glm::vec3 &tangent, glm::vec3 &bitangent)
+{
+    const glm::vec3 deltaPos1 = p1 - p0;
+    const glm::vec3 deltaPos2 = p2 - p0;
+    const glm::vec2 deltaUV1 = uv1 - uv0;
+    const glm::vec2 deltaUV2 = uv2 - uv0;
+
+    // A select instead of a branch, keeps loops over many triangles vectorisable
+    const float determinant = deltaUV1.x * deltaUV2.y - deltaUV1.y * deltaUV2.x;
+    const float r = std::abs(determinant) > 1e-12f ? 1.0f / determinant : 0.0f;
+    tangent = (deltaPos1 * deltaUV2.y - deltaPos2 * deltaUV1.y) * r;
+    bitangent = (deltaPos2 * deltaUV1.x - deltaPos1 * deltaUV2.x) * r;
+}
+
+/**
+ * Turns the tangent and bitangent accumulated for a vertex into an orthonormal frame around its normal, keeping the
+ * handedness of the uv mapping. Vertices without a usable tangent, unreferenced or only on degenerate triangles, get
+ * an arbitrary frame perpendicular to the normal rather than NaNs.
+ */
+inline void OrthonormalizeTangentFrame(const glm::vec3 &normal, glm::vec3 &tangent, glm::vec3 &bitangent)
+{
+    constexpr float epsilon = 1e-12f;
+
+    const float normalLength = glm::dot(normal, normal);
+    const glm::vec3 n = normalLength > epsilon ? normal / std::sqrt(normalLength) : glm::vec3(0.0f, 0.0f, 1.0f);
+
+    // Gram-Schmidt against the normal
+    glm::vec3 t = tangent - n * glm::dot(n, tangent);
+    const float tangentLength = glm::dot(t, t);
+    if (tangentLength > epsilon)
+    {
+        t = t / std::sqrt(tangentLength);
+    }
+    else
+    {
+        // Duff et al., "Building an Orthonormal Basis, Revisited"
+        const float sign = std::copysign(1.0f, n.z);
+        const float a = -1.0f / (sign + n.z);
+        t = glm::vec3(1.0f + sign * n.x * n.x * a, sign * n.x * n.y * a, -sign * n.x);
+    }
+
+    const glm::vec3 b = glm::cross(n, t);
+    tangent = t;
+    bitangent = glm::dot(b, bitangent) < 0.0f ? -b : b;
+}
+
+} // namespace BloxxEngine
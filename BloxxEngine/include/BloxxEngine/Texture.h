@@ -4,6 +4,7 @@
  */
 
 #pragma once
+#include "Image.h"
 #include "glad/gl.h"
 
 #include <string>
@@ -28,6 +29,7 @@ class Texture
     };
 
     explicit Texture(const std::string &filePath, FilterMode filterMode = FilterMode::Linear, WrapMode wrapMode = WrapMode::Clamp);
+    explicit Texture(const Image &image, FilterMode filterMode = FilterMode::Linear, WrapMode wrapMode = WrapMode::Clamp);
     ~Texture();
 
     void Bind(unsigned int slot = 0) const;
@@ -41,12 +43,19 @@ class Texture
     {
         return m_Height;
     }
+    [[nodiscard]] inline int GetMipCount() const
+    {
+        return m_MipCount;
+    }
 
   private:
+    void Upload(const Image &image, FilterMode filterMode, WrapMode wrapMode);
+
     GLuint m_RendererID;
     std::string m_FilePath;
     unsigned char *m_LocalBuffer;
     int m_Width, m_Height, m_BPP;
+    int m_MipCount = 0;
 };
 
 } // namespace BloxxEngine
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+/**
+ * Fixed set of worker threads consuming a shared job queue.
+ */
+class ThreadPool
+{
+  public:
+    /**
+     * @param workerCount number of workers, 0 picks one less than the number of hardware threads
+     */
+    explicit ThreadPool(unsigned workerCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    ThreadPool &operator=(ThreadPool &) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    void Submit(std::function<void()> job);
+
+    /**
+     * Calls func(begin, end) over [0, count) in ranges of at most grainSize and returns once all ranges ran.
+     * The calling thread takes part in the work and only waits for helpers that a worker already picked up, helpers
+     * still queued when it runs out of ranges are dropped. That makes it safe to call from inside a job, even when
+     * every worker is doing the same.
+     */
+    template <typename F> void ParallelFor(size_t count, size_t grainSize, F &&func);
+
+    [[nodiscard]] unsigned GetWorkerCount() const
+    {
+        return static_cast<unsigned>(m_Workers.size());
+    }
+    [[nodiscard]] size_t GetQueueDepth() const;
+
+  private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_Workers;
+    std::deque<std::function<void()>> m_Jobs;
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_Stopping = false;
+};
+
+template <typename F> void ThreadPool::ParallelFor(const size_t count, size_t grainSize, F &&func)
+{
+    if (count == 0)
+        return;
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    const size_t rangeCount = (count + grainSize - 1) / grainSize;
+    if (rangeCount == 1 || m_Workers.empty())
+    {
+        func(size_t{0}, count);
+        return;
+    }
+
+    // Ranges are claimed through an atomic cursor, helpers that start late simply find nothing left to do
+    auto run = [&func, count, grainSize, rangeCount](std::atomic<size_t> &next) {
+        for (size_t range = next.fetch_add(1); range < rangeCount; range = next.fetch_add(1))
+        {
+            const size_t begin = range * grainSize;
+            func(begin, std::min(begin + grainSize, count));
+        }
+    };
+
+    /**
+     * Shared with the queued helpers, which may only start after this call returned. A helper joins by taking one of
+     * the Unclaimed slots under the mutex; once the caller is done it closes the remaining slots and waits for the
+     * Active helpers alone, so it never waits on a job that's still queued behind its own.
+     */
+    struct State
+    {
+        std::atomic<size_t> Next{0};
+        std::mutex Mutex;
+        std::condition_variable Done;
+        size_t Unclaimed = 0;
+        size_t Active = 0;
+        void (*Run)(void *, std::atomic<size_t> &) = nullptr;
+        void *Context = nullptr;
+    };
+    const auto state = std::make_shared<State>();
+    state->Run = [](void *context, std::atomic<size_t> &next) { (*static_cast<decltype(run) *>(context))(next); };
+    state->Context = &run;
+
+    const size_t helpers = std::min<size_t>(m_Workers.size(), rangeCount - 1);
+    state->Unclaimed = helpers;
+    for (size_t i = 0; i < helpers; i++)
+    {
+        Submit([state] {
+            {
+                std::lock_guard lock(state->Mutex);
+                if (state->Unclaimed == 0)
+                    return;
+                state->Unclaimed--;
+                state->Active++;
+            }
+            state->Run(state->Context, state->Next);
+
+            std::lock_guard lock(state->Mutex);
+            if (--state->Active == 0)
+                state->Done.notify_one();
+        });
+    }
+
+    run(state->Next);
+
+    std::unique_lock lock(state->Mutex);
+    state->Unclaimed = 0;
+    state->Done.wait(lock, [&state] { return state->Active == 0; });
+}
+
+} // namespace BloxxEngine
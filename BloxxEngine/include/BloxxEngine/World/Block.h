@@ -23,6 +23,10 @@ enum class BlockType : uint8_t
     Entity,
 };
 
+// Index of a block type in the BlockTypeRegistry, this is what chunks store per voxel
+using BlockId = uint16_t;
+constexpr BlockId BLOCK_AIR = 0;
+
 
 
 namespace BlockFace
@@ -118,6 +122,9 @@ struct Block {
     // Metadata can include additional properties, like block states
     uint8_t Metadata;
 
+    // Block light level (0-15) the block emits
+    uint8_t LightEmission = 0;
+
     std::string Name;
     std::unique_ptr<BlockTextures> Textures;
 
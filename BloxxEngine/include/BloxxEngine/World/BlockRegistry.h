@@ -9,17 +9,54 @@
 #include "Block.h"
 
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace BloxxEngine {
 
+/**
+ * Block properties flattened into one byte per type, so hot loops (raycasts, meshing, physics) can test a BlockId
+ * without touching the Block definitions.
+ */
+enum BlockFlags : uint8_t
+{
+    BlockFlag_None = 0,
+    BlockFlag_Solid = 1 << 0,
+    BlockFlag_Transparent = 1 << 1,
+    BlockFlag_Fluid = 1 << 2,
+};
+
+/**
+ * Owns the Block definitions and hands out their BlockIds. Air is always registered as BLOCK_AIR.
+ *
+ * Types have to be registered up front, lookups are not synchronised with Register().
+ */
 class BlockTypeRegistry {
     public:
-      BlockTypeRegistry() = default;
+      BlockTypeRegistry();
 
-private:
-    std::map<std::string, Block*> blocks;
+    /**
+     * Registers a block type, or returns the existing id when the ID is already known.
+     */
+    BlockId Register(const std::string &id, BlockType type, const std::string &name = {});
+    void SetLightEmission(BlockId id, uint8_t level);
+
+    // Returns BLOCK_AIR for unknown IDs
+    [[nodiscard]] BlockId Find(const std::string &id) const;
+    [[nodiscard]] const Block &Get(const BlockId id) const { return *m_Blocks[id]; }
+    [[nodiscard]] size_t GetCount() const { return m_Blocks.size(); }
 
+    [[nodiscard]] uint8_t GetFlags(const BlockId id) const { return m_Flags[id]; }
+    [[nodiscard]] bool IsSolid(const BlockId id) const { return m_Flags[id] & BlockFlag_Solid; }
+    [[nodiscard]] bool IsTransparent(const BlockId id) const { return m_Flags[id] & BlockFlag_Transparent; }
+    [[nodiscard]] uint8_t GetLightEmission(const BlockId id) const { return m_LightEmission[id]; }
+
+private:
+    std::vector<std::unique_ptr<Block>> m_Blocks;
+    std::vector<uint8_t> m_Flags;
+    std::vector<uint8_t> m_LightEmission;
+    std::map<std::string, BlockId> m_Ids;
 };
 
 } // BloxxEngine
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Block.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+class Chunk;
+class World;
+
+/**
+ * What a tick handler sees of the world. Reads can reach into the neighbouring sections, writes to the ticked
+ * section happen in place and writes outside it are applied once the sections of the current colour are done.
+ */
+class BlockTickContext
+{
+  public:
+    [[nodiscard]] BlockId GetBlock(int x, int y, int z) const;
+    [[nodiscard]] uint8_t GetMetadata(int x, int y, int z) const;
+    void SetBlock(int x, int y, int z, BlockId id, uint8_t metadata = 0);
+    // Runs the scheduled tick handler of the block at this position in delay ticks, at least one
+    void ScheduleTick(int x, int y, int z, uint32_t delay);
+
+    [[nodiscard]] uint64_t GetTick() const { return m_Tick; }
+    // Deterministic per section and tick, whatever thread runs the section
+    uint32_t Random();
+
+  private:
+    friend class BlockTicker;
+
+    struct BlockChange
+    {
+        int X, Y, Z;
+        BlockId Previous;
+        BlockId Id;
+    };
+
+    struct BlockWrite
+    {
+        int X, Y, Z;
+        BlockId Id;
+        uint8_t Metadata;
+    };
+
+    struct TickRequest
+    {
+        int X, Y, Z;
+        uint32_t Delay;
+    };
+
+    // Everything a section produces that has to wait for the main thread
+    struct Output
+    {
+        std::vector<BlockChange> Changes; // Written in place, their relighting and remeshing are still to be queued
+        std::vector<BlockWrite> Deferred; // Outside the section, applied through World::SetBlock
+        std::vector<TickRequest> Requests;
+    };
+
+    BlockTickContext(const World &world, Chunk &chunk, int sectionY, uint64_t tick, uint64_t seed, Output &output);
+
+    [[nodiscard]] bool IsInSection(int x, int y, int z) const;
+
+    const World &m_World;
+    Chunk &m_Chunk;
+    glm::ivec3 m_Origin;
+    uint64_t m_Tick;
+    uint64_t m_RandomState;
+    Output &m_Output;
+};
+
+/**
+ * Block updates: ticks scheduled for a block some ticks ahead (falling blocks, delayed reactions), and random ticks
+ * that pick a few blocks of every non-empty section each tick (growth, decay).
+ *
+ * Scheduled ticks are kept per section in a queue ordered by due tick, a tick is dropped when the block it was
+ * scheduled for has been replaced since. Sections run in eight phases by the parity of their coordinates, a
+ * checkerboard in three dimensions: no two sections running at the same time are neighbours, so every section owns
+ * its blocks and can read its neighbours without any locking. Each phase runs its sections on the pool.
+ */
+class BlockTicker
+{
+  public:
+    using TickHandler = std::function<void(BlockTickContext &context, const glm::ivec3 &position)>;
+
+    struct Settings
+    {
+        float TickInterval = 0.05f;    // Seconds between two ticks
+        int RandomTicksPerSection = 3; // Blocks picked per non-empty section and tick
+    };
+
+    explicit BlockTicker(World &world);
+
+    void SetSettings(const Settings &settings) { m_Settings = settings; }
+
+    // Handlers have to be set up front, they are called from the workers
+    void SetScheduledTickHandler(BlockId id, TickHandler handler);
+    void SetRandomTickHandler(BlockId id, TickHandler handler);
+
+    void Update(float deltaTime);
+    void Tick();
+
+    // Blocks without a scheduled tick handler are ignored. The same block is only queued once per section.
+    void ScheduleTick(int x, int y, int z, uint32_t delay);
+    /**
+     * Schedules the block and its neighbours that have a scheduled tick handler for the next tick, World::SetBlock
+     * calls this for every change.
+     */
+    void OnBlockChanged(int x, int y, int z);
+
+    [[nodiscard]] uint64_t GetCurrentTick() const { return m_Tick; }
+    [[nodiscard]] size_t GetScheduledCount() const { return m_ScheduledCount; }
+    [[nodiscard]] size_t GetLastTickCount() const { return m_LastTickCount; } // Handlers run by the last tick
+    [[nodiscard]] double GetLastTickTime() const { return m_LastTickTime; }   // Milliseconds
+
+  private:
+    struct ScheduledTick
+    {
+        uint64_t Due;
+        uint16_t Index; // Within the section
+        BlockId Id;
+    };
+
+    // Pending ticks of a section, a min-heap on the due tick, and the index and block id of every tick in it
+    struct SectionQueue
+    {
+        std::vector<ScheduledTick> Ticks;
+        std::unordered_set<uint32_t> Queued;
+
+        [[nodiscard]] static uint32_t QueuedKey(const uint16_t index, const BlockId id)
+        {
+            return static_cast<uint32_t>(index) << 16 | id;
+        }
+    };
+
+    struct SectionWork
+    {
+        uint64_t Key;
+        Chunk *Column;
+        int SectionY;
+        SectionQueue *Scheduled; // nullptr when nothing is due
+    };
+
+    void GatherSections();
+    size_t RunSection(const SectionWork &work, BlockTickContext::Output &output);
+
+    [[nodiscard]] static const TickHandler *GetHandler(const std::vector<TickHandler> &handlers, BlockId id);
+
+    World &m_World;
+    Settings m_Settings;
+    float m_Accumulator = 0.0f;
+    uint64_t m_Tick = 0;
+
+    std::vector<TickHandler> m_ScheduledHandlers;
+    std::vector<TickHandler> m_RandomHandlers;
+    bool m_HasRandomHandlers = false;
+
+    // Pending ticks per section
+    std::unordered_map<uint64_t, SectionQueue> m_Scheduled;
+    size_t m_ScheduledCount = 0;
+    size_t m_LastTickCount = 0;
+    double m_LastTickTime = 0.0;
+
+    // Sections to run by colour, and what they produced. Kept between ticks so their capacity is reused.
+    std::array<std::vector<SectionWork>, 8> m_Phases;
+    std::vector<BlockTickContext::Output> m_Outputs;
+};
+
+} // namespace BloxxEngine
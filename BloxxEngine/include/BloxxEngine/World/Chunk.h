@@ -5,29 +5,64 @@
 
 #pragma once
 #include "Block.h"
-#include "BloxxEngine/Mesh.h"
+#include "ChunkSection.h"
 
 #include <array>
-#include <vector>
+#include <cstdint>
+#include <limits>
+#include <memory>
 
 namespace BloxxEngine {
 
+class World;
+
+// A chunk is a column of CHUNK_WIDTH x CHUNK_DEPTH blocks that spans the full world height (y)
 constexpr int CHUNK_WIDTH = 16;
-constexpr int CHUNK_HEIGHT = 16;
-constexpr int CHUNK_DEPTH = 256;
+constexpr int CHUNK_DEPTH = 16;
+constexpr int CHUNK_HEIGHT = 256;
 constexpr int CHUNK_SIZE = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
+constexpr int CHUNK_SECTION_COUNT = CHUNK_HEIGHT / SECTION_SIZE;
+
+static_assert(CHUNK_WIDTH == SECTION_SIZE && CHUNK_DEPTH == SECTION_SIZE, "Chunks are one section wide");
+static_assert(CHUNK_SECTION_COUNT <= 16, "Section masks are 16 bits");
 
+/**
+ * The blocks of a chunk, without any rendering state so the world runs headless. The WorldRenderer keeps the meshes.
+ */
 class Chunk {
 public:
     Chunk(int x, int z);
-    ~Chunk() = default;
 
-    void GenerateMesh();
-    void Draw() const;
+    /**
+     * Moves a recycled chunk to another position. The blocks are cleared, but the sections are kept and reused.
+     */
+    void Reset(int x, int z);
+
+    // Set for new chunks and by World::SetBlock, cleared once the WorldRenderer meshed the chunk
+    void MarkForRemesh() { m_NeedsRemesh = true; }
+    void MarkMeshed() { m_NeedsRemesh = false; }
+    [[nodiscard]] bool NeedsRemesh() const { return m_NeedsRemesh; }
 
-    // Accessor for blocks
-    [[nodiscard]] Block *GetBlock(int x, int y, int z) const;
-    void SetBlock(int x, int y, int z, const std::string& id, BlockType type, uint8_t metadata = 0);
+    // Sections edited through the World since the WorldSaver's last snapshot, a bit per section. Generated terrain
+    // isn't marked.
+    void MarkForSave(const int sectionIndex) { m_UnsavedSections |= static_cast<uint16_t>(1 << sectionIndex); }
+    void MarkForSave() { m_UnsavedSections = std::numeric_limits<uint16_t>::max(); }
+    void MarkSaved() { m_UnsavedSections = 0; }
+    [[nodiscard]] uint16_t GetUnsavedSections() const { return m_UnsavedSections; }
+
+    // Accessors for blocks in chunk local coordinates, sections are allocated on the first non-air write
+    [[nodiscard]] BlockId GetBlock(int x, int y, int z) const;
+    [[nodiscard]] uint8_t GetMetadata(int x, int y, int z) const;
+    void SetBlock(int x, int y, int z, BlockId id, uint8_t metadata = 0);
+
+    // Light levels in chunk local coordinates, sections that were never written are fully sky lit
+    [[nodiscard]] uint8_t GetSkyLight(int x, int y, int z) const;
+    [[nodiscard]] uint8_t GetBlockLight(int x, int y, int z) const;
+
+    // Returns nullptr for sections that were never written, those are all air
+    [[nodiscard]] const ChunkSection *GetSection(const int index) const { return m_Sections[index].get(); }
+    [[nodiscard]] ChunkSection *GetSection(const int index) { return m_Sections[index].get(); }
+    ChunkSection &GetOrCreateSection(int index);
 
     [[nodiscard]] int GetChunkX() const { return m_ChunkX; }
     [[nodiscard]] int GetChunkZ() const { return m_ChunkZ; }
@@ -35,17 +70,9 @@ public:
     private:
     int m_ChunkX,m_ChunkZ;
 
-    std::array<Block*, CHUNK_SIZE> m_Blocks;
-
-    // Mesh data
-    std::vector<Vertex> m_Vertices;
-    std::vector<uint16_t> m_Indices;
-    GLuint m_VAO, m_VBO, m_EBO;
+    std::array<std::unique_ptr<ChunkSection>, CHUNK_SECTION_COUNT> m_Sections;
 
-    void SetupMesh();
-    void AddFace(const glm::vec3& blockPosition,
-        const std::array<glm::vec3, 4>& faceVertices,
-        const glm::vec3& faceNormal,
-        const std::array<glm::vec2, 4>& uvCoords);
+    bool m_NeedsRemesh = true;
+    uint16_t m_UnsavedSections = 0;
 };
-} // namespace BloxxEngine
\ No newline at end of file
+} // namespace BloxxEngine
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Block.h"
+
+#include <array>
+#include <cstdint>
+
+namespace BloxxEngine {
+
+constexpr int SECTION_SIZE = 16;
+constexpr int SECTION_SHIFT = 4;
+constexpr int SECTION_MASK = SECTION_SIZE - 1;
+constexpr int SECTION_VOLUME = SECTION_SIZE * SECTION_SIZE * SECTION_SIZE;
+
+constexpr uint8_t MAX_LIGHT_LEVEL = 15;
+
+// Sections are split into 4x4x4 bricks of 4x4x4 blocks for the occupancy masks
+constexpr int BRICK_SIZE = 4;
+constexpr int BRICK_SHIFT = 2;
+constexpr int BRICK_MASK = BRICK_SIZE - 1;
+
+/**
+ * A 16x16x16 cube of a chunk column. Blocks are stored y-major (x + z * 16 + y * 256) so horizontal layers are
+ * contiguous.
+ *
+ * Sky and block light are 4 bit levels packed two per byte. New sections start out fully sky lit, the same as the
+ * sections that were never allocated.
+ *
+ * Occupancy is a two level 64-tree: BrickMask has a bit per brick holding any non-air block, VoxelMasks a bit per
+ * block of each brick. A brick mask of zero is uniformly air and is skipped by the spatial queries, all ones is
+ * uniformly filled. Chunk::SetBlock keeps both up to date.
+ */
+struct ChunkSection
+{
+    std::array<BlockId, SECTION_VOLUME> Blocks{};
+    std::array<uint8_t, SECTION_VOLUME> Metadata{};
+    std::array<uint8_t, SECTION_VOLUME / 2> SkyLight;
+    std::array<uint8_t, SECTION_VOLUME / 2> BlockLight{};
+    uint16_t NonAirCount = 0;
+    uint64_t BrickMask = 0;
+    std::array<uint64_t, 64> VoxelMasks{};
+
+    ChunkSection() { SkyLight.fill(MAX_LIGHT_LEVEL * 0x11); }
+
+    // Back to the state of a new section, keeping the storage
+    void Clear()
+    {
+        Blocks.fill(BLOCK_AIR);
+        Metadata.fill(0);
+        SkyLight.fill(MAX_LIGHT_LEVEL * 0x11);
+        BlockLight.fill(0);
+        NonAirCount = 0;
+        BrickMask = 0;
+        VoxelMasks.fill(0);
+    }
+
+    [[nodiscard]] uint8_t GetSkyLight(const int index) const { return GetNibble(SkyLight, index); }
+    [[nodiscard]] uint8_t GetBlockLight(const int index) const { return GetNibble(BlockLight, index); }
+    void SetSkyLight(const int index, const uint8_t level) { SetNibble(SkyLight, index, level); }
+    void SetBlockLight(const int index, const uint8_t level) { SetNibble(BlockLight, index, level); }
+
+    [[nodiscard]] static constexpr int Index(const int x, const int y, const int z)
+    {
+        return x | (z << SECTION_SHIFT) | (y << (2 * SECTION_SHIFT));
+    }
+
+    // Brick of a block, and the block's bit within that brick
+    [[nodiscard]] static constexpr int BrickIndex(const int x, const int y, const int z)
+    {
+        return (x >> BRICK_SHIFT) | ((z >> BRICK_SHIFT) << BRICK_SHIFT) | ((y >> BRICK_SHIFT) << (2 * BRICK_SHIFT));
+    }
+    [[nodiscard]] static constexpr int BrickVoxelIndex(const int x, const int y, const int z)
+    {
+        return (x & BRICK_MASK) | ((z & BRICK_MASK) << BRICK_SHIFT) | ((y & BRICK_MASK) << (2 * BRICK_SHIFT));
+    }
+
+    void SetOccupied(const int x, const int y, const int z, const bool occupied)
+    {
+        const int brick = BrickIndex(x, y, z);
+        const uint64_t bit = 1ull << BrickVoxelIndex(x, y, z);
+        VoxelMasks[brick] = occupied ? VoxelMasks[brick] | bit : VoxelMasks[brick] & ~bit;
+        BrickMask = VoxelMasks[brick] ? BrickMask | 1ull << brick : BrickMask & ~(1ull << brick);
+    }
+    [[nodiscard]] bool IsBrickEmpty(const int brick) const { return !(BrickMask >> brick & 1); }
+    [[nodiscard]] bool IsBrickFull(const int brick) const { return VoxelMasks[brick] == ~0ull; }
+
+    [[nodiscard]] bool IsEmpty() const { return NonAirCount == 0; }
+
+  private:
+    using Nibbles = std::array<uint8_t, SECTION_VOLUME / 2>;
+
+    static uint8_t GetNibble(const Nibbles &nibbles, const int index)
+    {
+        return (nibbles[index >> 1] >> ((index & 1) << 2)) & 0xF;
+    }
+    static void SetNibble(Nibbles &nibbles, const int index, const uint8_t level)
+    {
+        const int shift = (index & 1) << 2;
+        uint8_t &byte = nibbles[index >> 1];
+        byte = static_cast<uint8_t>((byte & ~(0xF << shift)) | ((level & 0xF) << shift));
+    }
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+class ThreadPool;
+class World;
+
+enum CollisionContact : uint8_t
+{
+    CollisionContact_None = 0,
+    CollisionContact_Ground = 1 << 0,
+    CollisionContact_Ceiling = 1 << 1,
+    CollisionContact_WallX = 1 << 2,
+    CollisionContact_WallZ = 1 << 3,
+};
+
+/**
+ * Axis aligned boxes moving through the world, stored as structure of arrays so a batch of bodies is a handful of
+ * linear streams. Positions are box centres.
+ */
+struct CollisionBodies
+{
+    std::vector<float> PositionX, PositionY, PositionZ;
+    std::vector<float> VelocityX, VelocityY, VelocityZ;
+    std::vector<float> HalfExtentX, HalfExtentY, HalfExtentZ;
+    std::vector<uint8_t> Contacts; // CollisionContact flags of the last step
+
+    size_t Add(const glm::vec3 &position, const glm::vec3 &halfExtents, const glm::vec3 &velocity = glm::vec3(0.0f));
+    void Clear();
+    [[nodiscard]] size_t GetCount() const { return PositionX.size(); }
+};
+
+/**
+ * Resolves swept boxes against the solid blocks of a world.
+ *
+ * Movement is resolved one axis at a time in a fixed order (y, x, z). Every axis sweep checks all voxel layers
+ * between the start and end position, nearest first, so fast bodies can't tunnel and the result only depends on the
+ * world and the body itself.
+ */
+class CollisionSystem
+{
+  public:
+    explicit CollisionSystem(const World &world);
+
+    /**
+     * Moves every body by velocity * deltaTime. Velocity components are zeroed on the axes that hit something.
+     * Bodies are processed in batches on the pool, the world must not be modified during the step.
+     */
+    void Step(CollisionBodies &bodies, float deltaTime, ThreadPool &threadPool) const;
+
+    /**
+     * Resolves a single body, returns its CollisionContact flags.
+     */
+    uint8_t Move(glm::vec3 &position, const glm::vec3 &halfExtents, glm::vec3 &velocity, float deltaTime) const;
+
+  private:
+    void StepRange(CollisionBodies &bodies, size_t begin, size_t end, float deltaTime) const;
+
+    const World &m_World;
+};
+
+} // namespace BloxxEngine
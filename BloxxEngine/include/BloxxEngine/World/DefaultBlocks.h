@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "TerrainGenerator.h"
+
+namespace BloxxEngine {
+
+class World;
+
+/**
+ * Registers the blocks of the default terrain and their tick handlers, the same for the client and the dedicated
+ * server so block ids match. Returns generator settings with the block ids filled in.
+ */
+TerrainGenerator::Settings RegisterDefaultBlocks(World &world);
+
+} // namespace BloxxEngine
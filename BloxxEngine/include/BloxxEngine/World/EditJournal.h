@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Block.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+/**
+ * The previous contents of the blocks a bulk edit changed, run length encoded per section in section index order.
+ * Unchanged runs only advance the position, so an undo restores exactly the blocks the edit wrote. Applying a
+ * journal with World::ApplyJournal returns the journal that reverts it again.
+ */
+struct EditJournal
+{
+    struct Run
+    {
+        BlockId Id;
+        uint8_t Metadata;
+        bool Changed;
+        uint16_t Length;
+    };
+
+    struct Section
+    {
+        int ChunkX, SectionY, ChunkZ;
+        size_t FirstRun;
+        size_t RunCount;
+    };
+
+    std::vector<Section> Sections;
+    std::vector<Run> Runs;
+    size_t ChangedCount = 0;
+
+    void BeginSection(const int chunkX, const int sectionY, const int chunkZ)
+    {
+        Sections.push_back({chunkX, sectionY, chunkZ, Runs.size(), 0});
+    }
+    // Appends changed blocks to the current section, with their previous value
+    void Record(const BlockId id, const uint8_t metadata, const int count = 1)
+    {
+        ChangedCount += count;
+        if (Sections.back().RunCount > 0)
+        {
+            Run &last = Runs.back();
+            if (last.Changed && last.Id == id && last.Metadata == metadata)
+            {
+                last.Length = static_cast<uint16_t>(last.Length + count);
+                return;
+            }
+        }
+        Runs.push_back({id, metadata, true, static_cast<uint16_t>(count)});
+        Sections.back().RunCount++;
+    }
+    // Appends blocks the edit left as they were
+    void Skip(const int count)
+    {
+        if (count <= 0)
+            return;
+        if (Sections.back().RunCount > 0 && !Runs.back().Changed)
+        {
+            Runs.back().Length = static_cast<uint16_t>(Runs.back().Length + count);
+            return;
+        }
+        Runs.push_back({BLOCK_AIR, 0, false, static_cast<uint16_t>(count)});
+        Sections.back().RunCount++;
+    }
+
+    [[nodiscard]] bool IsEmpty() const { return ChangedCount == 0; }
+    [[nodiscard]] size_t GetMemoryUsage() const
+    {
+        return Sections.size() * sizeof(Section) + Runs.size() * sizeof(Run);
+    }
+};
+
+/**
+ * A copied box of blocks, stored x first, then z, then y like the sections.
+ */
+struct BlockRegion
+{
+    glm::ivec3 Size{0};
+    std::vector<BlockId> Blocks;
+    std::vector<uint8_t> Metadata;
+
+    [[nodiscard]] size_t Index(const int x, const int y, const int z) const
+    {
+        return static_cast<size_t>(x) + static_cast<size_t>(Size.x) * (z + static_cast<size_t>(Size.z) * y);
+    }
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Block.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+class World;
+
+// Fluid metadata: the low bits hold the flow level, 0 for source blocks up to FLUID_MAX_LEVEL for the thinnest flow.
+// Falling fluid has FLUID_FALLING set and spreads like a source when it lands.
+constexpr uint8_t FLUID_LEVEL_MASK = 0x7;
+constexpr uint8_t FLUID_FALLING = 0x8;
+constexpr uint8_t FLUID_MAX_LEVEL = 7;
+
+/**
+ * Cellular flow for blocks with BlockFlag_Fluid.
+ *
+ * Only cells in the active set are evaluated: fluid cells that changed in the previous step, or whose neighbourhood
+ * was edited. Settled fluid drops out of the set and costs nothing. The set is bucketed by section and each step is
+ * double buffered: all sections read the world as it was at the start of the step and only record their changes, so
+ * they can run in parallel. The changes are applied afterwards on the calling thread.
+ */
+class FluidSimulator
+{
+  public:
+    struct Settings
+    {
+        float StepInterval = 0.25f;    // Seconds between two flow steps
+        size_t MaxCellsPerStep = 32768; // Larger active sets are spread over several steps
+    };
+
+    explicit FluidSimulator(World &world);
+
+    void SetSettings(const Settings &settings) { m_Settings = settings; }
+
+    void Update(float deltaTime);
+    // Runs a step right away, whether or not a step interval passed
+    void Step();
+
+    /**
+     * Marks the block and its neighbours for evaluation in the next step, World::SetBlock calls this for every
+     * change.
+     */
+    void OnBlockChanged(int x, int y, int z);
+
+    [[nodiscard]] size_t GetActiveCellCount() const { return m_ActiveCellCount; }
+    [[nodiscard]] double GetLastStepTime() const { return m_LastStepTime; } // Milliseconds
+
+  private:
+    struct FluidChange
+    {
+        int X, Y, Z;
+        BlockId Id;
+        uint8_t Metadata;
+    };
+
+    void Activate(int x, int y, int z);
+    void EvaluateSection(uint64_t sectionKey, std::vector<uint16_t> &cells, std::vector<FluidChange> &changes) const;
+
+    World &m_World;
+    Settings m_Settings;
+    float m_Accumulator = 0.0f;
+
+    // Cell indices per section, the set evaluated by the next step
+    std::unordered_map<uint64_t, std::vector<uint16_t>> m_Active;
+    size_t m_ActiveCellCount = 0;
+    double m_LastStepTime = 0.0;
+
+    // Kept between steps so their capacity is reused
+    std::vector<std::pair<uint64_t, std::vector<uint16_t>>> m_Sections;
+    std::vector<std::vector<FluidChange>> m_Changes;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Block.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+class Chunk;
+struct ChunkSection;
+class World;
+
+/**
+ * Flood fill lighting for sky and block light.
+ *
+ * Light spreads through transparent blocks one level per block. Full sky light (15) also travels straight down
+ * without losing a level. Edits are handled incrementally: the light around the changed block is first removed
+ * breadth first, then the light at the border of the removed region is spread back in. Nothing outside the affected
+ * region is touched. Light crosses into all loaded neighbour chunks, unloaded chunks stop it.
+ *
+ * The queues are owned by the engine and keep their capacity between runs. Propagate() may run on a worker thread
+ * as long as nothing modifies the world while it runs.
+ */
+class LightEngine
+{
+  public:
+    explicit LightEngine(World &world);
+
+    /**
+     * Computes the initial lighting of a freshly generated chunk, and lets the light of its loaded neighbours flow
+     * in. The work is queued, call Propagate() to run it.
+     */
+    void LightChunk(int chunkX, int chunkZ);
+
+    /**
+     * Queues the relighting for a block that changed from previous to current.
+     */
+    void OnBlockChanged(int x, int y, int z, BlockId previous, BlockId current);
+
+    /**
+     * Runs all queued removals, then all queued additions.
+     */
+    void Propagate();
+
+    [[nodiscard]] bool HasPendingWork() const;
+    // Number of voxels whose light changed during the last Propagate()
+    [[nodiscard]] size_t GetLastUpdateCount() const { return m_LastUpdateCount; }
+
+  private:
+    struct LightNode
+    {
+        int X, Y, Z;
+        uint8_t Level;
+    };
+
+    // A FIFO that is drained completely before it is reused, so it never has to shift its contents
+    struct LightQueue
+    {
+        std::vector<LightNode> Nodes;
+        size_t Head = 0;
+
+        void Push(const LightNode &node) { Nodes.push_back(node); }
+        [[nodiscard]] bool IsEmpty() const { return Head == Nodes.size(); }
+        const LightNode &Pop() { return Nodes[Head++]; }
+        void Reset()
+        {
+            Nodes.clear();
+            Head = 0;
+        }
+    };
+
+    enum class Channel
+    {
+        Sky,
+        Block,
+    };
+
+    void PropagateRemoval(Channel channel, LightQueue &removeQueue, LightQueue &addQueue);
+    void PropagateAddition(Channel channel, LightQueue &addQueue);
+
+    // Looks up a world position through the cached chunk. Returns false for unloaded chunks and positions outside
+    // the world, section is nullptr for sections that were never allocated.
+    bool Find(int x, int y, int z, ChunkSection *&section);
+    [[nodiscard]] uint8_t GetLight(Channel channel, int x, int y, int z, bool &loaded);
+    void SetLight(Channel channel, int x, int y, int z, uint8_t level);
+
+    World &m_World;
+
+    LightQueue m_SkyRemoveQueue, m_SkyAddQueue;
+    LightQueue m_BlockRemoveQueue, m_BlockAddQueue;
+
+    Chunk *m_CachedChunk = nullptr;
+    int m_CachedChunkX = 0, m_CachedChunkZ = 0;
+
+    size_t m_LastUpdateCount = 0;
+};
+
+} // namespace BloxxEngine
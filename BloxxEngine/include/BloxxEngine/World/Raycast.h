@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Block.h"
+#include "BlockRegistry.h"
+
+#include <glm/glm.hpp>
+
+namespace BloxxEngine {
+
+struct Ray
+{
+    glm::vec3 Origin{0.0f};
+    glm::vec3 Direction{0.0f, 0.0f, -1.0f}; // Doesn't have to be normalised
+    float MaxDistance = 64.0f;
+    uint8_t HitMask = BlockFlag_Solid; // BlockFlags of the blocks that stop the ray
+    bool SkipEmptySpace = true;        // Jump over air sections and bricks instead of walking them voxel by voxel
+};
+
+struct RaycastHit
+{
+    bool Hit = false;
+    glm::ivec3 Position{0};        // World coordinates of the block that was hit
+    glm::ivec3 Normal{0};          // Normal of the face the ray entered through, zero when it started inside the block
+    BlockFace::Direction Face = BlockFace::Direction::Top;
+    float Distance = 0.0f;         // Distance along the ray to the entry point
+    BlockId Id = BLOCK_AIR;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Block.h"
+
+#include <cstdint>
+
+namespace BloxxEngine {
+
+class Chunk;
+
+/**
+ * Deterministic height map terrain, the same seed always produces the same blocks for a chunk no matter in which
+ * order or on which thread chunks are generated.
+ */
+class TerrainGenerator
+{
+  public:
+    struct Settings
+    {
+        uint32_t Seed = 1337;
+        int BaseHeight = 64;
+        float Amplitude = 24.0f;
+        float Scale = 1.0f / 96.0f; // Noise frequency per block
+        int SeaLevel = 60;
+
+        BlockId Stone = BLOCK_AIR;
+        BlockId Dirt = BLOCK_AIR;
+        BlockId Grass = BLOCK_AIR;
+        BlockId Water = BLOCK_AIR;
+    };
+
+    explicit TerrainGenerator(const Settings &settings);
+
+    void Generate(Chunk &chunk) const;
+
+    [[nodiscard]] int GetHeight(int x, int z) const;
+
+  private:
+    [[nodiscard]] float ValueNoise(float x, float z, uint32_t seed) const;
+
+    Settings m_Settings;
+};
+
+} // namespace BloxxEngine
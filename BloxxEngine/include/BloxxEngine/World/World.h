@@ -4,42 +4,193 @@
  */
 
 #pragma once
+#include "BlockRegistry.h"
+#include "BlockTicker.h"
 #include "Chunk.h"
+#include "EditJournal.h"
+#include "FluidSimulator.h"
+#include "LightEngine.h"
+#include "Raycast.h"
 
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
 #include <unordered_map>
+#include <vector>
 
 namespace BloxxEngine
 {
 
+class ThreadPool;
+class WorldReplicator;
+
 class World
 {
   public:
-    World();
+    // Without a pool the fluid steps run on the calling thread
+    explicit World(ThreadPool *threadPool = nullptr);
     ~World();
 
+    /**
+     * Runs the block ticks, steps the fluids and applies the pending relighting.
+     */
     void Update(float deltaTime);
-    void Draw();
 
-    Chunk *GetChunk(int x, int y, int z);
-    void AddChunk(int x, int z);
-    void RemoveChunk(int x, int z);
+    [[nodiscard]] Chunk *GetChunk(int chunkX, int chunkZ);
+    [[nodiscard]] const Chunk *GetChunk(int chunkX, int chunkZ) const;
+    // Returns the existing chunk when there already is one at this position
+    Chunk &AddChunk(int chunkX, int chunkZ);
+    // The chunk is kept for reuse by AddChunk() while fewer than the pool limit are waiting
+    void RemoveChunk(int chunkX, int chunkZ);
+    void SetChunkPoolLimit(size_t limit);
+    [[nodiscard]] size_t GetPooledChunkCount() const { return m_ChunkPool.size(); }
+    [[nodiscard]] size_t GetChunkCount() const { return m_Chunks.size(); }
+
+    // Calls func(Chunk &) for every loaded chunk, in no particular order
+    template <typename F> void ForEachChunk(F &&func)
+    {
+        for (const auto &[key, chunk] : m_Chunks)
+            func(*chunk);
+    }
 
-    // Coordinate conversion functions
-    [[nodiscard]] Block *GetBlock(int x, int y, int z) const;
-    void SetBlock(int x, int y, int z, Block *id, BlockType type, uint8_t metadata);
+    // Block access in world coordinates, unloaded chunks and positions outside the height range read as air.
+    // SetBlock queues the relighting and fluid flow around the block, they are applied by the next Update(). The
+    // chunks touching the block are marked for a remesh.
+    [[nodiscard]] BlockId GetBlock(int x, int y, int z) const;
+    [[nodiscard]] uint8_t GetMetadata(int x, int y, int z) const;
+    void SetBlock(int x, int y, int z, BlockId id, uint8_t metadata = 0);
+    /**
+     * Queues the relighting, fluid flow, block ticks and remeshing around a block that was written to its chunk
+     * directly. SetBlock calls this itself.
+     */
+    void OnBlockChanged(int x, int y, int z, BlockId previous, BlockId id);
 
-  private:
-    struct PairHash
+    /**
+     * Bulk editing over inclusive boxes, a section at a time: rows of blocks are written in one go, and relighting,
+     * fluid activation and remeshing are queued once the whole edit is in. Light inside a region of blocks that all
+     * turned transparent or opaque is reset directly, only its border goes through the incremental lighting.
+     * Unloaded chunks are left out.
+     *
+     * Every edit returns the journal that undoes it.
+     */
+    EditJournal FillBox(const glm::ivec3 &min, const glm::ivec3 &max, BlockId id, uint8_t metadata = 0);
+    EditJournal FillSphere(const glm::ivec3 &center, int radius, BlockId id, uint8_t metadata = 0);
+    EditJournal Replace(const glm::ivec3 &min, const glm::ivec3 &max, BlockId from, BlockId to, uint8_t metadata = 0);
+    [[nodiscard]] BlockRegion CopyRegion(const glm::ivec3 &min, const glm::ivec3 &max) const;
+    // Air in the region leaves the existing blocks in place when skipAir is set
+    EditJournal PasteRegion(const BlockRegion &region, const glm::ivec3 &origin, bool skipAir = false);
+    // Restores the recorded blocks, returns the journal that redoes the edit
+    EditJournal ApplyJournal(const EditJournal &journal);
+
+    // Light levels in world coordinates, unloaded chunks read as unlit
+    [[nodiscard]] uint8_t GetSkyLight(int x, int y, int z) const;
+    [[nodiscard]] uint8_t GetBlockLight(int x, int y, int z) const;
+
+    /**
+     * Walks the voxels along the ray (Amanatides & Woo) and returns the first block matching Ray::HitMask.
+     * Chunks are only looked up when the ray crosses into the next section. With Ray::SkipEmptySpace the ray leaves
+     * air sections and empty bricks in a single step through their exit face, with the same hit as without it.
+     */
+    [[nodiscard]] RaycastHit Raycast(const Ray &ray) const;
+
+    /**
+     * Finds the block matching flagMask closest to center, within radius blocks on every axis. Sections and bricks
+     * that are empty, or further away than the best match so far, are skipped using the occupancy masks. Air never
+     * matches.
+     */
+    [[nodiscard]] std::optional<glm::ivec3> FindNearestBlock(const glm::ivec3 &center, int radius,
+                                                           uint8_t flagMask) const;
+
+    /**
+     * Traces all rays on the pool, hits[i] receives the result of rays[i]. The world must not be modified while
+     * this runs.
+     */
+    void RaycastBatch(std::span<const Ray> rays, std::span<RaycastHit> hits, ThreadPool &threadPool) const;
+
+    // Every block change is reported to the replicator, WorldReplicator registers itself
+    void SetReplicator(WorldReplicator *replicator) { m_Replicator = replicator; }
+
+    [[nodiscard]] LightEngine &GetLightEngine() { return m_LightEngine; }
+    [[nodiscard]] FluidSimulator &GetFluidSimulator() { return m_FluidSimulator; }
+    [[nodiscard]] BlockTicker &GetBlockTicker() { return m_BlockTicker; }
+    [[nodiscard]] ThreadPool *GetThreadPool() const { return m_ThreadPool; }
+    [[nodiscard]] BlockTypeRegistry &GetBlockRegistry() { return m_BlockRegistry; }
+    [[nodiscard]] const BlockTypeRegistry &GetBlockRegistry() const { return m_BlockRegistry; }
+
+    // Chunk coordinate of a world block coordinate, rounding towards negative infinity
+    [[nodiscard]] static constexpr int ToChunkCoordinate(const int blockCoordinate)
+    {
+        return blockCoordinate >> SECTION_SHIFT;
+    }
+
+    // Key of a chunk column in maps of chunks
+    [[nodiscard]] static uint64_t ChunkKey(const int chunkX, const int chunkZ)
     {
-        std::size_t operator()(const std::pair<int, int> &p) const
+        return static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32 | static_cast<uint32_t>(chunkZ);
+    }
+
+    struct ChunkKeyHash
+    {
+        std::size_t operator()(const uint64_t key) const
         {
-            return std::hash<int>()(p.first) ^ std::hash<int>()(p.second);
+            // splitmix64 finaliser, neighbouring chunks differ in only a few bits
+            uint64_t x = key;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return static_cast<std::size_t>(x ^ (x >> 31));
         }
     };
 
+    // Packs the coordinates of a section as 28 bit chunk x and z around an 8 bit section y
+    [[nodiscard]] static constexpr uint64_t SectionKey(const int chunkX, const int sectionY, const int chunkZ)
+    {
+        return (static_cast<uint64_t>(chunkX) & SECTION_KEY_MASK) << (SECTION_KEY_BITS + 8) |
+               static_cast<uint64_t>(sectionY & 0xFF) << SECTION_KEY_BITS |
+               (static_cast<uint64_t>(chunkZ) & SECTION_KEY_MASK);
+    }
+
+    // Chunk x, section y and chunk z of a SectionKey
+    [[nodiscard]] static constexpr glm::ivec3 UnpackSectionKey(const uint64_t key)
+    {
+        auto signExtend = [](const uint64_t value) {
+            return static_cast<int32_t>(static_cast<uint32_t>(value << (32 - SECTION_KEY_BITS))) >>
+                   (32 - SECTION_KEY_BITS);
+        };
+        return {signExtend(key >> (SECTION_KEY_BITS + 8)), static_cast<int>(key >> SECTION_KEY_BITS & 0xFF),
+                signExtend(key)};
+    }
+
+  private:
+    static constexpr int SECTION_KEY_BITS = 28;
+    static constexpr uint64_t SECTION_KEY_MASK = (1ull << SECTION_KEY_BITS) - 1;
+
+
+    void MarkForRemesh(int x, int z);
+
+    // Blocks of one section changed by a bulk edit, a bit per section index
+    using ChangeMask = std::array<uint64_t, SECTION_VOLUME / 64>;
+
+    // Runs edit(x, y, z, count, blocks, metadata) for every row of the box along +x, it overwrites the blocks it
+    // changes in place. See WorldEdit.cpp.
+    template <typename RowEdit>
+    EditJournal EditBox(const glm::ivec3 &min, const glm::ivec3 &max, bool createSections, RowEdit &&edit);
+    void FinishEdit(const EditJournal &journal, const std::vector<ChangeMask> &changes);
+
+    ThreadPool *m_ThreadPool;
+    BlockTypeRegistry m_BlockRegistry;
+    LightEngine m_LightEngine{*this};
+    FluidSimulator m_FluidSimulator{*this};
+    BlockTicker m_BlockTicker{*this};
+    WorldReplicator *m_Replicator = nullptr;
+
     // Map chunk positions to chunk pointers
-    std::unordered_map<std::pair<int, int>, std::unique_ptr<Chunk>, PairHash> m_Chunks;
+    using ChunkMap = std::unordered_map<uint64_t, std::unique_ptr<Chunk>, ChunkKeyHash>;
+    ChunkMap m_Chunks;
+    // Removed chunks with their map nodes, so streaming chunks in and out doesn't allocate
+    std::vector<ChunkMap::node_type> m_ChunkPool;
+    size_t m_ChunkPoolLimit = 256;
 };
 
 } // namespace BloxxEngine
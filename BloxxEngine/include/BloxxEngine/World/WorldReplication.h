@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Block.h"
+#include "ChunkSection.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+class Chunk;
+class World;
+
+/**
+ * Messages of the replication stream. A packet is any number of messages back to back, each a type byte followed by
+ * its body. Fixed size integers are little endian, counts and block ids are LEB128 varints and chunk coordinates
+ * zigzag varints. Section messages start with the chunk coordinates and a section index byte.
+ *
+ * Sections are sent as a palette of the distinct blocks (id and metadata) followed by an index per block in section
+ * index order, packed at the smallest bit width that fits the palette, or as runs of indices when that is smaller.
+ * Single block sections are the palette alone.
+ */
+enum class ReplicationMessage : uint8_t
+{
+    ChunkData = 1,    // Section mask (uint16) and the sections in it, replaces the chunk
+    UnloadChunk,      // Removes the chunk
+    SectionData,      // One section, replacing it as a whole
+    SectionDelta,     // Changed blocks of one section: index (uint16), id and metadata each
+    MultiBlockChange, // Changed blocks of one section as alternating unchanged and changed runs, then their values
+                      // as runs of equal blocks. Bulk edits mostly write long runs of the same block.
+};
+
+/**
+ * Server side of streaming a World to clients. It registers itself with the world and collects the blocks changed
+ * since the last WriteChanges() in a bit mask per section. WriteChanges() then sends every changed section in the
+ * smallest of its encodings: a list of changed blocks for a few scattered edits, runs for bulk edits and the whole
+ * section when most of it changed. The values sent are the ones at the time of WriteChanges(), blocks changed back
+ * and forth within a tick cost nothing extra.
+ *
+ * The messages don't depend on any client, so the packets of a tick can go to every client. Clients need the same
+ * block registry as the server, ids are sent as they are.
+ */
+class WorldReplicator
+{
+  public:
+    struct Stats
+    {
+        size_t ChangedBlocks = 0;
+        size_t Sections = 0;
+        size_t Bytes = 0;
+        size_t SectionDeltas = 0;
+        size_t MultiBlockChanges = 0;
+        size_t SectionDatas = 0;
+    };
+
+    using ChangeMask = std::array<uint64_t, SECTION_VOLUME / 64>;
+
+    explicit WorldReplicator(World &world);
+    ~WorldReplicator();
+
+    WorldReplicator(WorldReplicator &) = delete;
+    WorldReplicator &operator=(WorldReplicator &) = delete;
+
+    // Called by the World for every change, from the thread that modifies it
+    void OnBlockChanged(int x, int y, int z);
+    // The changed blocks of a section, a bit per section index
+    void OnSectionChanged(int chunkX, int sectionY, int chunkZ, const ChangeMask &mask);
+
+    // Appends a ChunkData message, for clients that start watching the chunk. Does nothing when it isn't loaded.
+    void WriteChunk(int chunkX, int chunkZ, std::vector<uint8_t> &packet) const;
+    static void WriteUnloadChunk(int chunkX, int chunkZ, std::vector<uint8_t> &packet);
+    // Appends the changes since the last call, a message per changed section that is still loaded
+    void WriteChanges(std::vector<uint8_t> &packet);
+
+    [[nodiscard]] bool HasChanges() const { return !m_Pending.empty(); }
+    // Of the last WriteChanges()
+    [[nodiscard]] const Stats &GetLastStats() const { return m_LastStats; }
+
+  private:
+    struct PendingSection
+    {
+        int ChunkX, SectionY, ChunkZ;
+        ChangeMask Mask;
+    };
+
+    PendingSection &GetPending(int chunkX, int sectionY, int chunkZ);
+
+    World &m_World;
+    // Index into m_Pending per section key
+    std::unordered_map<uint64_t, size_t> m_PendingIndex;
+    std::vector<PendingSection> m_Pending;
+    // Scratch for the candidate encodings of a section
+    std::vector<uint8_t> m_Delta, m_Runs, m_Section;
+    Stats m_LastStats;
+};
+
+/**
+ * Client side: applies the packets of a WorldReplicator to a local World.
+ *
+ * Blocks are written to the chunks directly and only relit and remeshed, fluid flow and block ticks stay with the
+ * server. Chunks are lit with LightEngine::LightChunk when they arrive, so the client still has to propagate the
+ * light, World::Update() does so.
+ */
+class WorldReplica
+{
+  public:
+    explicit WorldReplica(World &world);
+
+    /**
+     * Applies the messages of a packet in order. Messages for chunks that aren't loaded are skipped. Stops at the
+     * first malformed message and returns false, the messages before it stay applied.
+     */
+    bool Apply(std::span<const uint8_t> packet);
+
+    // Blocks changed by the last Apply()
+    [[nodiscard]] size_t GetLastChangedBlocks() const { return m_LastChangedBlocks; }
+
+  private:
+    // Writes one block that differs from the current one and queues its relighting and remeshing
+    void SetBlock(Chunk &chunk, int sectionY, int index, BlockId id, uint8_t metadata);
+
+    World &m_World;
+    size_t m_LastChangedBlocks = 0;
+};
+
+} // namespace BloxxEngine
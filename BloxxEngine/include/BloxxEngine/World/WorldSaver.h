@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "Block.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+class Chunk;
+class World;
+
+/**
+ * Saves the chunks edited since their last save in the background, one file per chunk ("c.<x>.<z>.bxc").
+ *
+ * Save() runs on the thread that modifies the world and only copies the blocks of the edited sections. Encoding,
+ * run length compression and writing happen on the world's thread pool while the world moves on. Chunks that are
+ * already on disk are merged with their file there, so only their edited sections have to be copied. Each file is
+ * written next to its target and renamed over it, so a crash never leaves a half written chunk. Chunks that fail
+ * to write are saved in full by the next save.
+ *
+ * Generated terrain is not saved, only chunks changed through the World. LoadChunk() puts the saved blocks back
+ * over a freshly generated chunk.
+ */
+class WorldSaver
+{
+  public:
+    struct Settings
+    {
+        double AutosaveInterval = 30.0; // Seconds between autosaves, 0 disables them
+    };
+
+    WorldSaver(World &world, std::filesystem::path directory);
+    // Waits for the save in flight
+    ~WorldSaver();
+
+    WorldSaver(WorldSaver &) = delete;
+    WorldSaver &operator=(WorldSaver &) = delete;
+
+    void SetSettings(const Settings &settings) { m_Settings = settings; }
+
+    // Starts an autosave once the interval has passed, and finishes completed saves
+    void Update(float deltaTime);
+
+    /**
+     * Takes the snapshot of the edited chunks and starts writing it. Returns false when the previous save is still
+     * running, the chunks then stay marked for the next one.
+     */
+    bool Save();
+    // Blocks until the save in flight is written
+    void Wait();
+    [[nodiscard]] bool IsSaving() const { return m_Saving.load(std::memory_order_acquire); }
+
+    // Replaces the blocks of the chunk with its saved copy, returns false when there is none
+    bool LoadChunk(Chunk &chunk);
+
+    [[nodiscard]] const std::filesystem::path &GetDirectory() const { return m_Directory; }
+    [[nodiscard]] std::filesystem::path GetChunkPath(int chunkX, int chunkZ) const;
+
+    // Statistics of the last completed save
+    [[nodiscard]] size_t GetLastChunkCount() const { return m_LastChunkCount; }
+    [[nodiscard]] uint64_t GetLastBytesWritten() const { return m_LastBytesWritten; }
+    // Main thread time of the snapshot, in milliseconds
+    [[nodiscard]] double GetLastSnapshotTime() const { return m_LastSnapshotTime; }
+    // From the snapshot to the last file written, in milliseconds
+    [[nodiscard]] double GetLastSaveTime() const { return m_LastSaveTime; }
+
+  private:
+    // Point in time copy of the blocks of the copied sections of one chunk, the non-empty ones back to back
+    struct ChunkSnapshot
+    {
+        int ChunkX = 0, ChunkZ = 0;
+        uint16_t CopiedMask = 0;  // The sections the snapshot covers, the others are taken from the file
+        uint16_t SectionMask = 0; // The non-empty copied sections
+        std::vector<BlockId> Blocks;
+        std::vector<uint8_t> Metadata;
+        bool Failed = false;
+    };
+
+    void WriteChunks(size_t begin, size_t end);
+    bool WriteChunk(const ChunkSnapshot &snapshot, std::vector<uint8_t> &buffer);
+    // Bookkeeping on the world's thread once the workers are done
+    void FinishSave();
+
+    World &m_World;
+    std::filesystem::path m_Directory;
+    Settings m_Settings;
+    double m_TimeSinceSave = 0.0;
+    // Chunks with a complete file, loaded from or written by this saver. Only touched on the world's thread.
+    std::unordered_set<uint64_t> m_ChunksOnDisk;
+
+    // Owned by the save in flight, kept afterwards so the next snapshot reuses the buffers
+    std::vector<ChunkSnapshot> m_Snapshots;
+    size_t m_SnapshotCount = 0;
+    std::chrono::steady_clock::time_point m_SaveStart;
+
+    std::atomic<bool> m_Saving{false};
+    bool m_NeedsFinish = false;
+    std::atomic<size_t> m_RemainingJobs{0};
+    std::atomic<uint64_t> m_BytesWritten{0};
+    std::chrono::steady_clock::time_point m_SaveEnd; // Written by the last job
+    std::mutex m_DoneMutex;
+    std::condition_variable m_Done;
+
+    size_t m_LastChunkCount = 0;
+    uint64_t m_LastBytesWritten = 0;
+    double m_LastSnapshotTime = 0.0;
+    double m_LastSaveTime = 0.0;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "ChunkMesh.h"
+#include "World/World.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace BloxxEngine
+{
+
+class Chunk;
+class ThreadPool;
+
+/**
+ * Draws a World. Keeps a ChunkMesh per loaded chunk, the world itself holds no GL state so it can run headless.
+ * Meshes of unloaded chunks are kept for reuse by the next chunks that get loaded.
+ */
+class WorldRenderer
+{
+  public:
+    struct LodSettings
+    {
+        // Horizontal distance from the camera at which each coarser level starts, in blocks
+        std::array<float, CHUNK_LOD_COUNT - 1> Distances{128.0f, 256.0f, 384.0f};
+        // A chunk only changes level once it is this much past a threshold, so it doesn't pop back and forth
+        float Hysteresis = 16.0f;
+    };
+
+    // Without a pool meshing and sorting run on the calling thread
+    explicit WorldRenderer(World &world, ThreadPool *threadPool = nullptr);
+    ~WorldRenderer();
+
+    WorldRenderer(WorldRenderer &) = delete;
+    WorldRenderer &operator=(WorldRenderer &) = delete;
+
+    void SetLodSettings(const LodSettings &settings) { m_LodSettings = settings; }
+    /**
+     * Picks the level of detail of every chunk from its distance to the camera. Chunks that change level, and their
+     * neighbours for the skirts, are marked for a remesh.
+     */
+    void UpdateLods(const glm::vec3 &cameraPosition);
+    // Number of chunks at each level of detail, as of the last UpdateLods()
+    [[nodiscard]] const std::array<int, CHUNK_LOD_COUNT> &GetLodCounts() const { return m_LodCounts; }
+
+    /**
+     * Releases the meshes of unloaded chunks and rebuilds the geometry of the chunks marked for a remesh, the GL
+     * uploads happen when the meshes are drawn. The world must not be modified while this runs.
+     */
+    void UpdateMeshes();
+
+    // Draws the opaque geometry, returns the number of draw calls
+    int Draw();
+    /**
+     * Draws the translucent geometry back to front, after Draw() and with blending enabled. Returns the number of
+     * draw calls.
+     */
+    int DrawTranslucent(const glm::vec3 &cameraPosition);
+    /**
+     * Re-sorts the translucent sections the camera moved relative to on the pool, returns the number of sections
+     * that were re-sorted.
+     */
+    int SortTranslucent(const glm::vec3 &cameraPosition);
+
+    [[nodiscard]] size_t GetMeshCount() const { return m_Meshes.size(); }
+    [[nodiscard]] size_t GetPooledMeshCount() const { return m_MeshPool.size(); }
+
+  private:
+    struct TranslucentMesh
+    {
+        ChunkMesh *Mesh;
+        float Distance; // Squared, to the chunk column's center
+    };
+
+    ChunkMesh &GetOrCreateMesh(int chunkX, int chunkZ);
+    [[nodiscard]] const ChunkMesh *GetMesh(int chunkX, int chunkZ) const;
+    void GatherTranslucent(const glm::vec3 &cameraPosition);
+
+    World &m_World;
+    ThreadPool *m_ThreadPool;
+
+    using MeshMap = std::unordered_map<uint64_t, std::unique_ptr<ChunkMesh>, World::ChunkKeyHash>;
+    MeshMap m_Meshes;
+    // Meshes of unloaded chunks with their map nodes, they keep their buffers
+    std::vector<MeshMap::node_type> m_MeshPool;
+
+    LodSettings m_LodSettings;
+    std::array<int, CHUNK_LOD_COUNT> m_LodCounts{};
+
+    // Scratch, rebuilt per call
+    struct RemeshJob
+    {
+        Chunk *Source;
+        ChunkMesh *Mesh;
+        bool Skirts[2][2];
+    };
+    std::vector<RemeshJob> m_RemeshJobs;
+    std::vector<TranslucentMesh> m_TranslucentMeshes;
+};
+
+} // namespace BloxxEngine
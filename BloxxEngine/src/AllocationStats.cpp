@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/AllocationStats.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+// Relaxed, the counters are only read for statistics
+std::atomic<uint64_t> g_AllocationCount{0};
+std::atomic<uint64_t> g_AllocatedBytes{0};
+} // namespace
+
+void *operator new(const std::size_t size)
+{
+    g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void *operator new[](const std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace BloxxEngine
+{
+
+AllocationCounters GetAllocationCounters()
+{
+    return {g_AllocationCount.load(std::memory_order_relaxed), g_AllocatedBytes.load(std::memory_order_relaxed)};
+}
+
+} // namespace BloxxEngine
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "AssetArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+// Whether every index refers to one of the vertices, the index data isn't necessarily aligned in the file
+template <typename T>
+bool IndicesInRange(const std::byte *indices, const uint32_t indexCount, const uint32_t vertexCount)
+{
+    for (uint32_t i = 0; i < indexCount; i++)
+    {
+        T index;
+        std::memcpy(&index, indices + static_cast<size_t>(i) * sizeof(T), sizeof(T));
+        if (index >= vertexCount)
+            return false;
+    }
+    return true;
+}
+} // namespace
+
+bool AssetArchive::Open(const std::string &path)
+{
+    if (!m_File.Open(path))
+        return false;
+
+    const std::byte *data = m_File.GetData();
+    const size_t size = m_File.GetSize();
+
+    AssetArchiveHeader header{};
+    if (size < sizeof(header))
+    {
+        std::cerr << "Asset archive " << path << " is truncated" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.Magic != ASSET_ARCHIVE_MAGIC || header.Version != ASSET_ARCHIVE_VERSION)
+    {
+        std::cerr << "Asset archive " << path << " has an unsupported format" << std::endl;
+        return false;
+    }
+
+    const uint64_t tableSize = static_cast<uint64_t>(header.EntryCount) * sizeof(AssetArchiveEntry);
+    if (header.EntryTableOffset + tableSize > size || header.StringTableOffset + header.StringTableSize > size)
+    {
+        std::cerr << "Asset archive " << path << " is truncated" << std::endl;
+        return false;
+    }
+
+    m_Entries = {reinterpret_cast<const AssetArchiveEntry *>(data + header.EntryTableOffset), header.EntryCount};
+    m_Strings = {reinterpret_cast<const char *>(data + header.StringTableOffset), header.StringTableSize};
+    return true;
+}
+
+const AssetArchiveEntry *AssetArchive::FindEntry(const std::string_view path) const
+{
+    const uint64_t hash = HashAssetPath(path);
+
+    auto it = std::lower_bound(m_Entries.begin(), m_Entries.end(), hash,
+                               [](const AssetArchiveEntry &entry, const uint64_t h) { return entry.PathHash < h; });
+
+    // Walk the (rare) run of colliding hashes and compare the stored path
+    for (; it != m_Entries.end() && it->PathHash == hash; ++it)
+    {
+        if (m_Strings.substr(it->PathOffset, it->PathLength) == path)
+            return &*it;
+    }
+    return nullptr;
+}
+
+bool AssetArchive::Contains(const uint64_t offset, const uint64_t size) const
+{
+    return offset <= m_File.GetSize() && size <= m_File.GetSize() - offset;
+}
+
+std::span<const std::byte> AssetArchive::GetData(const AssetArchiveEntry &entry) const
+{
+    if (!Contains(entry.DataOffset, entry.DataSize))
+        return {};
+    return {m_File.GetData() + entry.DataOffset, entry.DataSize};
+}
+
+bool AssetArchive::GetImage(const AssetArchiveEntry &entry, Image &image) const
+{
+    const std::span<const std::byte> data = GetData(entry);
+    if (entry.Kind != AssetKind::Texture || data.size() < sizeof(TextureAssetHeader))
+        return false;
+
+    const auto *header = reinterpret_cast<const TextureAssetHeader *>(data.data());
+    if (header->Format != TextureFormat::RGBA8 || header->MipCount == 0 || header->MipCount > ASSET_MAX_MIP_LEVELS)
+        return false;
+
+    image.Width = static_cast<int>(header->Width);
+    image.Height = static_cast<int>(header->Height);
+    image.Mips.clear();
+    image.Mips.reserve(header->MipCount);
+
+    for (uint32_t i = 0; i < header->MipCount; i++)
+    {
+        // The upload reads every pixel of the mip straight from the mapping
+        const TextureMipHeader &mip = header->Mips[i];
+        if (!Contains(mip.DataOffset, mip.DataSize) || mip.DataSize < static_cast<uint64_t>(mip.Width) * mip.Height * 4)
+            return false;
+
+        image.Mips.push_back({static_cast<int>(mip.Width), static_cast<int>(mip.Height),
+                              reinterpret_cast<const unsigned char *>(m_File.GetData() + mip.DataOffset)});
+    }
+    return true;
+}
+
+bool AssetArchive::GetMesh(const AssetArchiveEntry &entry, CookedMesh &mesh) const
+{
+    const std::span<const std::byte> data = GetData(entry);
+    if (entry.Kind != AssetKind::Mesh || data.size() < sizeof(MeshAssetHeader))
+        return false;
+
+    const auto *header = reinterpret_cast<const MeshAssetHeader *>(data.data());
+    if (header->IndexSize != 2 && header->IndexSize != 4)
+        return false;
+
+    const uint64_t vertexBytes = static_cast<uint64_t>(header->VertexCount) * sizeof(PackedMeshVertex);
+    const uint64_t indexBytes = static_cast<uint64_t>(header->IndexCount) * header->IndexSize;
+    if (!Contains(header->VertexOffset, vertexBytes) || !Contains(header->IndexOffset, indexBytes))
+        return false;
+
+    // An index past the last vertex would make the GPU read outside the vertex buffer
+    const std::byte *indices = m_File.GetData() + header->IndexOffset;
+    const bool inRange = header->IndexSize == 2
+                             ? IndicesInRange<uint16_t>(indices, header->IndexCount, header->VertexCount)
+                             : IndicesInRange<uint32_t>(indices, header->IndexCount, header->VertexCount);
+    if (!inRange)
+        return false;
+
+    mesh.VertexCount = header->VertexCount;
+    mesh.IndexCount = header->IndexCount;
+    mesh.IndexSize = header->IndexSize;
+    mesh.BoundsMin = glm::vec3(header->BoundsMin[0], header->BoundsMin[1], header->BoundsMin[2]);
+    mesh.BoundsMax = glm::vec3(header->BoundsMax[0], header->BoundsMax[1], header->BoundsMax[2]);
+    mesh.Vertices = reinterpret_cast<const PackedMeshVertex *>(m_File.GetData() + header->VertexOffset);
+    mesh.Indices = indices;
+    return true;
+}
+
+} // namespace BloxxEngine
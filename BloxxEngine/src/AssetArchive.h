@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "BloxxEngine/AssetFormat.h"
+#include "BloxxEngine/CookedMesh.h"
+#include "BloxxEngine/Image.h"
+#include "MappedFile.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace BloxxEngine
+{
+
+/**
+ * Read-only view of a memory-mapped .bxpak archive written by the AssetPacker tool.
+ */
+class AssetArchive
+{
+  public:
+    bool Open(const std::string &path);
+
+    [[nodiscard]] const AssetArchiveEntry *FindEntry(std::string_view path) const;
+    [[nodiscard]] std::span<const std::byte> GetData(const AssetArchiveEntry &entry) const;
+
+    bool GetImage(const AssetArchiveEntry &entry, Image &image) const;
+    bool GetMesh(const AssetArchiveEntry &entry, CookedMesh &mesh) const;
+
+  private:
+    // Whether size bytes from offset lie within the file, offsets read from a damaged archive can be anything
+    [[nodiscard]] bool Contains(uint64_t offset, uint64_t size) const;
+
+    MappedFile m_File;
+    std::span<const AssetArchiveEntry> m_Entries;
+    std::string_view m_Strings;
+};
+
+} // namespace BloxxEngine
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/AssetManager.h"
+
+#include "BloxxEngine/AssetCooking.h"
+#include "BloxxEngine/AssetFormat.h"
+#include "BloxxEngine/FileSystem.h"
+
+#include <stb_image.h>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <ranges>
+#include <set>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+// Drawn while the real shader is still compiling: same inputs as the block shader, flat grey output
+constexpr auto PlaceholderVertexSource = R"(#version 460 core
+layout(location = 0) in vec3 aPos;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+void main() {
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
+)";
+
+constexpr auto PlaceholderFragmentSource = R"(#version 460 core
+out vec4 FragColor;
+void main() {
+    FragColor = vec4(0.5, 0.5, 0.5, 1.0);
+}
+)";
+} // namespace
+
+void AssetManager::WorkerAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+    Manager->m_ThreadPool.Submit([handle] { handle.resume(); });
+}
+
+void AssetManager::MainThreadAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+    std::lock_guard lock(Manager->m_MainThreadMutex);
+    Manager->m_MainThreadQueue.push_back(handle);
+}
+
+AssetManager::AssetManager(ThreadPool &threadPool) : m_ThreadPool(threadPool)
+{
+    m_PlaceholderShader = Shader::FromSource(PlaceholderVertexSource, PlaceholderFragmentSource, "placeholder");
+}
+
+AssetManager::~AssetManager()
+{
+    // Loader coroutines reference this manager, let them all finish
+    while (m_PendingCount > 0)
+    {
+        Update(std::numeric_limits<double>::infinity());
+        std::this_thread::yield();
+    }
+}
+
+AssetHandle<Texture> AssetManager::LoadTexture(const std::string &path, const Texture::FilterMode filterMode,
+                                               const Texture::WrapMode wrapMode, const uint32_t placeholderColor)
+{
+    // The sampler state is part of the texture, so a request with other modes needs its own
+    std::string key = path;
+    key += '|';
+    key += static_cast<char>('0' + static_cast<int>(filterMode));
+    key += static_cast<char>('0' + static_cast<int>(wrapMode));
+
+    if (const auto it = m_Textures.find(key); it != m_Textures.end())
+    {
+        if (auto existing = it->second.Slot.lock())
+            return AssetHandle<Texture>(std::move(existing));
+    }
+    PruneRequests();
+
+    auto slot = std::make_shared<AssetSlot<Texture>>();
+    slot->Path = path;
+    slot->Placeholder = GetPlaceholderTexture(placeholderColor);
+    m_Textures[key] = {slot, path, filterMode, wrapMode};
+
+    m_PendingCount++;
+    LoadTextureAsync(slot, filterMode, wrapMode, false);
+
+    return AssetHandle<Texture>(std::move(slot));
+}
+
+AssetHandle<Shader> AssetManager::LoadShader(const std::string &vertexPath, const std::string &fragmentPath)
+{
+    const std::string key = vertexPath + "|" + fragmentPath;
+    if (const auto it = m_Shaders.find(key); it != m_Shaders.end())
+    {
+        if (auto existing = it->second.Slot.lock())
+            return AssetHandle<Shader>(std::move(existing));
+    }
+    PruneRequests();
+
+    auto slot = std::make_shared<AssetSlot<Shader>>();
+    slot->Path = key;
+    slot->Placeholder = m_PlaceholderShader.get();
+    m_Shaders[key] = {slot, vertexPath, fragmentPath, {}};
+
+    m_PendingCount++;
+    LoadShaderAsync(slot, vertexPath, fragmentPath, false);
+
+    return AssetHandle<Shader>(std::move(slot));
+}
+
+void AssetManager::SetReloadSource(const std::string &mountPoint, const std::string &sourceDir)
+{
+    m_ReloadMountPoint = mountPoint.ends_with('/') ? mountPoint : mountPoint + "/";
+    m_ReloadSourceDir = sourceDir.ends_with('/') ? sourceDir : sourceDir + "/";
+}
+
+void AssetManager::Reload(const std::string &path)
+{
+    for (const auto &request : m_Textures | std::views::values)
+    {
+        if (request.Path != path)
+            continue;
+
+        if (auto slot = request.Slot.lock())
+        {
+            std::cout << "Reloading " << path << std::endl;
+            m_PendingCount++;
+            LoadTextureAsync(std::move(slot), request.FilterMode, request.WrapMode, true);
+        }
+    }
+
+    for (const auto &[key, request] : m_Shaders)
+    {
+        const bool uses = request.VertexPath == path || request.FragmentPath == path ||
+                          std::ranges::find(request.Files, path) != request.Files.end();
+        if (!uses)
+            continue;
+
+        if (auto slot = request.Slot.lock())
+        {
+            std::cout << "Reloading " << key << std::endl;
+            m_PendingCount++;
+            LoadShaderAsync(std::move(slot), request.VertexPath, request.FragmentPath, true);
+        }
+    }
+}
+
+void AssetManager::Update(const double budgetSeconds)
+{
+    std::vector<std::coroutine_handle<>> queue;
+    {
+        std::lock_guard lock(m_MainThreadMutex);
+        queue.swap(m_MainThreadQueue);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    size_t resumed = 0;
+    for (; resumed < queue.size(); resumed++)
+    {
+        // Always make progress, but leave the rest for the next frame once the budget is spent
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (resumed > 0 && elapsed.count() > budgetSeconds)
+            break;
+
+        queue[resumed].resume();
+    }
+
+    if (resumed < queue.size())
+    {
+        std::lock_guard lock(m_MainThreadMutex);
+        m_MainThreadQueue.insert(m_MainThreadQueue.begin(), queue.begin() + static_cast<std::ptrdiff_t>(resumed),
+                                 queue.end());
+    }
+}
+
+AsyncTask AssetManager::LoadTextureAsync(std::shared_ptr<AssetSlot<Texture>> slot, const Texture::FilterMode filterMode,
+                                         const Texture::WrapMode wrapMode, const bool fromSource)
+{
+    const std::string path = fromSource ? GetSourcePath(slot->Path) : slot->Path;
+    // A reload keeps the mip chain the packer gave the texture
+    const bool generateMips = slot->Asset && slot->Asset->GetMipCount() > 1;
+
+    co_await ResumeOnWorker();
+
+    // Archived textures are already decoded, anything else is decoded here on the worker
+    Image image;
+    std::vector<std::vector<uint8_t>> levels;
+    if (fromSource || !FileSystem::FindImage(path, image))
+    {
+        int width, height, channels;
+        stbi_set_flip_vertically_on_load_thread(true);
+        const std::unique_ptr<unsigned char, void (*)(void *)> pixels(
+            stbi_load(path.c_str(), &width, &height, &channels, 4), stbi_image_free);
+        if (pixels)
+        {
+            levels.emplace_back(pixels.get(), pixels.get() + static_cast<size_t>(width) * height * 4);
+            std::vector<std::pair<int, int>> sizes = {{width, height}};
+            if (generateMips)
+                GenerateMips(levels, sizes, ASSET_MAX_MIP_LEVELS);
+
+            image.Width = width;
+            image.Height = height;
+            for (size_t i = 0; i < levels.size(); i++)
+                image.Mips.push_back({sizes[i].first, sizes[i].second, levels[i].data()});
+        }
+    }
+
+    co_await ResumeOnMainThread();
+
+    if (image.Mips.empty())
+    {
+        std::cerr << "Failed to load " << path << std::endl;
+        if (!slot->Asset)
+            slot->State = AssetState::Failed;
+    }
+    else
+    {
+        slot->Asset = std::make_unique<Texture>(image, filterMode, wrapMode);
+        slot->State = AssetState::Ready;
+    }
+    m_PendingCount--;
+}
+
+AsyncTask AssetManager::LoadShaderAsync(std::shared_ptr<AssetSlot<Shader>> slot, std::string vertexPath,
+                                        std::string fragmentPath, const bool fromSource)
+{
+    const std::string vertexSourcePath = GetSourcePath(vertexPath);
+    const std::string fragmentSourcePath = GetSourcePath(fragmentPath);
+    const bool trackIncludes = !m_ReloadSourceDir.empty();
+
+    co_await ResumeOnWorker();
+
+    // Shaders read from disk go through the packer's preprocessor, so their includes resolve as in an archive. The
+    // files read are kept to reload the shader when one of its includes changes.
+    std::vector<std::filesystem::path> files;
+    const auto readSource = [&](const std::string &path, const std::string &sourcePath) -> std::optional<std::string> {
+        std::string source;
+        std::set<std::filesystem::path> includeStack;
+        if (!fromSource)
+        {
+            if (const auto text = FileSystem::FindText(path))
+            {
+                // Archived shaders are preprocessed already, the source is only read for its includes
+                if (trackIncludes)
+                    PreprocessShader(sourcePath, source, includeStack, &files);
+                return std::string(*text);
+            }
+        }
+        if (!PreprocessShader(fromSource ? sourcePath : path, source, includeStack, &files))
+            return std::nullopt;
+        return source;
+    };
+    const auto vertexSource = readSource(vertexPath, vertexSourcePath);
+    const auto fragmentSource = readSource(fragmentPath, fragmentSourcePath);
+
+    co_await ResumeOnMainThread();
+
+    if (!vertexSource || !fragmentSource)
+    {
+        std::cerr << "Failed to load shader " << slot->Path << std::endl;
+        if (!slot->Asset)
+            slot->State = AssetState::Failed;
+    }
+    else if (slot->Asset)
+    {
+        // Keep the Shader object so uniform setters and handles keep working, only the program is replaced
+        if (!slot->Asset->Reload(*vertexSource, *fragmentSource))
+            std::cerr << "Keeping previous version of " << slot->Path << std::endl;
+    }
+    else
+    {
+        slot->Asset = Shader::FromSource(*vertexSource, *fragmentSource, slot->Path);
+        slot->State = AssetState::Ready;
+    }
+
+    if (const auto it = m_Shaders.find(slot->Path); it != m_Shaders.end() && vertexSource && fragmentSource)
+    {
+        it->second.Files.clear();
+        for (const std::filesystem::path &file : files)
+            it->second.Files.push_back(GetAssetPath(file));
+    }
+    m_PendingCount--;
+}
+
+void AssetManager::PruneRequests()
+{
+    // Only on cache misses, so the maps don't grow with every asset that was ever loaded
+    std::erase_if(m_Textures, [](const auto &entry) { return entry.second.Slot.expired(); });
+    std::erase_if(m_Shaders, [](const auto &entry) { return entry.second.Slot.expired(); });
+}
+
+std::string AssetManager::GetSourcePath(const std::string &path) const
+{
+    if (m_ReloadSourceDir.empty() || !path.starts_with(m_ReloadMountPoint))
+        return path;
+    return m_ReloadSourceDir + path.substr(m_ReloadMountPoint.size());
+}
+
+std::string AssetManager::GetAssetPath(const std::filesystem::path &sourcePath) const
+{
+    const std::string path = sourcePath.lexically_normal().generic_string();
+    const std::string sourceDir = std::filesystem::path(m_ReloadSourceDir).lexically_normal().generic_string();
+    if (sourceDir.empty() || !path.starts_with(sourceDir))
+        return path;
+    return m_ReloadMountPoint + path.substr(sourceDir.size());
+}
+
+Texture *AssetManager::GetPlaceholderTexture(const uint32_t color)
+{
+    auto &placeholder = m_PlaceholderTextures[color];
+    if (!placeholder)
+    {
+        const std::array<unsigned char, 4> pixel = {
+            static_cast<unsigned char>(color >> 24), static_cast<unsigned char>(color >> 16),
+            static_cast<unsigned char>(color >> 8), static_cast<unsigned char>(color)};
+
+        Image image;
+        image.Width = 1;
+        image.Height = 1;
+        image.Mips = {{1, 1, pixel.data()}};
+        placeholder = std::make_unique<Texture>(image, Texture::FilterMode::Nearest);
+    }
+    return placeholder.get();
+}
+
+} // namespace BloxxEngine
@@ -77,6 +77,13 @@ void Camera::Rotate(float xOffset, float yOffset, bool constrainPitch)
     UpdateCameraVectors();
 }
 
+void Camera::SetOrientation(const float yaw, const float pitch)
+{
+    Yaw = yaw;
+    Pitch = pitch;
+    UpdateCameraVectors();
+}
+
 void Camera::Zoom(float yOffset)
 {
     ZoomFactor -= yOffset;
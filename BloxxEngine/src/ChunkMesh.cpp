@@ -0,0 +1,562 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/ChunkMesh.h"
+#include "BloxxEngine/Metrics.h"
+
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <ranges>
+
+namespace BloxxEngine
+{
+ChunkMesh::~ChunkMesh()
+{
+    if (m_VAO)
+    {
+        glDeleteVertexArrays(1, &m_VAO);
+        glDeleteBuffers(1, &m_VBO);
+        glDeleteBuffers(1, &m_EBO);
+    }
+}
+
+void ChunkMesh::Reset()
+{
+    m_Mesh.Clear();
+    m_IndexCount = 0;
+    m_Lod = 0;
+    m_NeedsUpload = false;
+}
+
+void ChunkMesh::MeshData::Clear()
+{
+    Vertices.clear();
+    Indices.clear();
+    TranslucentCount = 0;
+}
+
+ChunkMesh::TranslucentSection &ChunkMesh::MeshData::AddTranslucent(const int sectionIndex)
+{
+    if (TranslucentCount == Translucent.size())
+        Translucent.emplace_back();
+
+    TranslucentSection &section = Translucent[TranslucentCount++];
+    section.SectionIndex = sectionIndex;
+    section.QuadCenters.clear();
+    section.QuadIndices.clear();
+    section.Indices.clear();
+    section.Order.clear();
+    section.IndexOffset = 0;
+    section.SortVoxel = glm::ivec3(std::numeric_limits<int>::min());
+    section.NeedsUpload = false;
+    return section;
+}
+
+namespace
+{
+// A section plus a one block border taken from the neighbouring sections and chunks
+constexpr int PaddedSize = SECTION_SIZE + 2;
+using PaddedBlocks = std::array<BlockId, PaddedSize * PaddedSize * PaddedSize>;
+
+constexpr int PaddedIndex(const int x, const int y, const int z)
+{
+    return (x + 1) + (z + 1) * PaddedSize + (y + 1) * PaddedSize * PaddedSize;
+}
+
+struct FaceDirection
+{
+    int Axis;    // Axis of the normal
+    int Sign;    // Direction of the normal along it
+    int Tangent; // Axes of the face plane, Tangent x Bitangent points along the normal
+    int Bitangent;
+};
+
+// clang-format off
+constexpr FaceDirection FaceDirections[6] = {
+    {0,  1, 1, 2}, // Right (+X)
+    {0, -1, 2, 1}, // Left (-X)
+    {1,  1, 2, 0}, // Top (+Y)
+    {1, -1, 0, 2}, // Bottom (-Y)
+    {2,  1, 0, 1}, // Front (+Z)
+    {2, -1, 1, 0}, // Back (-Z)
+};
+// clang-format on
+
+// Faces whose corners differ in occlusion are never merged, stretching their gradient over a larger quad would
+// change how they look
+constexpr uint32_t FaceNoMerge = 1u << 24;
+
+// Majority rule: the most common non-air block when at least half of the cell is filled, otherwise air. The cell
+// starts at the given block coordinates relative to the chunk, x and z may reach into the neighbouring chunks.
+BlockId DownsampleCell(const Chunk *const (&columns)[3][3], const int x, const int y, const int z, const int scale)
+{
+    std::array<std::pair<BlockId, int>, 8> counts;
+    size_t countCount = 0;
+    int filled = 0;
+    for (int by = y; by < y + scale; by++)
+    {
+        if (by < 0 || by >= CHUNK_HEIGHT)
+            continue;
+        for (int bz = z; bz < z + scale; bz++)
+        {
+            for (int bx = x; bx < x + scale; bx++)
+            {
+                const Chunk *column = columns[(bx >= 0) + (bx >= SECTION_SIZE)][(bz >= 0) + (bz >= SECTION_SIZE)];
+                const BlockId id = column ? column->GetBlock(bx & SECTION_MASK, by, bz & SECTION_MASK) : BLOCK_AIR;
+                if (id == BLOCK_AIR)
+                    continue;
+
+                filled++;
+                size_t i = 0;
+                while (i < countCount && counts[i].first != id)
+                    i++;
+                if (i == countCount)
+                {
+                    // Cells with more distinct blocks than this only tally the first ones
+                    if (countCount == counts.size())
+                        continue;
+                    counts[countCount++] = {id, 0};
+                }
+                counts[i].second++;
+            }
+        }
+    }
+
+    if (filled * 2 < scale * scale * scale)
+        return BLOCK_AIR;
+    return std::max_element(counts.begin(), counts.begin() + static_cast<std::ptrdiff_t>(countCount),
+                            [](const auto &a, const auto &b) { return a.second < b.second; })
+        ->first;
+}
+
+// Classic voxel AO: 0 is fully occluded, 3 is open
+uint8_t VertexAmbientOcclusion(const bool side1, const bool side2, const bool corner)
+{
+    if (side1 && side2)
+        return 0;
+    return static_cast<uint8_t>(3 - (side1 + side2 + corner));
+}
+
+struct MeshMetrics
+{
+    Counter &SectionsMeshed = Metrics::GetCounter("mesh.sections_meshed");
+    Counter &UploadBytes = Metrics::GetCounter("mesh.upload_bytes");
+};
+
+MeshMetrics &GetMeshMetrics()
+{
+    static MeshMetrics metrics;
+    return metrics;
+}
+} // namespace
+
+void ChunkMesh::Generate(const World &world, const Chunk &chunk, const bool (&skirts)[2][2])
+{
+    m_ChunkX = chunk.GetChunkX();
+    m_ChunkZ = chunk.GetChunkZ();
+
+    // Built in this thread's scratch, which is swapped with the mesh's buffers at the end
+    thread_local MeshData mesh;
+    mesh.Clear();
+
+    const BlockTypeRegistry &registry = world.GetBlockRegistry();
+
+    // Cells per section edge and blocks per cell edge at this level of detail
+    const int scale = 1 << m_Lod;
+    const int size = SECTION_SIZE / scale;
+
+    // This chunk and its eight neighbours, indexed [x + 1][z + 1]
+    const Chunk *columns[3][3];
+    for (int dx = -1; dx <= 1; dx++)
+    {
+        for (int dz = -1; dz <= 1; dz++)
+            columns[dx + 1][dz + 1] = dx == 0 && dz == 0 ? &chunk : world.GetChunk(m_ChunkX + dx, m_ChunkZ + dz);
+    }
+
+    PaddedBlocks blocks;
+    std::array<uint32_t, SECTION_SIZE * SECTION_SIZE> faces;
+    uint64_t sectionsMeshed = 0;
+
+    for (int sectionIndex = 0; sectionIndex < CHUNK_SECTION_COUNT; sectionIndex++)
+    {
+        const ChunkSection *section = chunk.GetSection(sectionIndex);
+        if (!section || section->IsEmpty())
+            continue;
+        sectionsMeshed++;
+
+        // Gather the padded neighbourhood once, so the face and occlusion tests below are plain array reads. Coarser
+        // levels of detail gather a grid of downsampled cells, each covering scale^3 blocks.
+        const int sectionY = sectionIndex * SECTION_SIZE;
+        for (int y = -1; y <= size; y++)
+        {
+            for (int z = -1; z <= size; z++)
+            {
+                for (int x = -1; x <= size; x++)
+                {
+                    if (scale > 1)
+                    {
+                        blocks[PaddedIndex(x, y, z)] =
+                            DownsampleCell(columns, x * scale, sectionY + y * scale, z * scale, scale);
+                        continue;
+                    }
+
+                    const int worldY = sectionY + y;
+                    const Chunk *column = columns[(x >= 0) + (x >= SECTION_SIZE)][(z >= 0) + (z >= SECTION_SIZE)];
+                    blocks[PaddedIndex(x, y, z)] = column && worldY >= 0 && worldY < CHUNK_HEIGHT
+                                                       ? column->GetBlock(x & SECTION_MASK, worldY, z & SECTION_MASK)
+                                                       : BLOCK_AIR;
+                }
+            }
+        }
+
+        auto isOpaque = [&](const glm::ivec3 &p) { return !registry.IsTransparent(blocks[PaddedIndex(p.x, p.y, p.z)]); };
+
+        // Faces of transparent blocks go into a separate list for this section, sorted and drawn after the opaque ones
+        TranslucentSection *translucent = nullptr;
+
+        const glm::vec3 sectionOrigin(m_ChunkX * CHUNK_WIDTH, sectionY, m_ChunkZ * CHUNK_DEPTH);
+        for (const FaceDirection &direction : FaceDirections)
+        {
+            glm::ivec3 normal(0);
+            normal[direction.Axis] = direction.Sign;
+            glm::ivec3 tangent(0), bitangent(0);
+            tangent[direction.Tangent] = 1;
+            bitangent[direction.Bitangent] = 1;
+
+            for (int layer = 0; layer < size; layer++)
+            {
+                // Collect the visible faces of this layer, keyed by block and occlusion
+                for (int b = 0; b < size; b++)
+                {
+                    for (int t = 0; t < size; t++)
+                    {
+                        glm::ivec3 position;
+                        position[direction.Axis] = layer;
+                        position[direction.Tangent] = t;
+                        position[direction.Bitangent] = b;
+
+                        uint32_t &face = faces[t + b * size];
+                        face = 0;
+
+                        const BlockId id = blocks[PaddedIndex(position.x, position.y, position.z)];
+                        const glm::ivec3 front = position + normal;
+                        const BlockId neighbour = blocks[PaddedIndex(front.x, front.y, front.z)];
+                        if (id == BLOCK_AIR || neighbour == id)
+                            continue;
+                        if (!registry.IsTransparent(neighbour))
+                        {
+                            // Skirt: towards a neighbour at another level of detail the side faces just below its
+                            // surface are kept, they cover the cracks between the two approximations of the terrain
+                            const int side = direction.Axis == 0 ? 0 : 1;
+                            if (direction.Axis == 1 || !skirts[side][direction.Sign > 0] ||
+                                (front[direction.Axis] >= 0 && front[direction.Axis] < size) ||
+                                registry.IsTransparent(id) ||
+                                !registry.IsTransparent(blocks[PaddedIndex(front.x, front.y + 1, front.z)]))
+                                continue;
+                        }
+
+                        // Corners in quad order: (-t, -b), (+t, -b), (+t, +b), (-t, +b)
+                        constexpr int cornerSigns[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+                        uint32_t occlusion = 0;
+                        for (int corner = 0; corner < 4; corner++)
+                        {
+                            const glm::ivec3 side1 = front + tangent * cornerSigns[corner][0];
+                            const glm::ivec3 side2 = front + bitangent * cornerSigns[corner][1];
+                            const glm::ivec3 diagonal = side1 + bitangent * cornerSigns[corner][1];
+                            occlusion |= VertexAmbientOcclusion(isOpaque(side1), isOpaque(side2), isOpaque(diagonal))
+                                         << (corner * 2);
+                        }
+
+                        face = id | occlusion << 16;
+                        const uint32_t first = occlusion & 3;
+                        if (occlusion != (first | first << 2 | first << 4 | first << 6))
+                            face |= FaceNoMerge;
+                    }
+                }
+
+                // Greedy merge of equal faces into rectangles
+                for (int b = 0; b < size; b++)
+                {
+                    for (int t = 0; t < size;)
+                    {
+                        const uint32_t face = faces[t + b * size];
+                        if (!face)
+                        {
+                            t++;
+                            continue;
+                        }
+
+                        int width = 1;
+                        int height = 1;
+                        if (!(face & FaceNoMerge))
+                        {
+                            while (t + width < size && faces[t + width + b * size] == face)
+                                width++;
+
+                            for (bool rowMatches = true; rowMatches && b + height < size;)
+                            {
+                                for (int i = 0; i < width && rowMatches; i++)
+                                    rowMatches = faces[t + i + (b + height) * size] == face;
+                                if (rowMatches)
+                                    height++;
+                            }
+                        }
+
+                        for (int j = 0; j < height; j++)
+                        {
+                            for (int i = 0; i < width; i++)
+                                faces[t + i + (b + j) * size] = 0;
+                        }
+
+                        glm::vec3 base = sectionOrigin;
+                        base[direction.Axis] += static_cast<float>((layer + (direction.Sign > 0 ? 1 : 0)) * scale);
+                        base[direction.Tangent] += static_cast<float>(t * scale);
+                        base[direction.Bitangent] += static_cast<float>(b * scale);
+                        const glm::vec3 tangentEdge = glm::vec3(tangent) * static_cast<float>(width * scale);
+                        const glm::vec3 bitangentEdge = glm::vec3(bitangent) * static_cast<float>(height * scale);
+
+                        std::vector<GLuint> *indices = &mesh.Indices;
+                        if (registry.IsTransparent(static_cast<BlockId>(face & 0xFFFF)))
+                        {
+                            if (!translucent)
+                                translucent = &mesh.AddTranslucent(sectionIndex);
+                            translucent->QuadCenters.push_back(base + (tangentEdge + bitangentEdge) * 0.5f);
+                            indices = &translucent->QuadIndices;
+                        }
+
+                        const uint32_t occlusion = face >> 16;
+                        AddQuad(mesh, *indices,
+                                {base, base + tangentEdge, base + tangentEdge + bitangentEdge, base + bitangentEdge},
+                                glm::vec3(normal), glm::vec3(tangent), glm::vec3(bitangent),
+                                glm::vec2(static_cast<float>(width * scale), static_cast<float>(height * scale)),
+                                {static_cast<uint8_t>(occlusion & 3), static_cast<uint8_t>(occlusion >> 2 & 3),
+                                 static_cast<uint8_t>(occlusion >> 4 & 3), static_cast<uint8_t>(occlusion >> 6 & 3)});
+                        t += width;
+                    }
+                }
+            }
+        }
+    }
+
+    // Drawn in mesh order until the first sort
+    size_t indexOffset = mesh.Indices.size();
+    for (TranslucentSection &section : mesh.GetTranslucent())
+    {
+        section.Indices = section.QuadIndices;
+        section.IndexOffset = indexOffset;
+        indexOffset += section.Indices.size();
+    }
+
+    std::swap(m_Mesh, mesh);
+    m_NeedsUpload = true;
+    GetMeshMetrics().SectionsMeshed.Add(sectionsMeshed);
+}
+
+bool ChunkMesh::Draw()
+{
+    if (m_NeedsUpload)
+        SetupMesh();
+    if (m_IndexCount == 0)
+        return false;
+
+    glBindVertexArray(m_VAO);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_IndexCount), GL_UNSIGNED_INT, nullptr);
+    glBindVertexArray(0);
+    return true;
+}
+
+int ChunkMesh::SortTranslucent(const glm::vec3 &cameraPosition)
+{
+    int sortedCount = 0;
+    const glm::ivec3 cameraVoxel(glm::floor(cameraPosition));
+    for (TranslucentSection &section : m_Mesh.GetTranslucent())
+    {
+        // The camera voxel relative to the section, clamped to just outside it: past the bounds the camera is on the
+        // same side of every quad plane in the section, moving further away doesn't need a re-sort
+        const glm::ivec3 origin(m_ChunkX * CHUNK_WIDTH, section.SectionIndex * SECTION_SIZE, m_ChunkZ * CHUNK_DEPTH);
+        glm::ivec3 voxel;
+        for (int axis = 0; axis < 3; axis++)
+            voxel[axis] = std::clamp(cameraVoxel[axis] - origin[axis], -1, SECTION_SIZE);
+        if (voxel == section.SortVoxel)
+            continue;
+        section.SortVoxel = voxel;
+
+        section.Order.clear();
+        for (size_t quad = 0; quad < section.QuadCenters.size(); quad++)
+        {
+            const glm::vec3 offset = section.QuadCenters[quad] - cameraPosition;
+            section.Order.emplace_back(glm::dot(offset, offset), static_cast<uint32_t>(quad));
+        }
+        std::ranges::sort(section.Order, std::greater{});
+
+        section.Indices.clear();
+        for (const uint32_t quad : section.Order | std::views::values)
+        {
+            const auto first = section.QuadIndices.begin() + quad * 6;
+            section.Indices.insert(section.Indices.end(), first, first + 6);
+        }
+        section.NeedsUpload = true;
+        sortedCount++;
+    }
+    return sortedCount;
+}
+
+int ChunkMesh::DrawTranslucent(const glm::vec3 &cameraPosition)
+{
+    if (!HasTranslucent())
+        return 0;
+    if (m_NeedsUpload)
+        SetupMesh();
+    else
+        UploadTranslucentIndices();
+
+    // Sections are stacked vertically, so far to near is by height distance to the camera
+    std::array<const TranslucentSection *, CHUNK_SECTION_COUNT> sections{};
+    size_t sectionCount = 0;
+    for (const TranslucentSection &section : m_Mesh.GetTranslucent())
+        sections[sectionCount++] = &section;
+    auto distance = [&cameraPosition](const TranslucentSection *section) {
+        return std::abs(static_cast<float>(section->SectionIndex * SECTION_SIZE + SECTION_SIZE / 2) - cameraPosition.y);
+    };
+    std::sort(sections.begin(), sections.begin() + static_cast<std::ptrdiff_t>(sectionCount),
+              [&distance](const TranslucentSection *a, const TranslucentSection *b) {
+                  return distance(a) > distance(b);
+              });
+
+    glBindVertexArray(m_VAO);
+    for (size_t i = 0; i < sectionCount; i++)
+    {
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(sections[i]->Indices.size()), GL_UNSIGNED_INT,
+                       reinterpret_cast<void *>(sections[i]->IndexOffset * sizeof(GLuint)));
+    }
+    glBindVertexArray(0);
+    return static_cast<int>(sectionCount);
+}
+
+void ChunkMesh::UploadTranslucentIndices()
+{
+    bool bound = false;
+    size_t uploadBytes = 0;
+    for (TranslucentSection &section : m_Mesh.GetTranslucent())
+    {
+        if (!section.NeedsUpload)
+            continue;
+
+        // The element buffer binding is part of the VAO
+        if (!bound)
+        {
+            glBindVertexArray(m_VAO);
+            bound = true;
+        }
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(section.IndexOffset * sizeof(GLuint)),
+                        static_cast<GLsizeiptr>(section.Indices.size() * sizeof(GLuint)), section.Indices.data());
+        uploadBytes += section.Indices.size() * sizeof(GLuint);
+        section.NeedsUpload = false;
+    }
+    if (bound)
+        glBindVertexArray(0);
+    GetMeshMetrics().UploadBytes.Add(uploadBytes);
+}
+
+void ChunkMesh::SetupMesh()
+{
+    m_NeedsUpload = false;
+    m_IndexCount = m_Mesh.Indices.size();
+
+    if (!m_VAO)
+    {
+        glGenVertexArrays(1, &m_VAO);
+        glGenBuffers(1, &m_VBO);
+        glGenBuffers(1, &m_EBO);
+
+        glBindVertexArray(m_VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+
+        // Same layout as Mesh
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Normal));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, TexCoords));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Tangent));
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Bitangent));
+        glEnableVertexAttribArray(5);
+        glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, AmbientOcclusion));
+    }
+    else
+    {
+        glBindVertexArray(m_VAO);
+    }
+
+    size_t indexCount = m_Mesh.Indices.size();
+    for (const TranslucentSection &section : m_Mesh.GetTranslucent())
+        indexCount += section.Indices.size();
+
+    // The buffers are only reallocated when the mesh outgrows them, with some headroom so a recycled chunk doesn't
+    // have to grow them again right away
+    auto reserve = [](const GLenum target, size_t &bufferSize, const size_t size) {
+        if (size <= bufferSize)
+            return;
+        bufferSize = size + size / 4;
+        glBufferData(target, static_cast<GLsizeiptr>(bufferSize), nullptr, GL_STATIC_DRAW);
+    };
+    const size_t vertexBytes = m_Mesh.Vertices.size() * sizeof(Vertex);
+    reserve(GL_ARRAY_BUFFER, m_VertexBufferSize, vertexBytes);
+    reserve(GL_ELEMENT_ARRAY_BUFFER, m_IndexBufferSize, indexCount * sizeof(GLuint));
+    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(vertexBytes), m_Mesh.Vertices.data());
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(m_Mesh.Indices.size() * sizeof(GLuint)),
+                    m_Mesh.Indices.data());
+    glBindVertexArray(0);
+    GetMeshMetrics().UploadBytes.Add(vertexBytes + m_Mesh.Indices.size() * sizeof(GLuint));
+
+    for (TranslucentSection &section : m_Mesh.GetTranslucent())
+        section.NeedsUpload = true;
+    UploadTranslucentIndices();
+}
+
+void ChunkMesh::AddQuad(MeshData &mesh, std::vector<GLuint> &indices, const std::array<glm::vec3, 4> &corners,
+                        const glm::vec3 &normal, const glm::vec3 &tangent, const glm::vec3 &bitangent,
+                        const glm::vec2 &size, const std::array<uint8_t, 4> &ambientOcclusion)
+{
+    // Texture coordinates span the quad in blocks, merged quads repeat the texture
+    const std::array<glm::vec2, 4> texCoords = {
+        glm::vec2(0.0f, 0.0f),
+        glm::vec2(size.x, 0.0f),
+        glm::vec2(size.x, size.y),
+        glm::vec2(0.0f, size.y),
+    };
+
+    const auto first = static_cast<GLuint>(mesh.Vertices.size());
+    for (int corner = 0; corner < 4; corner++)
+    {
+        Vertex vertex;
+        vertex.Position = corners[corner];
+        vertex.Normal = normal;
+        vertex.TexCoords = texCoords[corner];
+        vertex.Tangent = tangent;
+        vertex.Bitangent = bitangent;
+        vertex.AmbientOcclusion = 0.25f + 0.25f * static_cast<float>(ambientOcclusion[corner]);
+        mesh.Vertices.push_back(vertex);
+    }
+
+    // Split along the darker diagonal, splitting along the lighter one makes the occlusion visibly anisotropic
+    if (ambientOcclusion[0] + ambientOcclusion[2] > ambientOcclusion[1] + ambientOcclusion[3])
+    {
+        indices.insert(indices.end(), {first, first + 1, first + 3, first + 1, first + 2, first + 3});
+    }
+    else
+    {
+        indices.insert(indices.end(), {first, first + 1, first + 2, first + 2, first + 3, first});
+    }
+}
+
+} // namespace BloxxEngine
@@ -6,14 +6,204 @@
 #include "DirWatcher.h"
 
 #ifdef __linux__
-#include <kqueue/sys/event.h>
-#else
-#include <event2/event.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
 #endif
 
-#include <sys/stat.h>
-#include <sys/utime.h>
-#include <unistd>
+#include <filesystem>
+#include <iostream>
+
+namespace BloxxEngine
+{
+
+DirWatcher::DirWatcher(std::string dir, const std::chrono::milliseconds debounce)
+    : m_Dir(std::move(dir)), m_Debounce(debounce)
+{
+    Create();
+}
+
+DirWatcher::~DirWatcher()
+{
+    Destroy();
+}
+
+std::vector<std::string> DirWatcher::PollFiles()
+{
+    std::vector<std::string> changes;
+    std::lock_guard lock(m_Mutex);
+    changes.swap(m_Ready);
+    return changes;
+}
+
+#ifdef __linux__
+
+namespace
+{
+constexpr uint32_t WatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE_SELF | IN_MOVE_SELF;
+}
+
+void DirWatcher::Create()
+{
+    m_Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_WakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_Inotify < 0 || m_WakeFD < 0)
+    {
+        std::cerr << "Failed to initialize inotify for " << m_Dir << std::endl;
+        return;
+    }
+
+    AddDir("", false);
+    m_Thread = std::thread(&DirWatcher::Run, this);
+}
+
+void DirWatcher::Destroy()
+{
+    if (m_Thread.joinable())
+    {
+        const uint64_t one = 1;
+        [[maybe_unused]] const auto written = write(m_WakeFD, &one, sizeof(one));
+        m_Thread.join();
+    }
+
+    if (m_Inotify >= 0)
+        close(m_Inotify);
+    if (m_WakeFD >= 0)
+        close(m_WakeFD);
+    m_Inotify = -1;
+    m_WakeFD = -1;
+}
+
+void DirWatcher::AddDir(const std::string &dir, const bool reportFiles)
+{
+    const std::string fullPath = dir.empty() ? m_Dir : m_Dir + "/" + dir;
+
+    const int wd = inotify_add_watch(m_Inotify, fullPath.c_str(), WatchMask | IN_ONLYDIR);
+    if (wd < 0)
+    {
+        std::cerr << "Failed to watch " << fullPath << std::endl;
+        return;
+    }
+    m_Watches[wd] = dir;
+
+    // inotify is not recursive, every sub directory needs its own watch. This walk only happens when a
+    // directory first appears, never to detect changes.
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(fullPath, error))
+    {
+        const std::string name = entry.path().filename().string();
+        const std::string child = dir.empty() ? name : dir + "/" + name;
+        if (entry.is_directory(error))
+            AddDir(child, reportFiles);
+        else if (reportFiles)
+            m_Pending[child] = Clock::now(); // Landed in a new directory before its watch existed
+    }
+}
+
+void DirWatcher::Run()
+{
+    pollfd fds[2] = {{m_Inotify, POLLIN, 0}, {m_WakeFD, POLLIN, 0}};
+
+    while (true)
+    {
+        // Sleep until something happens, or until the oldest pending change settles
+        const int timeout = m_Pending.empty() ? -1 : static_cast<int>(m_Debounce.count());
+        if (poll(fds, 2, timeout) < 0 && errno != EINTR)
+            break;
+
+        if (fds[1].revents & POLLIN)
+            break;
+
+        if (fds[0].revents & POLLIN)
+            ReadEvents();
+
+        FlushSettled();
+    }
+}
+
+void DirWatcher::ReadEvents()
+{
+    alignas(inotify_event) char buffer[4096];
+
+    while (true)
+    {
+        const ssize_t length = read(m_Inotify, buffer, sizeof(buffer));
+        if (length <= 0)
+            return;
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            const auto watch = m_Watches.find(event->wd);
+            if (watch == m_Watches.end())
+                continue;
+
+            if (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF))
+            {
+                if (event->mask & IN_IGNORED)
+                    m_Watches.erase(watch);
+                continue;
+            }
+            if (event->len == 0)
+                continue;
+
+            const std::string path = watch->second.empty() ? event->name : watch->second + "/" + event->name;
+            if (event->mask & IN_ISDIR)
+            {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                    AddDir(path, true);
+                continue;
+            }
+
+            // An empty file being created is not interesting yet, the IN_CLOSE_WRITE that follows is.
+            // Editors saving through a temporary file rename it away, which drops it again.
+            if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                m_Pending[path] = Clock::now();
+            else if (event->mask & IN_MOVED_FROM)
+                m_Pending.erase(path);
+        }
+    }
+}
+
+void DirWatcher::FlushSettled()
+{
+    const auto now = Clock::now();
+    std::vector<std::string> settled;
+
+    for (auto it = m_Pending.begin(); it != m_Pending.end();)
+    {
+        if (now - it->second >= m_Debounce)
+        {
+            settled.push_back(it->first);
+            it = m_Pending.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (settled.empty())
+        return;
+
+    std::lock_guard lock(m_Mutex);
+    m_Ready.insert(m_Ready.end(), settled.begin(), settled.end());
+}
+
+#else
+
+void DirWatcher::Create()
+{
+    std::cerr << "DirWatcher is not implemented on this platform, " << m_Dir << " will not be watched" << std::endl;
+}
+
+void DirWatcher::Destroy()
+{
+}
+
+#endif
 
-namespace BloxxEngine {
-} // BloxxEngine
\ No newline at end of file
+} // namespace BloxxEngine
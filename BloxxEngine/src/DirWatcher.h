@@ -4,19 +4,33 @@
  */
 
 #pragma once
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
-struct kevent;
-
 namespace BloxxEngine
 {
 
+/**
+ * Watches a directory tree for modified files on a background thread.
+ *
+ * Events are coalesced per file and only reported once the file has been quiet for the debounce interval, so an
+ * editor writing a file in several steps results in a single change. Only implemented on Linux (inotify), other
+ * platforms never report changes.
+ */
 class DirWatcher
 {
   public:
-    explicit DirWatcher(std::string dir);
+    explicit DirWatcher(std::string dir, std::chrono::milliseconds debounce = std::chrono::milliseconds(150));
+    ~DirWatcher();
 
+    /**
+     * Returns the settled changes since the last call, as paths relative to the watched directory using forward
+     * slashes. Does not touch the file system.
+     */
     std::vector<std::string> PollFiles();
 
     DirWatcher(DirWatcher &) = delete;
@@ -25,35 +39,28 @@ class DirWatcher
     DirWatcher &operator=(DirWatcher &&) = delete;
 
   private:
-    struct File
-    {
-        std::string Path;
-        std::string FileName;
-        time_t MTime;
-        bool IsDir;
-        std::vector<File> Children;
-        int FD = -1;
-    };
+    using Clock = std::chrono::steady_clock;
 
     void Create();
-    void AddDir(std::string dir);
     void Destroy();
 
-    void AddDir(File& file);
-    void PollFilesIn(std::vector<std::string>& changes, File& dir);
-    void Rescan(std::vector<std::string>& changes, File& dir);
+    void AddDir(const std::string &dir, bool reportFiles);
+    void Run();
+    void ReadEvents();
+    void FlushSettled();
 
-    void AddKEvent(File& file);
+    const std::string m_Dir;
+    const std::chrono::milliseconds m_Debounce;
 
-    void CloseFile(File& file);
+    int m_Inotify = -1;
+    int m_WakeFD = -1;
+    std::unordered_map<int, std::string> m_Watches; // Watch descriptor -> directory relative to m_Dir
+    std::unordered_map<std::string, Clock::time_point> m_Pending;
 
-    const std::string m_Dir;
-    bool m_Recursive = true;
-    bool m_CheckFiles = true;
-    std::vector<File> m_Dirs;
-    std::vector<kevent> m_Events;
-    int m_KQueue;
+    std::mutex m_Mutex;
+    std::vector<std::string> m_Ready;
 
+    std::thread m_Thread;
 };
 
 } // namespace BloxxEngine
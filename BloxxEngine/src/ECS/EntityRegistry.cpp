@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/ECS/EntityRegistry.h"
+
+#include <atomic>
+
+namespace BloxxEngine
+{
+
+uint32_t NextComponentTypeId()
+{
+    static std::atomic<uint32_t> nextId{0};
+    return nextId++;
+}
+
+Entity EntityRegistry::Create()
+{
+    if (m_FreeIndices.empty())
+    {
+        m_Generations.push_back(0);
+        return {static_cast<uint32_t>(m_Generations.size() - 1), 0};
+    }
+
+    // Destroy() already moved the generation on, old handles to this index stay dead
+    const uint32_t index = m_FreeIndices.back();
+    m_FreeIndices.pop_back();
+    return {index, m_Generations[index]};
+}
+
+void EntityRegistry::Destroy(const Entity entity)
+{
+    if (!IsAlive(entity))
+        return;
+
+    for (const auto &pool : m_Pools)
+    {
+        if (pool)
+            pool->Remove(entity.Index);
+    }
+    m_Generations[entity.Index]++;
+    m_FreeIndices.push_back(entity.Index);
+}
+
+bool EntityRegistry::IsAlive(const Entity entity) const
+{
+    return entity.Index < m_Generations.size() && m_Generations[entity.Index] == entity.Generation;
+}
+
+} // namespace BloxxEngine
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/ECS/SpatialGrid.h"
+#include "BloxxEngine/World/World.h"
+
+#include <cmath>
+#include <ranges>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+// Keys pack the cell coordinates as three signed 21 bit values
+constexpr int KeyCoordinateBits = 21;
+constexpr uint64_t KeyCoordinateMask = (1ull << KeyCoordinateBits) - 1;
+
+// Collects the matches, counting the ones that don't fit
+struct ResultWriter
+{
+    std::span<Entity> Results;
+    size_t Count = 0;
+
+    void Add(const Entity entity)
+    {
+        if (Count < Results.size())
+            Results[Count] = entity;
+        Count++;
+    }
+};
+} // namespace
+
+SpatialGrid::SpatialGrid(const float cellSize) : m_CellSize(cellSize), m_InverseCellSize(1.0f / cellSize)
+{
+}
+
+size_t SpatialGrid::CellKeyHash::operator()(const uint64_t key) const
+{
+    // Neighbouring cells differ in only a few bits, just like neighbouring chunks
+    return World::ChunkKeyHash{}(key);
+}
+
+glm::ivec3 SpatialGrid::ToCell(const glm::vec3 &position) const
+{
+    return glm::ivec3(glm::floor(position * m_InverseCellSize));
+}
+
+uint64_t SpatialGrid::CellKey(const glm::ivec3 &cell)
+{
+    return (static_cast<uint64_t>(cell.x) & KeyCoordinateMask) << (2 * KeyCoordinateBits) |
+           (static_cast<uint64_t>(cell.y) & KeyCoordinateMask) << KeyCoordinateBits |
+           (static_cast<uint64_t>(cell.z) & KeyCoordinateMask);
+}
+
+SpatialGrid::Cell &SpatialGrid::GetOrCreateCell(const glm::ivec3 &coordinate)
+{
+    Cell &cell = m_Cells[CellKey(coordinate)];
+    cell.Coordinate = coordinate;
+    return cell;
+}
+
+void SpatialGrid::AddToCell(Item &item, Cell &cell, const glm::vec3 &position)
+{
+    item.Owner = &cell;
+    item.Coordinate = cell.Coordinate;
+    item.Slot = static_cast<uint32_t>(cell.Entities.size());
+    cell.Entities.push_back(item.Handle);
+    cell.Positions.push_back(position);
+}
+
+void SpatialGrid::RemoveFromCell(const Item &item)
+{
+    // Swap the last entity of the cell into the gap
+    Cell &cell = *item.Owner;
+    const Entity last = cell.Entities.back();
+    cell.Entities[item.Slot] = last;
+    cell.Positions[item.Slot] = cell.Positions.back();
+    m_Items[last.Index].Slot = item.Slot;
+    cell.Entities.pop_back();
+    cell.Positions.pop_back();
+}
+
+void SpatialGrid::Insert(const Entity entity, const glm::vec3 &position)
+{
+    if (m_Items.size() <= entity.Index)
+        m_Items.resize(entity.Index + 1);
+
+    Item &item = m_Items[entity.Index];
+    if (item.Owner)
+        RemoveFromCell(item);
+    else
+        m_Count++;
+
+    item.Handle = entity;
+    item.Target = position;
+    item.Moved = false;
+    AddToCell(item, GetOrCreateCell(ToCell(position)), position);
+}
+
+void SpatialGrid::Remove(const Entity entity)
+{
+    if (!Contains(entity))
+        return;
+
+    Item &item = m_Items[entity.Index];
+    RemoveFromCell(item);
+    item = Item{};
+    m_Count--;
+}
+
+void SpatialGrid::Move(const Entity entity, const glm::vec3 &position)
+{
+    if (!Contains(entity))
+        return;
+
+    Item &item = m_Items[entity.Index];
+    item.Target = position;
+    item.Moved = true;
+}
+
+bool SpatialGrid::Contains(const Entity entity) const
+{
+    return entity.Index < m_Items.size() && m_Items[entity.Index].Owner && m_Items[entity.Index].Handle == entity;
+}
+
+void SpatialGrid::ApplyUpdates()
+{
+    m_LastCellChanges = 0;
+    for (Item &item : m_Items)
+    {
+        if (!item.Moved)
+            continue;
+        item.Moved = false;
+
+        // Most moves stay inside the cell and only update the position
+        const glm::ivec3 coordinate = ToCell(item.Target);
+        if (coordinate == item.Coordinate)
+        {
+            item.Owner->Positions[item.Slot] = item.Target;
+            continue;
+        }
+
+        RemoveFromCell(item);
+        AddToCell(item, GetOrCreateCell(coordinate), item.Target);
+        m_LastCellChanges++;
+    }
+}
+
+template <typename F> void SpatialGrid::ForEachCell(const glm::vec3 &min, const glm::vec3 &max, F &&visit) const
+{
+    const glm::ivec3 first = ToCell(min);
+    const glm::ivec3 last = ToCell(max);
+
+    // A box spanning more cells than exist is cheaper to answer by walking the cells
+    const auto boxCells = static_cast<uint64_t>(last.x - first.x + 1) * static_cast<uint64_t>(last.y - first.y + 1) *
+                          static_cast<uint64_t>(last.z - first.z + 1);
+    if (boxCells > m_Cells.size())
+    {
+        for (const Cell &cell : m_Cells | std::views::values)
+        {
+            const glm::ivec3 &c = cell.Coordinate;
+            if (c.x >= first.x && c.x <= last.x && c.y >= first.y && c.y <= last.y && c.z >= first.z && c.z <= last.z)
+                visit(cell);
+        }
+        return;
+    }
+
+    for (int y = first.y; y <= last.y; y++)
+    {
+        for (int z = first.z; z <= last.z; z++)
+        {
+            for (int x = first.x; x <= last.x; x++)
+            {
+                const auto it = m_Cells.find(CellKey(glm::ivec3(x, y, z)));
+                if (it != m_Cells.end())
+                    visit(it->second);
+            }
+        }
+    }
+}
+
+size_t SpatialGrid::QueryRadius(const glm::vec3 &center, const float radius, const std::span<Entity> results) const
+{
+    ResultWriter writer{results};
+    const float radiusSquared = radius * radius;
+    ForEachCell(center - radius, center + radius, [&](const Cell &cell) {
+        for (size_t i = 0; i < cell.Positions.size(); i++)
+        {
+            const glm::vec3 offset = cell.Positions[i] - center;
+            if (glm::dot(offset, offset) <= radiusSquared)
+                writer.Add(cell.Entities[i]);
+        }
+    });
+    return writer.Count;
+}
+
+size_t SpatialGrid::QueryBox(const glm::vec3 &min, const glm::vec3 &max, const std::span<Entity> results) const
+{
+    ResultWriter writer{results};
+    ForEachCell(min, max, [&](const Cell &cell) {
+        for (size_t i = 0; i < cell.Positions.size(); i++)
+        {
+            const glm::vec3 &p = cell.Positions[i];
+            if (p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z)
+                writer.Add(cell.Entities[i]);
+        }
+    });
+    return writer.Count;
+}
+
+size_t SpatialGrid::QueryFrustum(const Frustum &frustum, const float radius, const std::span<Entity> results) const
+{
+    ResultWriter writer{results};
+    for (const Cell &cell : m_Cells | std::views::values)
+    {
+        if (cell.Entities.empty())
+            continue;
+
+        // Cells are culled as a whole, grown by the radius so entities sticking out of them are kept
+        const glm::vec3 cellMin = glm::vec3(cell.Coordinate) * m_CellSize - radius;
+        const glm::vec3 cellMax = glm::vec3(cell.Coordinate + 1) * m_CellSize + radius;
+        if (!frustum.IntersectsBox(cellMin, cellMax))
+            continue;
+
+        for (size_t i = 0; i < cell.Positions.size(); i++)
+        {
+            if (frustum.IntersectsSphere(cell.Positions[i], radius))
+                writer.Add(cell.Entities[i]);
+        }
+    }
+    return writer.Count;
+}
+
+} // namespace BloxxEngine
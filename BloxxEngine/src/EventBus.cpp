@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/EventBus.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+// Room for every event type at the given per-type capacity, the events themselves are a few dozen bytes
+constexpr size_t MaxEventSize = 64;
+} // namespace
+
+EventBus::EventBus(const uint32_t eventsPerType)
+    : m_EventsPerType(eventsPerType),
+      m_Arenas{FrameArena(EventTypeCount * MaxEventSize * eventsPerType),
+               FrameArena(EventTypeCount * MaxEventSize * eventsPerType)}
+{
+}
+
+void EventBus::Dispatch()
+{
+    // Point new posts at the other arena, then wait for posts that started before the flip to land
+    const uint32_t frame = m_WriteFrame.load();
+    m_WriteFrame.store(frame ^ 1);
+    while (m_Writers[frame].load() != 0)
+        std::this_thread::yield();
+
+    for (const auto &channel : m_Channels)
+    {
+        if (!channel)
+            continue;
+
+        const uint32_t count = std::min(channel->Counts[frame].load(), m_EventsPerType);
+        if (count > 0)
+            channel->Deliver(*channel, channel->Buffers[frame], count);
+
+        channel->Counts[frame] = 0;
+    }
+}
+
+} // namespace BloxxEngine
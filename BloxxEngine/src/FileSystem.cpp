@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/FileSystem.h"
+
+#include "AssetArchive.h"
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+struct MountedArchive
+{
+    std::string MountPoint; // Always ends with '/'
+    AssetArchive Archive;
+};
+
+std::vector<std::unique_ptr<MountedArchive>> s_Mounts;
+
+std::string NormalizePath(std::string path)
+{
+    for (char &c : path)
+    {
+        if (c == '\\')
+            c = '/';
+    }
+    while (path.starts_with("./"))
+        path.erase(0, 2);
+    return path;
+}
+
+/**
+ * Finds the archive entry serving the given path, stripping the mount point prefix.
+ */
+const AssetArchiveEntry *Resolve(const std::string &path, const AssetArchive **archive)
+{
+    const std::string normalized = NormalizePath(path);
+
+    for (const auto &mount : s_Mounts)
+    {
+        if (!normalized.starts_with(mount->MountPoint))
+            continue;
+
+        const std::string_view relative = std::string_view(normalized).substr(mount->MountPoint.size());
+        if (const AssetArchiveEntry *entry = mount->Archive.FindEntry(relative))
+        {
+            *archive = &mount->Archive;
+            return entry;
+        }
+    }
+    return nullptr;
+}
+} // namespace
+
+bool FileSystem::Mount(const std::string &mountPoint, const std::string &archivePath)
+{
+    auto mount = std::make_unique<MountedArchive>();
+    mount->MountPoint = NormalizePath(mountPoint);
+    if (!mount->MountPoint.empty() && !mount->MountPoint.ends_with('/'))
+        mount->MountPoint += '/';
+
+    if (!mount->Archive.Open(archivePath))
+        return false;
+
+    std::cout << "Mounted " << archivePath << " at " << mount->MountPoint << std::endl;
+    s_Mounts.push_back(std::move(mount));
+    return true;
+}
+
+void FileSystem::UnmountAll()
+{
+    s_Mounts.clear();
+}
+
+std::optional<std::string_view> FileSystem::FindText(const std::string &path)
+{
+    const AssetArchive *archive = nullptr;
+    const AssetArchiveEntry *entry = Resolve(path, &archive);
+    if (!entry || entry->Kind == AssetKind::Texture)
+        return std::nullopt;
+
+    const auto data = archive->GetData(*entry);
+    return std::string_view(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+bool FileSystem::FindImage(const std::string &path, Image &image)
+{
+    const AssetArchive *archive = nullptr;
+    const AssetArchiveEntry *entry = Resolve(path, &archive);
+    if (!entry)
+        return false;
+
+    return archive->GetImage(*entry, image);
+}
+
+bool FileSystem::FindMesh(const std::string &path, CookedMesh &mesh)
+{
+    const AssetArchive *archive = nullptr;
+    const AssetArchiveEntry *entry = Resolve(path, &archive);
+    if (!entry)
+        return false;
+
+    return archive->GetMesh(*entry, mesh);
+}
+
+std::optional<std::string> FileSystem::ReadFile(const std::string &path)
+{
+    if (const auto text = FindText(path))
+        return std::string(*text);
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return std::nullopt;
+
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+} // namespace BloxxEngine
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/InputRecording.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+constexpr uint32_t INPUT_FILE_MAGIC = 0x52495842; // "BXIR"
+constexpr uint32_t INPUT_FILE_VERSION = 1;
+
+/**
+ * An input file is the header followed by InputCount inputs. Each input is its time in seconds as a float and its
+ * type byte, then a repeat byte and a 16 bit code for keys and buttons, or two float offsets for the mouse.
+ */
+#pragma pack(push, 1)
+struct InputFileCamera
+{
+    float Position[3];
+    float Yaw, Pitch, Zoom;
+};
+
+struct InputFileHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t WorldSeed;
+    uint32_t InputCount;
+    double Duration;
+    InputFileCamera StartCamera;
+    InputFileCamera EndCamera;
+};
+#pragma pack(pop)
+
+InputFileCamera ToFile(const CameraState &camera)
+{
+    return {{camera.Position.x, camera.Position.y, camera.Position.z}, camera.Yaw, camera.Pitch, camera.Zoom};
+}
+
+CameraState FromFile(const InputFileCamera &camera)
+{
+    return {{camera.Position[0], camera.Position[1], camera.Position[2]}, camera.Yaw, camera.Pitch, camera.Zoom};
+}
+
+bool IsMouseInput(const RecordedInputType type)
+{
+    return type == RecordedInputType::MouseMoved || type == RecordedInputType::MouseScrolled;
+}
+
+template <typename T> void Append(std::vector<char> &buffer, const T &value)
+{
+    const size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+template <typename T> bool Read(const std::vector<char> &data, size_t &offset, T &value)
+{
+    if (data.size() - offset < sizeof(T))
+        return false;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+// Nearest rank, frameTimes has to be sorted
+double Percentile(const std::vector<float> &frameTimes, const double percentile)
+{
+    const auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(frameTimes.size())));
+    return frameTimes[std::clamp<size_t>(rank, 1, frameTimes.size()) - 1];
+}
+
+} // namespace
+
+void InputRecording::Start(const uint32_t worldSeed, const CameraState &camera)
+{
+    m_Inputs.clear();
+    m_WorldSeed = worldSeed;
+    m_StartCamera = camera;
+    m_EndCamera = camera;
+    m_Duration = 0.0;
+    m_MergeMouse = false;
+}
+
+void InputRecording::Add(const RecordedInput &input)
+{
+    if (m_MergeMouse && input.Type == RecordedInputType::MouseMoved &&
+        m_Inputs.back().Type == RecordedInputType::MouseMoved)
+    {
+        m_Inputs.back().Offset += input.Offset;
+        return;
+    }
+    m_Inputs.push_back(input);
+    m_MergeMouse = input.Type == RecordedInputType::MouseMoved;
+}
+
+void InputRecording::Finish(const double duration, const CameraState &camera)
+{
+    m_Duration = duration;
+    m_EndCamera = camera;
+}
+
+bool InputRecording::Save(const std::filesystem::path &path) const
+{
+    std::vector<char> buffer;
+    buffer.reserve(sizeof(InputFileHeader) + m_Inputs.size() * 13);
+    Append(buffer, InputFileHeader{INPUT_FILE_MAGIC, INPUT_FILE_VERSION, m_WorldSeed,
+                                   static_cast<uint32_t>(m_Inputs.size()), m_Duration, ToFile(m_StartCamera),
+                                   ToFile(m_EndCamera)});
+    for (const RecordedInput &input : m_Inputs)
+    {
+        Append(buffer, static_cast<float>(input.Time));
+        Append(buffer, input.Type);
+        if (IsMouseInput(input.Type))
+        {
+            Append(buffer, input.Offset.x);
+            Append(buffer, input.Offset.y);
+        }
+        else
+        {
+            Append(buffer, static_cast<uint8_t>(input.Repeat));
+            Append(buffer, static_cast<int16_t>(input.Code));
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.close();
+    if (!file)
+    {
+        std::cerr << "Failed writing input recording " << path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool InputRecording::Load(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Input recording " << path.string() << " not found" << std::endl;
+        return false;
+    }
+    const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    InputFileHeader header{};
+    size_t offset = 0;
+    bool valid = Read(data, offset, header) && header.Magic == INPUT_FILE_MAGIC &&
+                 header.Version == INPUT_FILE_VERSION && std::isfinite(header.Duration) && header.Duration >= 0.0;
+
+    std::vector<RecordedInput> inputs;
+    for (uint32_t i = 0; valid && i < header.InputCount; i++)
+    {
+        float time;
+        RecordedInput input;
+        valid = Read(data, offset, time) && std::isfinite(time) && Read(data, offset, input.Type) &&
+                input.Type <= RecordedInputType::MouseScrolled;
+        if (!valid)
+            break;
+        input.Time = time;
+
+        if (IsMouseInput(input.Type))
+        {
+            valid = Read(data, offset, input.Offset.x) && Read(data, offset, input.Offset.y) &&
+                    std::isfinite(input.Offset.x) && std::isfinite(input.Offset.y);
+        }
+        else
+        {
+            uint8_t repeat;
+            int16_t code;
+            valid = Read(data, offset, repeat) && Read(data, offset, code);
+            input.Repeat = repeat != 0;
+            input.Code = code;
+        }
+        // Replays hand the inputs out in order
+        valid &= inputs.empty() || input.Time >= inputs.back().Time;
+        inputs.push_back(input);
+    }
+    valid &= offset == data.size();
+
+    if (!valid)
+    {
+        std::cerr << "Input recording " << path.string() << " is damaged" << std::endl;
+        return false;
+    }
+
+    m_Inputs = std::move(inputs);
+    m_WorldSeed = header.WorldSeed;
+    m_StartCamera = FromFile(header.StartCamera);
+    m_EndCamera = FromFile(header.EndCamera);
+    m_Duration = header.Duration;
+    m_MergeMouse = false;
+    return true;
+}
+
+InputReplay::InputReplay(InputRecording recording, const float fixedDeltaTime)
+    : m_Recording(std::move(recording)), m_FixedDeltaTime(fixedDeltaTime)
+{
+}
+
+std::span<const RecordedInput> InputReplay::Advance()
+{
+    // Counted in steps, so the replay clock doesn't drift from adding up the timestep
+    m_Step++;
+    const double time = static_cast<double>(m_Step) * m_FixedDeltaTime;
+
+    const std::span<const RecordedInput> inputs = m_Recording.GetInputs();
+    const size_t first = m_NextInput;
+    while (m_NextInput < inputs.size() && inputs[m_NextInput].Time < time)
+        m_NextInput++;
+    return inputs.subspan(first, m_NextInput - first);
+}
+
+bool InputReplay::IsFinished() const
+{
+    return m_NextInput == m_Recording.GetInputs().size() &&
+           static_cast<double>(m_Step) * m_FixedDeltaTime >= m_Recording.GetDuration();
+}
+
+void InputReplay::AddFrameTime(const float frameTime)
+{
+    m_FrameTimes.push_back(frameTime * 1000.0f);
+    m_FrameReplayTimes.push_back(static_cast<double>(m_Step) * m_FixedDeltaTime);
+}
+
+InputReplay::Summary InputReplay::GetSummary() const
+{
+    Summary summary;
+    summary.Frames = m_FrameTimes.size();
+    if (m_FrameTimes.empty())
+        return summary;
+
+    std::vector<float> sorted = m_FrameTimes;
+    std::ranges::sort(sorted);
+    double sum = 0.0;
+    for (const float frameTime : sorted)
+        sum += frameTime;
+    summary.Mean = sum / static_cast<double>(sorted.size());
+    summary.P95 = Percentile(sorted, 95.0);
+    summary.P99 = Percentile(sorted, 99.0);
+    summary.Max = sorted.back();
+    return summary;
+}
+
+bool InputReplay::WriteFrameLog(const std::filesystem::path &path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    file << "frame,replay_time,frame_ms\n";
+    for (size_t i = 0; i < m_FrameTimes.size(); i++)
+        file << i << ',' << m_FrameReplayTimes[i] << ',' << m_FrameTimes[i] << '\n';
+    file.close();
+    if (!file)
+    {
+        std::cerr << "Failed writing frame log " << path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace BloxxEngine
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/InputState.h"
+
+namespace BloxxEngine
+{
+
+void InputState::OnKey(const int key, const bool down, const double time)
+{
+    // GLFW_KEY_UNKNOWN is -1
+    if (key < 0 || key > GLFW_KEY_LAST)
+        return;
+
+    m_State.Keys.set(key, down);
+    MarkArrival(time);
+}
+
+void InputState::OnMouseButton(const int button, const bool down, const double time)
+{
+    if (button < 0 || button > GLFW_MOUSE_BUTTON_LAST)
+        return;
+
+    m_State.Buttons.set(button, down);
+    MarkArrival(time);
+}
+
+void InputState::OnMouseMoved(const float offsetX, const float offsetY, const double time)
+{
+    m_State.MouseDelta += glm::vec2(offsetX, offsetY);
+    MarkArrival(time);
+}
+
+void InputState::OnMouseScrolled(const float offsetX, const float offsetY, const double time)
+{
+    m_State.ScrollDelta += glm::vec2(offsetX, offsetY);
+    MarkArrival(time);
+}
+
+InputSnapshot InputState::Sample(const double time)
+{
+    m_State.SampleTime = time;
+    InputSnapshot snapshot = m_State;
+
+    m_State.MouseDelta = glm::vec2(0.0f);
+    m_State.ScrollDelta = glm::vec2(0.0f);
+    m_State.HasInput = false;
+    return snapshot;
+}
+
+void InputState::MarkArrival(const double time)
+{
+    if (m_State.HasInput)
+        return;
+
+    m_State.HasInput = true;
+    m_State.InputTime = time;
+}
+
+} // namespace BloxxEngine
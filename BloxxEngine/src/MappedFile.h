@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace BloxxEngine
+{
+
+/**
+ * Read-only memory mapping of a whole file.
+ */
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    MappedFile &operator=(MappedFile &) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+
+    bool Open(const std::string &path);
+    void Close();
+
+    [[nodiscard]] const std::byte *GetData() const
+    {
+        return m_Data;
+    }
+    [[nodiscard]] size_t GetSize() const
+    {
+        return m_Size;
+    }
+    [[nodiscard]] bool IsOpen() const
+    {
+        return m_Data != nullptr;
+    }
+
+  private:
+    const std::byte *m_Data = nullptr;
+    size_t m_Size = 0;
+
+#ifdef _WIN32
+    void *m_File = nullptr;
+    void *m_Mapping = nullptr;
+#else
+    int m_FD = -1;
+#endif
+};
+
+} // namespace BloxxEngine
@@ -5,50 +5,26 @@
 
 #include "BloxxEngine/Mesh.h"
 
+#include "BloxxEngine/FileSystem.h"
+#include "BloxxEngine/TangentSpace.h"
+
 #include <iostream>
 
 namespace BloxxEngine
 {
-Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices)
-    : m_VAO(0), m_VBO(0), m_EBO(0), m_IndexCount(indices.size()), m_Vertices(vertices), m_Indices(indices)
-{
-    CalculateTangentsAndBitangents();
-    SetupMesh();
-}
 
-Mesh::~Mesh()
+namespace
 {
-    glDeleteVertexArrays(1, &m_VAO);
-    glDeleteBuffers(1, &m_VBO);
-    glDeleteBuffers(1, &m_EBO);
-}
+// Triangles per batch when computing tangents on the thread pool
+constexpr size_t TangentGrainSize = 4096;
+} // namespace
 
-void Mesh::SetupMesh()
+Mesh::Mesh(std::vector<Vertex> vertices, std::vector<GLuint> indices, ThreadPool *threadPool)
+    : m_IndexCount(indices.size())
 {
-    std::cout << "Size of Vertex: " << sizeof(Vertex) << std::endl;
-    std::cout << "Offset of Position: " << offsetof(Vertex, Position) << std::endl;
-    std::cout << "Offset of Normal: " << offsetof(Vertex, Normal) << std::endl;
-    std::cout << "Offset of TexCoords: " << offsetof(Vertex, TexCoords) << std::endl;
-    std::cout << "Offset of Tangent: " << offsetof(Vertex, Tangent) << std::endl;
-    std::cout << "Offset of Bitangent: " << offsetof(Vertex, Bitangent) << std::endl;
-
-    // Generate buffers and arrays
-    glGenVertexArrays(1, &m_VAO);
-    glGenBuffers(1, &m_VBO);
-    glGenBuffers(1, &m_EBO);
-
-    // Bind VAO
-    glBindVertexArray(m_VAO);
+    CalculateTangentsAndBitangents(vertices, indices, threadPool);
+    CreateBuffers(vertices.data(), vertices.size() * sizeof(Vertex), indices.data(), indices.size() * sizeof(GLuint));
 
-    // Vertex buffer
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, m_Vertices.size() * sizeof(Vertex), m_Vertices.data(), GL_STATIC_DRAW);
-
-    // Element buffer
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size() * sizeof(GLuint), m_Indices.data(), GL_STATIC_DRAW);
-
-    // Vertex attributes
     // Position (location = 0)
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Position));
@@ -64,65 +40,131 @@ void Mesh::SetupMesh()
     // Bitangent (location = 4)
     glEnableVertexAttribArray(4);
     glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Bitangent));
+    // Ambient occlusion (location = 5)
+    glEnableVertexAttribArray(5);
+    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, AmbientOcclusion));
+
+    glBindVertexArray(0);
+}
 
+Mesh::Mesh(const CookedMesh &mesh) : m_IndexCount(mesh.IndexCount)
+{
+    m_IndexType = mesh.IndexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    CreateBuffers(mesh.Vertices, mesh.VertexCount * sizeof(PackedMeshVertex), mesh.Indices,
+                  mesh.IndexCount * static_cast<size_t>(mesh.IndexSize));
+
+    // Same locations as the float layout, the normalised attributes arrive in the shader as floats
+    constexpr GLsizei stride = sizeof(PackedMeshVertex);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(PackedMeshVertex, Position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void *)offsetof(PackedMeshVertex, Normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void *)offsetof(PackedMeshVertex, TexCoords));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void *)offsetof(PackedMeshVertex, Tangent));
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride,
+                          (void *)offsetof(PackedMeshVertex, Bitangent));
+    glEnableVertexAttribArray(5);
+    glVertexAttribPointer(5, 1, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          (void *)offsetof(PackedMeshVertex, AmbientOcclusion));
 
-    // Unbind VAO
     glBindVertexArray(0);
+}
+
+Mesh::~Mesh()
+{
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteBuffers(1, &m_VBO);
+    glDeleteBuffers(1, &m_EBO);
+}
+
+std::unique_ptr<Mesh> Mesh::Load(const std::string &path)
+{
+    CookedMesh mesh;
+    if (!FileSystem::FindMesh(path, mesh))
+    {
+        std::cerr << "Failed to load mesh " << path << std::endl;
+        return nullptr;
+    }
+    return std::make_unique<Mesh>(mesh);
+}
 
-    std::cout << "Index Count: " << m_IndexCount << std::endl;
+void Mesh::CreateBuffers(const void *vertices, const size_t vertexBytes, const void *indices,
+                         const size_t indexBytes)
+{
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+    glGenBuffers(1, &m_EBO);
+
+    // Left bound for the attribute setup
+    glBindVertexArray(m_VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexBytes), vertices, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexBytes), indices, GL_STATIC_DRAW);
 }
 
 void Mesh::Draw() const
 {
     glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, m_IndexCount, GL_UNSIGNED_INT, nullptr);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_IndexCount), m_IndexType, nullptr);
     glBindVertexArray(0);
 }
-void Mesh::CalculateTangentsAndBitangents() {
-   // Iterate over each triangle
-    for (size_t i = 0; i < m_Indices.size(); i += 3) {
-        Vertex& v0 = m_Vertices[m_Indices[i]];
-        Vertex& v1 = m_Vertices[m_Indices[i + 1]];
-        Vertex& v2 = m_Vertices[m_Indices[i + 2]];
-
-        // Positions
-        glm::vec3& p0 = v0.Position;
-        glm::vec3& p1 = v1.Position;
-        glm::vec3& p2 = v2.Position;
-
-        // Texture coordinates
-        glm::vec2& uv0 = v0.TexCoords;
-        glm::vec2& uv1 = v1.TexCoords;
-        glm::vec2& uv2 = v2.TexCoords;
-
-        // Edges of the triangle : position delta
-        glm::vec3 deltaPos1 = p1 - p0;
-        glm::vec3 deltaPos2 = p2 - p0;
-
-        // UV delta
-        glm::vec2 deltaUV1 = uv1 - uv0;
-        glm::vec2 deltaUV2 = uv2 - uv0;
-
-        float r = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV1.y * deltaUV2.x);
-        glm::vec3 tangent = (deltaPos1 * deltaUV2.y - deltaPos2 * deltaUV1.y) * r;
-        glm::vec3 bitangent = (deltaPos2 * deltaUV1.x - deltaPos1 * deltaUV2.x) * r;
-
-        // Accumulate tangents and bitangents
-        v0.Tangent += tangent;
-        v1.Tangent += tangent;
-        v2.Tangent += tangent;
-
-        v0.Bitangent += bitangent;
-        v1.Bitangent += bitangent;
-        v2.Bitangent += bitangent;
 
+void Mesh::CalculateTangentsAndBitangents(const std::span<Vertex> vertices, const std::span<const GLuint> indices,
+                                          ThreadPool *threadPool)
+{
+    auto run = [threadPool](const size_t count, auto &&func) {
+        if (threadPool)
+            threadPool->ParallelFor(count, TangentGrainSize, func);
+        else
+            func(size_t{0}, count);
+    };
+
+    // The frames of the triangles go to their own arrays first, so the batches never write to a shared vertex
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<glm::vec3> tangents(triangleCount);
+    std::vector<glm::vec3> bitangents(triangleCount);
+    run(triangleCount, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            const Vertex &v0 = vertices[indices[i * 3]];
+            const Vertex &v1 = vertices[indices[i * 3 + 1]];
+            const Vertex &v2 = vertices[indices[i * 3 + 2]];
+            TriangleTangents(v0.Position, v1.Position, v2.Position, v0.TexCoords, v1.TexCoords, v2.TexCoords,
+                             tangents[i], bitangents[i]);
+        }
+    });
+
+    // Summing them per vertex is a cheap scatter, left on this thread
+    for (Vertex &vertex : vertices)
+    {
+        vertex.Tangent = glm::vec3(0.0f);
+        vertex.Bitangent = glm::vec3(0.0f);
     }
-
-    // Normalize the tangents and bitangents
-    for (auto& vertex : m_Vertices) {
-        vertex.Tangent = glm::normalize(vertex.Tangent);
-        vertex.Bitangent = glm::normalize(vertex.Bitangent);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+    {
+        Vertex &vertex = vertices[indices[i]];
+        vertex.Tangent = vertex.Tangent + tangents[i / 3];
+        vertex.Bitangent = vertex.Bitangent + bitangents[i / 3];
     }
+
+    run(vertices.size(), [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            // Vertex is packed, its members can't be bound to references
+            Vertex &vertex = vertices[i];
+            glm::vec3 tangent = vertex.Tangent;
+            glm::vec3 bitangent = vertex.Bitangent;
+            OrthonormalizeTangentFrame(vertex.Normal, tangent, bitangent);
+            vertex.Tangent = tangent;
+            vertex.Bitangent = bitangent;
+        }
+    });
 }
 
-} // namespace BloxxEngine
\ No newline at end of file
+} // namespace BloxxEngine
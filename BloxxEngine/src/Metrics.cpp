@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+
+// Samples kept per metric for the sparklines
+constexpr size_t HISTORY_SIZE = 120;
+
+struct MetricEntry
+{
+    std::string Name;
+    MetricKind Kind;
+    std::unique_ptr<Counter> CounterMetric;
+    std::unique_ptr<Gauge> GaugeMetric;
+    std::unique_ptr<Histogram> HistogramMetric;
+
+    std::vector<float> History = std::vector<float>(HISTORY_SIZE, 0.0f);
+    // Totals at the previous sample, for the increases since
+    uint64_t SampledCount = 0;
+    double SampledSum = 0.0;
+
+    [[nodiscard]] double GetValue() const
+    {
+        switch (Kind)
+        {
+        case MetricKind::Counter:
+            return static_cast<double>(CounterMetric->Get());
+        case MetricKind::Gauge:
+            return GaugeMetric->Get();
+        case MetricKind::Histogram: {
+            const uint64_t count = HistogramMetric->GetCount();
+            return count ? HistogramMetric->GetSum() / static_cast<double>(count) : 0.0;
+        }
+        }
+        return 0.0;
+    }
+};
+
+/**
+ * Registration, sampling and export take the mutex, the metrics themselves are updated without it. Entries are never
+ * removed, so the references handed out stay valid.
+ */
+struct Registry
+{
+    std::mutex Mutex;
+    std::vector<std::unique_ptr<MetricEntry>> Entries;
+    std::unordered_map<std::string, MetricEntry *> ByName; // Keyed by kind and name
+    size_t HistoryIndex = 0;
+};
+
+Registry &GetRegistry()
+{
+    // Constructed on first use, subsystems may register from static initialisers
+    static Registry registry;
+    return registry;
+}
+
+const char *KindName(const MetricKind kind)
+{
+    switch (kind)
+    {
+    case MetricKind::Counter:
+        return "counter";
+    case MetricKind::Gauge:
+        return "gauge";
+    case MetricKind::Histogram:
+        return "histogram";
+    }
+    return "";
+}
+
+// Returns the entry for the name, creating it with create() when it doesn't exist yet
+template <typename Create> MetricEntry &GetEntry(const std::string_view name, const MetricKind kind, Create &&create)
+{
+    Registry &registry = GetRegistry();
+    std::string key(1, static_cast<char>('0' + static_cast<int>(kind)));
+    key += name;
+
+    std::lock_guard lock(registry.Mutex);
+    if (const auto it = registry.ByName.find(key); it != registry.ByName.end())
+        return *it->second;
+
+    auto entry = std::make_unique<MetricEntry>();
+    entry->Name = name;
+    entry->Kind = kind;
+    create(*entry);
+    MetricEntry &result = *entry;
+    registry.Entries.push_back(std::move(entry));
+    registry.ByName.emplace(std::move(key), &result);
+    return result;
+}
+
+// JSON numbers can't be infinite or NaN
+void WriteJsonNumber(std::ostream &stream, const double value)
+{
+    if (std::isfinite(value))
+        stream << value;
+    else
+        stream << "null";
+}
+
+// Metric names are plain identifiers, but quotes and backslashes would break the JSON
+void WriteJsonString(std::ostream &stream, const std::string_view text)
+{
+    stream << '"';
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+            stream << '\\';
+        stream << c;
+    }
+    stream << '"';
+}
+
+} // namespace
+
+Histogram::Histogram(const std::span<const double> bounds)
+    : m_Bounds(bounds.begin(), bounds.end()), m_Buckets(std::make_unique<std::atomic<uint64_t>[]>(bounds.size() + 1))
+{
+}
+
+void Histogram::Record(const double value)
+{
+    const auto bucket = static_cast<size_t>(std::ranges::lower_bound(m_Bounds, value) - m_Bounds.begin());
+    m_Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_Count.fetch_add(1, std::memory_order_relaxed);
+    m_Sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+double Histogram::GetPercentile(const double percentile) const
+{
+    // The buckets are read one at a time while other threads may still record, so this works on their own total
+    std::vector<uint64_t> buckets(GetBucketCount());
+    uint64_t count = 0;
+    for (size_t i = 0; i < buckets.size(); i++)
+    {
+        buckets[i] = GetBucket(i);
+        count += buckets[i];
+    }
+    if (count == 0 || m_Bounds.empty())
+        return 0.0;
+
+    const auto rank = std::max<uint64_t>(
+        static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(count))), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_Bounds.size(); i++)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+            return m_Bounds[i];
+    }
+    return m_Bounds.back();
+}
+
+Counter &Metrics::GetCounter(const std::string_view name)
+{
+    return *GetEntry(name, MetricKind::Counter, [](MetricEntry &entry) {
+                entry.CounterMetric = std::make_unique<Counter>();
+            }).CounterMetric;
+}
+
+Gauge &Metrics::GetGauge(const std::string_view name)
+{
+    return *GetEntry(name, MetricKind::Gauge, [](MetricEntry &entry) {
+                entry.GaugeMetric = std::make_unique<Gauge>();
+            }).GaugeMetric;
+}
+
+Histogram &Metrics::GetHistogram(const std::string_view name, const std::span<const double> bounds)
+{
+    return *GetEntry(name, MetricKind::Histogram, [bounds](MetricEntry &entry) {
+                entry.HistogramMetric = std::make_unique<Histogram>(bounds);
+            }).HistogramMetric;
+}
+
+void Metrics::Sample()
+{
+    Registry &registry = GetRegistry();
+    std::lock_guard lock(registry.Mutex);
+
+    for (const auto &entry : registry.Entries)
+    {
+        float &sample = entry->History[registry.HistoryIndex];
+        switch (entry->Kind)
+        {
+        case MetricKind::Counter: {
+            const uint64_t value = entry->CounterMetric->Get();
+            sample = static_cast<float>(value - entry->SampledCount);
+            entry->SampledCount = value;
+            break;
+        }
+        case MetricKind::Gauge:
+            sample = static_cast<float>(entry->GaugeMetric->Get());
+            break;
+        case MetricKind::Histogram: {
+            // Intervals without new values repeat the previous mean instead of dropping to zero
+            const uint64_t count = entry->HistogramMetric->GetCount();
+            const double sum = entry->HistogramMetric->GetSum();
+            const size_t previous = (registry.HistoryIndex + HISTORY_SIZE - 1) % HISTORY_SIZE;
+            const uint64_t added = count - entry->SampledCount;
+            sample = added ? static_cast<float>((sum - entry->SampledSum) / static_cast<double>(added))
+                           : entry->History[previous];
+            entry->SampledCount = count;
+            entry->SampledSum = sum;
+            break;
+        }
+        }
+    }
+    registry.HistoryIndex = (registry.HistoryIndex + 1) % HISTORY_SIZE;
+}
+
+void Metrics::ForEach(const std::function<void(const MetricView &)> &visitor)
+{
+    Registry &registry = GetRegistry();
+    std::lock_guard lock(registry.Mutex);
+
+    for (const auto &entry : registry.Entries)
+    {
+        MetricView view;
+        view.Name = entry->Name;
+        view.Kind = entry->Kind;
+        view.Value = entry->GetValue();
+        view.Buckets = entry->HistogramMetric.get();
+        view.History = entry->History;
+        view.HistoryOffset = registry.HistoryIndex;
+        visitor(view);
+    }
+}
+
+bool Metrics::AppendCsv(const std::filesystem::path &path, const double time)
+{
+    const bool exists = std::filesystem::exists(path);
+    std::ofstream file(path, std::ios::app);
+    if (!exists)
+        file << "time,name,kind,value\n";
+
+    Registry &registry = GetRegistry();
+    {
+        std::lock_guard lock(registry.Mutex);
+        for (const auto &entry : registry.Entries)
+        {
+            const char *kind = KindName(entry->Kind);
+            switch (entry->Kind)
+            {
+            case MetricKind::Counter:
+                file << time << ',' << entry->Name << ',' << kind << ',' << entry->CounterMetric->Get() << '\n';
+                break;
+            case MetricKind::Gauge:
+                file << time << ',' << entry->Name << ',' << kind << ',' << entry->GaugeMetric->Get() << '\n';
+                break;
+            case MetricKind::Histogram: {
+                const Histogram &histogram = *entry->HistogramMetric;
+                const std::pair<const char *, double> rows[] = {
+                    {"count", static_cast<double>(histogram.GetCount())},
+                    {"mean", entry->GetValue()},
+                    {"p50", histogram.GetPercentile(50.0)},
+                    {"p95", histogram.GetPercentile(95.0)},
+                    {"p99", histogram.GetPercentile(99.0)},
+                };
+                for (const auto &[suffix, value] : rows)
+                    file << time << ',' << entry->Name << '.' << suffix << ',' << kind << ',' << value << '\n';
+                break;
+            }
+            }
+        }
+    }
+
+    file.close();
+    if (!file)
+    {
+        std::cerr << "Failed writing metrics to " << path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Metrics::AppendJson(const std::filesystem::path &path, const double time)
+{
+    std::ofstream file(path, std::ios::app);
+    file << "{\"time\":";
+    WriteJsonNumber(file, time);
+    file << ",\"metrics\":{";
+
+    Registry &registry = GetRegistry();
+    {
+        std::lock_guard lock(registry.Mutex);
+        bool first = true;
+        for (const auto &entry : registry.Entries)
+        {
+            if (!first)
+                file << ',';
+            first = false;
+            WriteJsonString(file, entry->Name);
+            file << ":{\"kind\":\"" << KindName(entry->Kind) << "\",\"value\":";
+            if (entry->Kind == MetricKind::Counter)
+                file << entry->CounterMetric->Get();
+            else
+                WriteJsonNumber(file, entry->GetValue());
+
+            if (entry->Kind == MetricKind::Histogram)
+            {
+                const Histogram &histogram = *entry->HistogramMetric;
+                file << ",\"count\":" << histogram.GetCount() << ",\"p50\":";
+                WriteJsonNumber(file, histogram.GetPercentile(50.0));
+                file << ",\"p95\":";
+                WriteJsonNumber(file, histogram.GetPercentile(95.0));
+                file << ",\"p99\":";
+                WriteJsonNumber(file, histogram.GetPercentile(99.0));
+                file << ",\"bounds\":[";
+                for (size_t i = 0; i < histogram.GetBounds().size(); i++)
+                {
+                    if (i)
+                        file << ',';
+                    WriteJsonNumber(file, histogram.GetBounds()[i]);
+                }
+                file << "],\"buckets\":[";
+                for (size_t i = 0; i < histogram.GetBucketCount(); i++)
+                    file << (i ? "," : "") << histogram.GetBucket(i);
+                file << ']';
+            }
+            file << '}';
+        }
+    }
+    file << "}}\n";
+
+    file.close();
+    if (!file)
+    {
+        std::cerr << "Failed writing metrics to " << path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+MetricsDumper::MetricsDumper(std::filesystem::path path, const double interval)
+    : m_Path(std::move(path)), m_Json(m_Path.extension() == ".json" || m_Path.extension() == ".jsonl"),
+      m_Interval(interval)
+{
+}
+
+MetricsDumper::~MetricsDumper()
+{
+    Dump();
+}
+
+void MetricsDumper::Update(const float deltaTime)
+{
+    m_Time += deltaTime;
+    m_Elapsed += deltaTime;
+    if (m_Elapsed < m_Interval)
+        return;
+    m_Elapsed = 0.0;
+    Dump();
+}
+
+bool MetricsDumper::Dump()
+{
+    return m_Json ? Metrics::AppendJson(m_Path, m_Time) : Metrics::AppendCsv(m_Path, m_Time);
+}
+
+} // namespace BloxxEngine
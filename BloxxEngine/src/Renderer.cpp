@@ -5,9 +5,16 @@
 
 #include "BloxxEngine/Renderer.h"
 
-#include "BloxxEngine/EventDispatcher.h"
 #include "BloxxEngine/Events/KeyboardEvents.h"
 #include "BloxxEngine/Events/MouseEvents.h"
+#include "BloxxEngine/FileSystem.h"
+#include "BloxxEngine/Metrics.h"
+#include "BloxxEngine/World/DefaultBlocks.h"
+#include "BloxxEngine/World/TerrainGenerator.h"
+#include "BloxxEngine/World/World.h"
+#include "BloxxEngine/World/WorldSaver.h"
+#include "BloxxEngine/WorldRenderer.h"
+#include "DirWatcher.h"
 
 #include <GLFW/glfw3.h>
 #include <glad/gl.h>
@@ -17,6 +24,10 @@
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 
 namespace BloxxEngine
@@ -39,11 +50,40 @@ void APIENTRY MessageCallback(GLenum source, GLenum type, GLuint id, GLenum seve
               << type << ", severity = 0x" << severity << ", message = " << message << std::endl;
 }
 
+namespace
+{
+struct FrameMetrics
+{
+    static constexpr double FRAME_TIME_BOUNDS[] = {1.0, 2.0, 4.0, 8.0, 12.0, 16.7, 20.0, 25.0, 33.3, 50.0, 100.0};
+
+    Histogram &FrameTime = Metrics::GetHistogram("frame.time_ms", FRAME_TIME_BOUNDS);
+    Gauge &DrawCalls = Metrics::GetGauge("render.draw_calls");
+    Gauge &Allocations = Metrics::GetGauge("memory.frame_allocations");
+    Gauge &AllocatedBytes = Metrics::GetGauge("memory.frame_allocated_bytes");
+};
+
+FrameMetrics &GetFrameMetrics()
+{
+    static FrameMetrics metrics;
+    return metrics;
+}
+} // namespace
+
 Renderer::Renderer()
-    : m_Window(nullptr), m_Shader(nullptr), m_BaseColorTexture(nullptr), m_Mesh(nullptr), m_LastFrameTime(0.0f),
+    : m_Window(nullptr), m_Mesh(nullptr), m_LastFrameTime(0.0f),
       m_WindowTitle("BloxxEngine"), m_Width(800), m_Height(600),
       m_Camera(std::make_unique<Camera>(glm::vec3(0.0f, 0.0f, 3.0f), /* up vector */ glm::vec3(0.0f, 1.0f, 0.0f), /* yaw */ -90.0f, /* pitch */ 0.0f))
 {
+    m_EventBus.Subscribe<KeyPressedEvent>([this](std::span<const KeyPressedEvent> events) {
+        for (const auto &event : events)
+            OnKeyPressed(event);
+    });
+
+    // Mouse events are coalesced, so this runs at most once per frame. Mouse look reads the sampled input state.
+    m_EventBus.Subscribe<MouseScrolledEvent>([this](std::span<const MouseScrolledEvent> events) {
+        for (const auto &event : events)
+            OnMouseScrolled(event);
+    });
 }
 
 Renderer::~Renderer()
@@ -65,12 +105,22 @@ bool Renderer::Initialize(const std::string &windowTitle, int width, int height)
     if (!InitializeImGui())
         return false;
 
-    // Load shaders
-    m_Shader = std::make_unique<Shader>("Resources/shaders/block.vert.glsl", "Resources/shaders/block.frag.glsl");
-    // Load texture
-    m_BaseColorTexture = std::make_unique<Texture>("Resources/textures/Stone_basecolor.png", Texture::FilterMode::Nearest); // Provide the path to your texture image
-    m_NormalTexture = std::make_unique<Texture>("Resources/textures/Stone_normal.png", Texture::FilterMode::Nearest); // Provide the path to your texture image
-    m_RMAHTexture = std::make_unique<Texture>("Resources/textures/Stone_rmah.png", Texture::FilterMode::Nearest); // Provide the path to your texture image
+    // Serve resources from the packed archive when it is present, loose files are used otherwise
+    if (!FileSystem::Mount("Resources", "Resources.bxpak"))
+        std::cerr << "Resources.bxpak not found, loading loose resource files" << std::endl;
+
+    m_ThreadPool = std::make_unique<ThreadPool>();
+    m_AssetManager = std::make_unique<AssetManager>(*m_ThreadPool);
+
+    // Load shaders and textures in the background, placeholders are drawn until they are uploaded
+    m_Shader = m_AssetManager->LoadShader("Resources/shaders/block.vert.glsl", "Resources/shaders/block.frag.glsl");
+    // Merged terrain faces repeat the textures across the quad
+    m_BaseColorTexture = m_AssetManager->LoadTexture("Resources/textures/Stone_basecolor.png", Texture::FilterMode::Nearest,
+                                                     Texture::WrapMode::Repeat);
+    m_NormalTexture = m_AssetManager->LoadTexture("Resources/textures/Stone_normal.png", Texture::FilterMode::Nearest,
+                                                  Texture::WrapMode::Repeat, 0x8080FFFF); // Flat normal
+    m_RMAHTexture = m_AssetManager->LoadTexture("Resources/textures/Stone_rmah.png", Texture::FilterMode::Nearest,
+                                                Texture::WrapMode::Repeat, 0xFF00FF00); // Rough, dielectric, unoccluded
 
     // clang-format off
     // Cube vertices with positions, normals, and texture coordinates
@@ -129,14 +179,25 @@ bool Renderer::Initialize(const std::string &windowTitle, int width, int height)
     };
 
     // clang-format on
-    m_Mesh = std::make_unique<Mesh>(vertices, indices);
+    m_Mesh = std::make_unique<Mesh>(std::move(vertices), std::move(indices));
+
+    GenerateWorld();
+    if (m_Replay)
+        ApplyCameraState(m_Replay->GetRecording().GetStartCamera());
 
     // Set up matrices
     m_ModelMatrix = glm::mat4(1.0f);
+    m_ViewMatrix = m_Camera->GetViewMatrix();
+    m_CameraPosition = m_Camera->Position;
     m_ProjectionMatrix =
-        glm::perspective(glm::radians(45.0f), static_cast<float>(m_Width) / static_cast<float>(m_Height), 0.1f, 100.f);
+        glm::perspective(glm::radians(45.0f), static_cast<float>(m_Width) / static_cast<float>(m_Height), 0.1f, 500.f);
+
+    // Both ticks start out identical, so the first frames interpolate to the initial state
+    m_CurrentState.CameraPosition = m_Camera->Position;
+    m_PreviousState = m_CurrentState;
 
     m_LastFrameTime = static_cast<float>(glfwGetTime());
+    m_LastTickTime = glfwGetTime();
 
     glEnable(GL_DEBUG_OUTPUT);
     glDebugMessageCallback(MessageCallback, nullptr);
@@ -158,6 +219,32 @@ void Renderer::Run()
 
 void Renderer::Shutdown()
 {
+    if (m_SimulationThread.joinable())
+    {
+        m_SimulationRunning = false;
+        m_SimulationThread.join();
+    }
+    if (m_Window)
+        StopRecording();
+
+    // GL objects have to go while the context is still alive
+    m_Shader = {};
+    m_BaseColorTexture = {};
+    m_NormalTexture = {};
+    m_RMAHTexture = {};
+    if (m_WorldSaver)
+    {
+        // Save what changed since the last autosave, the destructor waits for the writes
+        m_WorldSaver->Wait();
+        m_WorldSaver->Save();
+        m_WorldSaver.reset();
+    }
+    m_WorldRenderer.reset();
+    m_World.reset();
+    m_DirWatcher.reset();
+    m_AssetManager.reset();
+    m_ThreadPool.reset();
+
     // Cleanup ImGui
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -169,40 +256,78 @@ void Renderer::Shutdown()
         m_Window = nullptr;
     }
     glfwTerminate();
+
+    FileSystem::UnmountAll();
 }
+void Renderer::EnableHotReload(const std::string &sourceDir)
+{
+    m_AssetManager->SetReloadSource("Resources", sourceDir);
+    m_DirWatcher = std::make_unique<DirWatcher>(sourceDir);
+}
+
+void Renderer::SetPresentMode(const PresentMode mode, const int frameLimit)
+{
+    m_PresentMode = mode;
+    m_FrameLimit = std::max(frameLimit, 1);
+    if (m_Window)
+        ApplyPresentMode();
+}
+
+void Renderer::SetInputLatencyCallback(std::function<void(const InputLatencySample &)> callback)
+{
+    m_InputLatencyCallback = std::move(callback);
+}
+
+void Renderer::StartRecording(const std::string &path)
+{
+    m_Recording = std::make_unique<InputRecording>();
+    m_Recording->Start(m_WorldSeed, GetCameraState());
+    m_RecordingPath = path;
+    m_RecordingStart = glfwGetTime();
+}
+
+void Renderer::StopRecording()
+{
+    if (!m_Recording)
+        return;
+
+    m_Recording->Finish(glfwGetTime() - m_RecordingStart, GetCameraState());
+    if (m_Recording->Save(m_RecordingPath))
+        std::cout << "Recorded " << m_Recording->GetInputs().size() << " inputs over " << m_Recording->GetDuration()
+                  << " s to " << m_RecordingPath << std::endl;
+    m_Recording.reset();
+}
+
+bool Renderer::LoadReplay(const std::string &path, const std::string &frameLogPath, const float fixedDeltaTime)
+{
+    InputRecording recording;
+    if (!recording.Load(path))
+        return false;
+
+    m_Replay = std::make_unique<InputReplay>(std::move(recording), fixedDeltaTime);
+    m_FrameLogPath = frameLogPath;
+    return true;
+}
+
+void Renderer::SetSimulationSettings(const SimulationSettings &settings)
+{
+    m_SimulationSettings = settings;
+    m_SimulationSettings.TickRate = std::max(settings.TickRate, 1.0f);
+    m_SimulationSettings.MaxCatchUpTicks = std::max(settings.MaxCatchUpTicks, 1);
+}
+
 void Renderer::OnKeyPressed(const KeyPressedEvent &event)
 {
+    // Movement follows the held keys in OnFixedUpdate, only one-shot actions belong here
     switch (event.KeyCode)
     {
     case GLFW_KEY_ESCAPE:
         glfwSetWindowShouldClose(m_Window, GLFW_TRUE);
         break;
-    case GLFW_KEY_W:
-        m_Camera->Move(Camera::Movement::Forward, m_DeltaTime);
-        break;
-    case GLFW_KEY_S:
-        m_Camera->Move(Camera::Movement::Backward, m_DeltaTime);
-        break;
-    case GLFW_KEY_A:
-        m_Camera->Move(Camera::Movement::Left, m_DeltaTime);
-        break;
-    case GLFW_KEY_D:
-        m_Camera->Move(Camera::Movement::Right, m_DeltaTime);
-        break;
-    case GLFW_KEY_SPACE:
-        m_Camera->Move(Camera::Movement::Up, m_DeltaTime);
-        break;
-    case GLFW_KEY_LEFT_CONTROL:
-        m_Camera->Move(Camera::Movement::Down, m_DeltaTime);
-        break;
     default:
         break;
     }
 }
-void Renderer::OnMouseMoved(const MouseMovedEvent &event)
-{
-    m_Camera->Rotate(event.X, event.Y);
-}
 void Renderer::OnMouseScrolled(const MouseScrolledEvent &event)
 {
     m_Camera->Zoom(event.OffsetY);
@@ -233,12 +358,12 @@ bool Renderer::InitializeGLFW()
 
     glfwMakeContextCurrent(m_Window);
 
-    // Enable V-Sync
-    glfwSwapInterval(1);
+    ApplyPresentMode();
 
     glfwSetWindowUserPointer(m_Window, this);
     glfwSetKeyCallback(m_Window, KeyCallback);
     glfwSetCursorPosCallback(m_Window, MouseMoveCallback);
+    glfwSetMouseButtonCallback(m_Window, MouseButtonCallback);
     glfwSetScrollCallback(m_Window, MouseScrollCallback);
 
     // Capture the mouse
@@ -294,12 +419,11 @@ void Renderer::KeyCallback(GLFWwindow *window, int key, int scancode, int action
 {
     auto *renderer = static_cast<Renderer *>(glfwGetWindowUserPointer(window));
 
-    if (action == GLFW_PRESS || action == GLFW_REPEAT)
-    {
-        bool repeat = action == GLFW_REPEAT;
-        KeyPressedEvent event(key, repeat);
-        renderer->OnEvent(event);
-    }
+    RecordedInput input;
+    input.Type = action == GLFW_RELEASE ? RecordedInputType::KeyReleased : RecordedInputType::KeyPressed;
+    input.Repeat = action == GLFW_REPEAT;
+    input.Code = key;
+    renderer->OnWindowInput(input);
 }
 void Renderer::MouseMoveCallback(GLFWwindow *window, double xPos, double yPos)
 {
@@ -318,32 +442,167 @@ void Renderer::MouseMoveCallback(GLFWwindow *window, double xPos, double yPos)
     s_LastX = static_cast<float>(xPos);
     s_LastY = static_cast<float>(yPos);
 
-    renderer->m_Camera->Rotate(xOffset, yOffset);
+    RecordedInput input;
+    input.Type = RecordedInputType::MouseMoved;
+    input.Offset = {xOffset, yOffset};
+    renderer->OnWindowInput(input);
+}
+void Renderer::MouseButtonCallback(GLFWwindow *window, int button, int action, int mods)
+{
+    auto *renderer = static_cast<Renderer *>(glfwGetWindowUserPointer(window));
+
+    RecordedInput input;
+    input.Type = action == GLFW_RELEASE ? RecordedInputType::ButtonReleased : RecordedInputType::ButtonPressed;
+    input.Code = button;
+    renderer->OnWindowInput(input);
 }
 void Renderer::MouseScrollCallback(GLFWwindow *window, double xOffset, double yOffset)
 {
     auto *renderer = static_cast<Renderer *>(glfwGetWindowUserPointer(window));
-    MouseScrolledEvent event(static_cast<float>(xOffset), static_cast<float>(yOffset));
-    renderer->OnEvent(event);
+
+    RecordedInput input;
+    input.Type = RecordedInputType::MouseScrolled;
+    input.Offset = {static_cast<float>(xOffset), static_cast<float>(yOffset)};
+    renderer->OnWindowInput(input);
+}
+
+void Renderer::OnWindowInput(const RecordedInput &input)
+{
+    const double time = glfwGetTime();
+
+    // A replay owns the input, only escape still gets through to stop it early
+    if (m_Replay)
+    {
+        if (input.Type == RecordedInputType::KeyPressed && input.Code == GLFW_KEY_ESCAPE)
+            glfwSetWindowShouldClose(m_Window, GLFW_TRUE);
+        return;
+    }
+
+    if (m_Recording)
+    {
+        RecordedInput recorded = input;
+        recorded.Time = time - m_RecordingStart;
+        m_Recording->Add(recorded);
+    }
+    SubmitInput(input, time);
+}
+
+void Renderer::SubmitInput(const RecordedInput &input, const double time)
+{
+    switch (input.Type)
+    {
+    case RecordedInputType::KeyPressed:
+        m_InputState.OnKey(input.Code, true, time);
+        m_EventBus.Post<KeyPressedEvent>(input.Code, input.Repeat);
+        break;
+    case RecordedInputType::KeyReleased:
+        m_InputState.OnKey(input.Code, false, time);
+        break;
+    case RecordedInputType::ButtonPressed:
+    case RecordedInputType::ButtonReleased:
+        m_InputState.OnMouseButton(input.Code, input.Type == RecordedInputType::ButtonPressed, time);
+        break;
+    case RecordedInputType::MouseMoved:
+        m_InputState.OnMouseMoved(input.Offset.x, input.Offset.y, time);
+        m_EventBus.Post<MouseMovedEvent>(input.Offset.x, input.Offset.y);
+        break;
+    case RecordedInputType::MouseScrolled:
+        m_InputState.OnMouseScrolled(input.Offset.x, input.Offset.y, time);
+        m_EventBus.Post<MouseScrolledEvent>(input.Offset.x, input.Offset.y);
+        break;
+    }
 }
 
 void Renderer::MainLoop()
 {
+    // The simulation thread ticks on its own clock, replays tick with the frames so every run sees the same input
+    if (m_Replay)
+        m_SimulationSettings.RunOnThread = false;
+
+    if (m_SimulationSettings.RunOnThread)
+    {
+        m_SimulationRunning = true;
+        m_SimulationThread = std::thread(&Renderer::SimulationThreadLoop, this);
+    }
+
     while (!glfwWindowShouldClose(m_Window))
     {
         // Calculate delta time
-        const auto currentFrameTime = static_cast<float>(glfwGetTime());
+        const double frameStart = glfwGetTime();
+        const auto currentFrameTime = static_cast<float>(frameStart);
         m_DeltaTime = static_cast<float>(currentFrameTime - m_LastFrameTime);
         m_LastFrameTime = currentFrameTime;
-
-        // Process input
-        ProcessInput();
+        RecordFrameTime(m_DeltaTime);
+        GetFrameMetrics().FrameTime.Record(m_DeltaTime * 1000.0);
+        if (m_Replay)
+        {
+            // The real frame times are measured, but the simulation always advances by the fixed timestep. The first
+            // frame's time is left out, it includes the initialization.
+            if (m_FrameIndex > 0)
+                m_Replay->AddFrameTime(m_DeltaTime);
+            m_DeltaTime = m_Replay->GetFixedDeltaTime();
+        }
+
+        // Rebuild assets whose source files changed, then finish uploads that completed on the workers
+        if (m_DirWatcher)
+        {
+            for (const auto &file : m_DirWatcher->PollFiles())
+                m_AssetManager->Reload("Resources/" + file);
+        }
+        m_AssetManager->Update();
+
+        // Gather input as late as possible, so it is at most this frame's CPU time old when the camera uses it
+        if (m_Recording)
+            m_Recording->NextFrame();
+        glfwPollEvents();
+        if (m_Replay)
+        {
+            for (const RecordedInput &input : m_Replay->Advance())
+                SubmitInput(input, frameStart);
+        }
 
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
+        // Process input and advance the simulation, the render state is interpolated between the last two ticks
+        {
+            std::lock_guard lock(m_SimulationMutex);
+            ProcessInput();
+
+            float alpha;
+            if (m_SimulationSettings.RunOnThread)
+            {
+                m_TicksLastFrame = m_ThreadTicks.exchange(0);
+                alpha = static_cast<float>((frameStart - m_LastTickTime) * m_SimulationSettings.TickRate);
+            }
+            else
+            {
+                RunFixedUpdates(m_DeltaTime);
+                alpha = m_Accumulator * m_SimulationSettings.TickRate;
+            }
+            UpdateRenderState(std::clamp(alpha, 0.0f, 1.0f));
+
+            const FluidSimulator &fluids = m_World->GetFluidSimulator();
+            m_SimulationStats.ActiveFluidCells = fluids.GetActiveCellCount();
+            m_SimulationStats.FluidStepTime = fluids.GetLastStepTime();
+            const BlockTicker &ticker = m_World->GetBlockTicker();
+            m_SimulationStats.ScheduledTicks = ticker.GetScheduledCount();
+            m_SimulationStats.LastTickCount = ticker.GetLastTickCount();
+            m_SimulationStats.LastTickTime = ticker.GetLastTickTime();
+            m_SimulationStats.SavedChunks = m_WorldSaver->GetLastChunkCount();
+            m_SimulationStats.SavedBytes = m_WorldSaver->GetLastBytesWritten();
+            m_SimulationStats.SnapshotTime = m_WorldSaver->GetLastSnapshotTime();
+            m_SimulationStats.SaveTime = m_WorldSaver->GetLastSaveTime();
+            m_SimulationStats.Saving = m_WorldSaver->IsSaving();
+
+            // Chunks edited by the ticks or changing level of detail, uploaded when they are drawn
+            m_WorldRenderer->UpdateLods(m_CameraPosition);
+            m_WorldRenderer->UpdateMeshes();
+            m_TranslucentSorts = m_WorldRenderer->SortTranslucent(m_CameraPosition);
+        }
+
         // Update logic
         OnUpdate(m_DeltaTime);
 
@@ -363,22 +622,262 @@ void Renderer::MainLoop()
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
         glfwSwapBuffers(m_Window);
-        glfwPollEvents();
+        RecordInputLatency(glfwGetTime());
+        m_FrameIndex++;
+
+        const AllocationCounters allocations = GetAllocationCounters();
+        m_FrameAllocations = {allocations.Count - m_AllocationsAtFrameEnd.Count,
+                              allocations.Bytes - m_AllocationsAtFrameEnd.Bytes};
+        m_AllocationsAtFrameEnd = allocations;
+
+        FrameMetrics &metrics = GetFrameMetrics();
+        metrics.DrawCalls.Set(m_DrawCalls);
+        metrics.Allocations.Set(static_cast<double>(m_FrameAllocations.Count));
+        metrics.AllocatedBytes.Set(static_cast<double>(m_FrameAllocations.Bytes));
+        Metrics::Sample();
+
+        if (m_PresentMode == PresentMode::Limited)
+            WaitForFrameLimit(frameStart);
+
+        if (m_Replay && m_Replay->IsFinished())
+            glfwSetWindowShouldClose(m_Window, GLFW_TRUE);
     }
+
+    if (m_SimulationThread.joinable())
+    {
+        m_SimulationRunning = false;
+        m_SimulationThread.join();
+    }
+
+    if (m_Replay)
+        FinishReplay();
 }
 
-void Renderer::ProcessInput() const
+void Renderer::GenerateWorld()
 {
+    m_World = std::make_unique<World>(m_ThreadPool.get());
+    m_WorldRenderer = std::make_unique<WorldRenderer>(*m_World, m_ThreadPool.get());
+    TerrainGenerator::Settings settings = RegisterDefaultBlocks(*m_World);
+    if (m_Replay)
+        settings.Seed = m_Replay->GetRecording().GetWorldSeed();
+    m_WorldSeed = settings.Seed;
+    const TerrainGenerator generator(settings);
+
+    // A patch of terrain around the origin, generated and meshed on the workers
+    constexpr int radius = 12;
+    std::vector<Chunk *> chunks;
+    for (int chunkX = -radius; chunkX < radius; chunkX++)
+    {
+        for (int chunkZ = -radius; chunkZ < radius; chunkZ++)
+            chunks.push_back(&m_World->AddChunk(chunkX, chunkZ));
+    }
+    m_ThreadPool->ParallelFor(chunks.size(), 1, [&generator, &chunks](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++)
+            generator.Generate(*chunks[i]);
+    });
+
+    // Chunks edited in earlier sessions replace their generated terrain
+    m_WorldSaver = std::make_unique<WorldSaver>(*m_World, "Saves/World");
+    for (Chunk *chunk : chunks)
+        m_WorldSaver->LoadChunk(*chunk);
+
+    for (const Chunk *chunk : chunks)
+        m_World->GetLightEngine().LightChunk(chunk->GetChunkX(), chunk->GetChunkZ());
+    m_World->GetLightEngine().Propagate();
+
+    // Start above the terrain at the origin, looking at the cube
+    const auto ground = static_cast<float>(generator.GetHeight(0, 0) + 1);
+    m_CubePosition = glm::vec3(0.5f, ground + 3.0f, 0.5f);
+    m_Camera->Position = m_CubePosition + glm::vec3(0.0f, 0.0f, 3.0f);
+    m_LightPosition = m_CubePosition + glm::vec3(40.0f, 120.0f, 30.0f);
+
+    // Distant chunks are meshed at their coarser level right away
+    m_WorldRenderer->UpdateLods(m_Camera->Position);
+    m_WorldRenderer->UpdateMeshes();
 }
 
-void Renderer::OnUpdate(float deltaTime)
+void Renderer::ProcessInput()
 {
+    // Deliver the input gathered by glfwPollEvents in batches
+    m_EventBus.Dispatch();
+
+    m_Input = m_InputState.Sample(glfwGetTime());
+
+    // Looking around isn't part of the simulation, apply it right away so it shows up in this frame
+    if (m_Input.MouseDelta != glm::vec2(0.0f))
+        m_Camera->Rotate(m_Input.MouseDelta.x, m_Input.MouseDelta.y);
+}
+
+void Renderer::RecordInputLatency(const double presentTime)
+{
+    if (!m_Input.HasInput)
+        return;
+
+    const InputLatencySample sample{m_FrameIndex, m_Input.InputTime, m_Input.SampleTime, presentTime};
+    m_InputLatency = static_cast<float>((sample.PresentTime - sample.InputTime) * 1000.0);
+    m_AverageInputLatency =
+        m_AverageInputLatency == 0.0f ? m_InputLatency : m_AverageInputLatency + (m_InputLatency - m_AverageInputLatency) * 0.05f;
+
+    if (m_InputLatencyCallback)
+        m_InputLatencyCallback(sample);
+}
+
+void Renderer::RunFixedUpdates(const float frameTime)
+{
+    const float fixedDeltaTime = 1.0f / m_SimulationSettings.TickRate;
+
+    m_Accumulator += frameTime;
+    m_TicksLastFrame = 0;
+    while (m_Accumulator >= fixedDeltaTime)
+    {
+        // Don't let a slow frame snowball into ever longer catch-up frames, drop the backlog instead
+        if (m_TicksLastFrame == m_SimulationSettings.MaxCatchUpTicks)
+        {
+            const auto dropped = static_cast<uint64_t>(m_Accumulator / fixedDeltaTime);
+            m_DroppedTicks += dropped;
+            m_Accumulator -= static_cast<float>(dropped) * fixedDeltaTime;
+            break;
+        }
+
+        Tick();
+        m_Accumulator -= fixedDeltaTime;
+        m_TicksLastFrame++;
+    }
+}
+
+void Renderer::Tick()
+{
+    m_PreviousState = m_CurrentState;
+
+    // The camera is moved to the interpolated position for rendering, continue from the last tick instead
+    m_Camera->Position = m_CurrentState.CameraPosition;
+    OnFixedUpdate(1.0f / m_SimulationSettings.TickRate);
+    m_CurrentState.CameraPosition = m_Camera->Position;
+}
+
+void Renderer::SimulationThreadLoop()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto tickDuration =
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_SimulationSettings.TickRate));
+
+    auto nextTick = Clock::now() + tickDuration;
+    while (m_SimulationRunning)
+    {
+        std::this_thread::sleep_until(nextTick);
+        {
+            std::lock_guard lock(m_SimulationMutex);
+            Tick();
+            m_LastTickTime = glfwGetTime();
+        }
+        m_ThreadTicks++;
+        nextTick += tickDuration;
+
+        // Same catch-up limit as the single threaded path
+        const auto behind = Clock::now() - nextTick;
+        if (behind > tickDuration * m_SimulationSettings.MaxCatchUpTicks)
+        {
+            const auto dropped = behind / tickDuration;
+            m_DroppedTicks += static_cast<uint64_t>(dropped);
+            nextTick += tickDuration * dropped;
+        }
+    }
+}
+
+void Renderer::UpdateRenderState(const float alpha)
+{
+    m_CameraPosition = glm::mix(m_PreviousState.CameraPosition, m_CurrentState.CameraPosition, alpha);
+    m_ViewMatrix = glm::lookAt(m_CameraPosition, m_CameraPosition + m_Camera->Front, m_Camera->Up);
+
+    const float angle = glm::mix(m_PreviousState.ModelAngle, m_CurrentState.ModelAngle, alpha);
+    m_ModelMatrix = glm::rotate(glm::translate(glm::mat4(1.0f), m_CubePosition), glm::radians(angle),
+                                glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+CameraState Renderer::GetCameraState() const
+{
+    // The position of the last tick, the camera itself may be at an interpolated one
+    return {m_CurrentState.CameraPosition, m_Camera->Yaw, m_Camera->Pitch, m_Camera->ZoomFactor};
+}
+
+void Renderer::ApplyCameraState(const CameraState &camera)
+{
+    m_Camera->Position = camera.Position;
+    m_Camera->SetOrientation(camera.Yaw, camera.Pitch);
+    m_Camera->ZoomFactor = camera.Zoom;
+}
+
+void Renderer::FinishReplay()
+{
+    const InputReplay::Summary summary = m_Replay->GetSummary();
+    std::cout << "Replay finished, " << summary.Frames << " frames: mean " << summary.Mean << " ms, p95 "
+              << summary.P95 << " ms, p99 " << summary.P99 << " ms, max " << summary.Max << " ms" << std::endl;
+
+    // Frame pacing differs between recording and replay, so some distance is expected. Replays of the same
+    // recording should all end in the same place.
+    const CameraState end = GetCameraState();
+    std::cout << "Camera ended " << glm::distance(end.Position, m_Replay->GetRecording().GetEndCamera().Position)
+              << " blocks from where the recording did" << std::endl;
+
+    if (!m_FrameLogPath.empty())
+        m_Replay->WriteFrameLog(m_FrameLogPath);
+    m_Replay.reset();
+}
+
+void Renderer::ApplyPresentMode() const
+{
+    glfwSwapInterval(m_PresentMode == PresentMode::VSync ? 1 : 0);
+}
+
+void Renderer::WaitForFrameLimit(const double frameStart) const
+{
+    const double frameEnd = frameStart + 1.0 / m_FrameLimit;
+
+    // Sleep is only accurate to a millisecond or so, spin for the last stretch
+    constexpr double spinTime = 0.002;
+    const double remaining = frameEnd - glfwGetTime();
+    if (remaining > spinTime)
+        std::this_thread::sleep_for(std::chrono::duration<double>(remaining - spinTime));
+    while (glfwGetTime() < frameEnd)
+        std::this_thread::yield();
+}
+
+void Renderer::RecordFrameTime(const float frameTime)
+{
+    m_FrameTimes[m_FrameTimeIndex] = frameTime * 1000.0f;
+    m_FrameTimeIndex = (m_FrameTimeIndex + 1) % FrameHistorySize;
+}
+
+void Renderer::OnFixedUpdate(const float fixedDeltaTime)
+{
+    // Held keys move the camera every tick, independent of the key repeat rate
+    constexpr std::pair<int, Camera::Movement> movementKeys[] = {
+        {GLFW_KEY_W, Camera::Movement::Forward}, {GLFW_KEY_S, Camera::Movement::Backward},
+        {GLFW_KEY_A, Camera::Movement::Left},    {GLFW_KEY_D, Camera::Movement::Right},
+        {GLFW_KEY_SPACE, Camera::Movement::Up},  {GLFW_KEY_LEFT_CONTROL, Camera::Movement::Down},
+    };
+    for (const auto &[key, movement] : movementKeys)
+    {
+        if (m_Input.IsKeyDown(key))
+            m_Camera->Move(movement, fixedDeltaTime);
+    }
+
+    m_World->Update(fixedDeltaTime);
+    m_WorldSaver->Update(fixedDeltaTime);
 
     // Rotate the model
-    float rotationSpeed = 50.0f; // degrees per second
-    float angle = rotationSpeed * deltaTime;
-    m_ModelMatrix = glm::rotate(m_ModelMatrix, glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f));
+    constexpr float rotationSpeed = 50.0f; // degrees per second
+    m_CurrentState.ModelAngle += rotationSpeed * fixedDeltaTime;
+    if (m_CurrentState.ModelAngle >= 360.0f)
+    {
+        // Wrap both ticks so the interpolation doesn't spin back the long way
+        m_CurrentState.ModelAngle -= 360.0f;
+        m_PreviousState.ModelAngle -= 360.0f;
+    }
+}
 
+void Renderer::OnUpdate(float deltaTime)
+{
     // Rotate the light position around the Y-axis
     float lightRotationSpeed = 20.0f; // degrees per second
     float lightAngle = glm::radians(lightRotationSpeed * deltaTime);
@@ -393,9 +892,9 @@ void Renderer::OnRender()
     m_Shader->Bind();
 
     m_Shader->SetUniformMat4("model", m_ModelMatrix);
-    m_Shader->SetUniformMat4("view", m_Camera->GetViewMatrix());
+    m_Shader->SetUniformMat4("view", m_ViewMatrix);
     m_ProjectionMatrix = glm::perspective(glm::radians(m_Camera->ZoomFactor),
-                                          static_cast<float>(m_Width) / static_cast<float>(m_Height), 0.1f, 100.0f);
+                                          static_cast<float>(m_Width) / static_cast<float>(m_Height), 0.1f, 500.0f);
     m_Shader->SetUniformMat4("projection", m_ProjectionMatrix);
 
     // Set material properties
@@ -412,12 +911,26 @@ void Renderer::OnRender()
     m_Shader->SetUniformVec3("light.ambient", glm::vec3(.06f));
 
     // Set the view position
-    m_Shader->SetUniformVec3("viewPos", m_Camera->Position);
+    m_Shader->SetUniformVec3("viewPos", m_CameraPosition);
+    m_Shader->SetUniformFloat("opacity", 1.0f);
 
     // Draw the mesh
     m_Mesh->Draw();
     m_DrawCalls++;
 
+    // Terrain is meshed in world space
+    m_Shader->SetUniformMat4("model", glm::mat4(1.0f));
+    m_DrawCalls += m_WorldRenderer->Draw();
+
+    // Translucent blocks last, back to front, testing against the opaque depth without writing it
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    m_Shader->SetUniformFloat("opacity", 0.6f);
+    m_DrawCalls += m_WorldRenderer->DrawTranslucent(m_CameraPosition);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+
     // Unbind everything
     m_Shader->Unbind();
     m_BaseColorTexture->Unbind();
@@ -433,27 +946,70 @@ void Renderer::OnImGuiRender()
     ImGui::Text("FPS: %.2f", 1.0f / m_DeltaTime);
     ImGui::Text("Frame Time: %.2f ms", m_DeltaTime * 1000.0f);
     ImGui::Text("Draw calls: %d", m_DrawCalls);
-    ImGui::Text("Camera Position: (%.2f, %.2f, %.2f)", m_Camera->Position.x, m_Camera->Position.y, m_Camera->Position.z);
+    ImGui::Text("Translucent sections re-sorted: %d", m_TranslucentSorts);
+    ImGui::Text("Allocations: %llu last frame (%.1f KB), %zu chunks and %zu meshes pooled",
+                static_cast<unsigned long long>(m_FrameAllocations.Count), m_FrameAllocations.Bytes / 1024.0,
+                m_World->GetPooledChunkCount(), m_WorldRenderer->GetPooledMeshCount());
+    const auto &lodCounts = m_WorldRenderer->GetLodCounts();
+    ImGui::Text("Chunk LODs: %d / %d / %d / %d", lodCounts[0], lodCounts[1], lodCounts[2], lodCounts[3]);
+    ImGui::Text("Camera Position: (%.2f, %.2f, %.2f)", m_CameraPosition.x, m_CameraPosition.y, m_CameraPosition.z);
+
+    ImGui::PlotLines("##FrameTimes", m_FrameTimes.data(), FrameHistorySize, m_FrameTimeIndex, "Frame time (ms)",
+                     0.0f, 33.3f, ImVec2(0.0f, 60.0f));
+
+    // Distribution of the recorded frame times in 1 ms buckets, the last bucket collects everything slower
+    std::array<float, 34> buckets{};
+    for (const float frameTime : m_FrameTimes)
+        buckets[std::min(static_cast<size_t>(frameTime), buckets.size() - 1)]++;
+    ImGui::PlotHistogram("##FrameTimeHistogram", buckets.data(), static_cast<int>(buckets.size()), 0,
+                         "0 - 33+ ms", 0.0f, static_cast<float>(FrameHistorySize), ImVec2(0.0f, 60.0f));
+
+    const char *presentModes[] = {"VSync", "Uncapped", "Limited"};
+    int presentMode = static_cast<int>(m_PresentMode);
+    int frameLimit = m_FrameLimit;
+    bool presentChanged = ImGui::Combo("Present mode", &presentMode, presentModes, IM_ARRAYSIZE(presentModes));
+    if (m_PresentMode == PresentMode::Limited)
+        presentChanged |= ImGui::SliderInt("Frame limit", &frameLimit, 15, 480);
+    if (presentChanged)
+        SetPresentMode(static_cast<PresentMode>(presentMode), frameLimit);
+
+    ImGui::Text("Input latency: %.2f ms (avg %.2f ms)", m_InputLatency, m_AverageInputLatency);
+    ImGui::Text("Simulation: %.0f Hz%s, %d ticks this frame, %llu dropped", m_SimulationSettings.TickRate,
+                m_SimulationSettings.RunOnThread ? " (threaded)" : "", m_TicksLastFrame,
+                static_cast<unsigned long long>(m_DroppedTicks.load()));
+    ImGui::Text("Fluids: %zu active cells, %.2f ms per step", m_SimulationStats.ActiveFluidCells,
+                m_SimulationStats.FluidStepTime);
+    ImGui::Text("Block ticks: %zu scheduled, %zu run, %.2f ms", m_SimulationStats.ScheduledTicks,
+                m_SimulationStats.LastTickCount, m_SimulationStats.LastTickTime);
+    ImGui::Text("World save: %zu chunks (%.1f KB), %.2f ms snapshot, %.1f ms total%s", m_SimulationStats.SavedChunks,
+                m_SimulationStats.SavedBytes / 1024.0, m_SimulationStats.SnapshotTime, m_SimulationStats.SaveTime,
+                m_SimulationStats.Saving ? ", saving" : "");
     ImGui::End();
-}
-void Renderer::OnEvent(Event &event)
-{
-    EventDispatcher dispatcher(event);
 
-    dispatcher.Dispatch<KeyPressedEvent>([this](KeyPressedEvent &e) {
-        OnKeyPressed(e);
-        return true;
-    });
-
-    dispatcher.Dispatch<MouseMovedEvent>([this](MouseMovedEvent &e) {
-        OnMouseMoved(e);
-        return true;
-    });
-
-    dispatcher.Dispatch<MouseScrolledEvent>([this](MouseScrolledEvent &e) {
-        OnMouseScrolled(e);
-        return true;
+    // Everything registered with Metrics, with the per frame samples as sparklines
+    ImGui::Begin("Metrics");
+    Metrics::ForEach([](const MetricView &metric) {
+        const int nameLength = static_cast<int>(metric.Name.size());
+        ImGui::PushID(metric.Name.data(), metric.Name.data() + metric.Name.size());
+        ImGui::PlotLines("##History", metric.History.data(), static_cast<int>(metric.History.size()),
+                         static_cast<int>(metric.HistoryOffset), nullptr, FLT_MAX, FLT_MAX, ImVec2(120.0f, 24.0f));
+        ImGui::SameLine();
+        switch (metric.Kind)
+        {
+        case MetricKind::Counter:
+            ImGui::Text("%.*s: %.0f", nameLength, metric.Name.data(), metric.Value);
+            break;
+        case MetricKind::Gauge:
+            ImGui::Text("%.*s: %.2f", nameLength, metric.Name.data(), metric.Value);
+            break;
+        case MetricKind::Histogram:
+            ImGui::Text("%.*s: %.2f avg, %.1f p95, %.1f p99", nameLength, metric.Name.data(), metric.Value,
+                        metric.Buckets->GetPercentile(95.0), metric.Buckets->GetPercentile(99.0));
+            break;
+        }
+        ImGui::PopID();
     });
+    ImGui::End();
 }
 
 } // namespace BloxxEngine
\ No newline at end of file
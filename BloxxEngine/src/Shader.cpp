@@ -5,6 +5,8 @@
 
 #include "BloxxEngine/Shader.h"
 
+#include "BloxxEngine/FileSystem.h"
+
 #include <fstream>
 #include <iostream>
 #include <ostream>
@@ -15,12 +17,25 @@ Shader::Shader(const std::string &vertexShaderPath, const std::string &fragmentS
 {
     const auto vertexShaderSrc = LoadShaderSource(vertexShaderPath);
     const auto fragmentShaderSrc = LoadShaderSource(fragmentShaderPath);
-    
-    GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexShaderSrc);
-    GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentShaderSrc);
+
+    Build(vertexShaderSrc, fragmentShaderSrc, vertexShaderPath + ", " + fragmentShaderPath);
+}
+
+std::unique_ptr<Shader> Shader::FromSource(const std::string &vertexSource, const std::string &fragmentSource,
+                                           const std::string &debugName)
+{
+    std::unique_ptr<Shader> shader(new Shader());
+    shader->Build(vertexSource, fragmentSource, debugName);
+    return shader;
+}
+
+void Shader::Build(const std::string &vertexSource, const std::string &fragmentSource, const std::string &debugName)
+{
+    GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
 
     m_RendererID = CreateProgram(vertexShader, fragmentShader);
-    std::cout << "Shader Program ID: " << m_RendererID << ", for: " << vertexShaderPath << ", " << fragmentShaderPath << std::endl;
+    std::cout << "Shader Program ID: " << m_RendererID << ", for: " << debugName << std::endl;
 
     GLint numUniforms = 0;
     glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &numUniforms);
@@ -40,6 +55,33 @@ Shader::Shader(const std::string &vertexShaderPath, const std::string &fragmentS
     glDeleteShader(fragmentShader);
 }
 
+bool Shader::Reload(const std::string &vertexSource, const std::string &fragmentSource)
+{
+    const GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+    const GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+    GLuint program = 0;
+    if (vertexShader != 0 && fragmentShader != 0)
+    {
+        program = CreateProgram(vertexShader, fragmentShader);
+        if (program != 0)
+        {
+            glDetachShader(program, vertexShader);
+            glDetachShader(program, fragmentShader);
+        }
+    }
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    if (program == 0)
+        return false;
+
+    glDeleteProgram(m_RendererID);
+    m_RendererID = program;
+    m_UniformLocationCache.clear();
+    return true;
+}
+
 Shader::~Shader()
 {
     glDeleteProgram(m_RendererID);
@@ -81,6 +123,9 @@ void Shader::SetUniformVec3(const std::string &name, const glm::vec3 &value)
 
 std::string Shader::LoadShaderSource(const std::string &path)
 {
+    // Shaders in a mounted archive are already preprocessed
+    if (const auto source = FileSystem::FindText(path))
+        return std::string(*source);
 
     std::ifstream file(path);
     if (!file.is_open())
@@ -5,6 +5,8 @@
 
 #include "BloxxEngine/Texture.h"
 
+#include "BloxxEngine/FileSystem.h"
+
 #include "spdlog/fmt/bundled/chrono.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -17,6 +19,15 @@ namespace BloxxEngine
 Texture::Texture(const std::string &filePath, const FilterMode filterMode, const WrapMode wrapMode)
     : m_RendererID(0), m_FilePath(filePath), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
 {
+    // Pre-decoded textures from a mounted archive are uploaded straight from the mapping
+    Image image;
+    if (FileSystem::FindImage(filePath, image))
+    {
+        m_BPP = 4;
+        Upload(image, filterMode, wrapMode);
+        return;
+    }
+
     // Flip the image vertically during loading
     stbi_set_flip_vertically_on_load(true);
 
@@ -28,6 +39,31 @@ Texture::Texture(const std::string &filePath, const FilterMode filterMode, const
         return;
     }
 
+    image.Width = m_Width;
+    image.Height = m_Height;
+    image.Mips = {{m_Width, m_Height, m_LocalBuffer}};
+    Upload(image, filterMode, wrapMode);
+
+    stbi_image_free(m_LocalBuffer);
+    m_LocalBuffer = nullptr;
+}
+
+Texture::Texture(const Image &image, const FilterMode filterMode, const WrapMode wrapMode)
+    : m_RendererID(0), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(4)
+{
+    Upload(image, filterMode, wrapMode);
+}
+
+void Texture::Upload(const Image &image, const FilterMode filterMode, const WrapMode wrapMode)
+{
+    if (image.Mips.empty())
+        return;
+
+    m_Width = image.Width;
+    m_Height = image.Height;
+    m_MipCount = static_cast<int>(image.Mips.size());
+    const bool hasMips = m_MipCount > 1;
+
     // Generate and bind texture
     glGenTextures(1, &m_RendererID);
     glBindTexture(GL_TEXTURE_2D, m_RendererID);
@@ -36,11 +72,11 @@ Texture::Texture(const std::string &filePath, const FilterMode filterMode, const
     switch (filterMode)
     {
     case FilterMode::Nearest:
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, hasMips ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         break;
     case FilterMode::Linear:
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, hasMips ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         break;
     }
@@ -57,12 +93,18 @@ Texture::Texture(const std::string &filePath, const FilterMode filterMode, const
         break;
     }
 
-    // Load the data into the texture
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer);
+    // Load the data into the texture, rows are tightly packed
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(image.Mips.size()) - 1);
+    for (size_t level = 0; level < image.Mips.size(); level++)
+    {
+        const ImageMip &mip = image.Mips[level];
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGBA, mip.Width, mip.Height, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, mip.Pixels);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
     glBindTexture(GL_TEXTURE_2D, 0);
-
-    stbi_image_free(m_LocalBuffer);
 }
 
 Texture::~Texture()
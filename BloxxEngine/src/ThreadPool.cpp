@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/ThreadPool.h"
+
+#include "BloxxEngine/Metrics.h"
+
+namespace BloxxEngine
+{
+
+namespace
+{
+// Shared by all pools, the queue depth is the jobs waiting across them
+struct ThreadPoolMetrics
+{
+    Gauge &QueueDepth = Metrics::GetGauge("threadpool.queue_depth");
+    Counter &JobsRun = Metrics::GetCounter("threadpool.jobs_run");
+};
+
+ThreadPoolMetrics &GetThreadPoolMetrics()
+{
+    static ThreadPoolMetrics metrics;
+    return metrics;
+}
+} // namespace
+
+ThreadPool::ThreadPool(unsigned workerCount)
+{
+    // hardware_concurrency() is 0 when it can't be determined, clamped before subtracting so that doesn't wrap
+    if (workerCount == 0)
+        workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+    m_Workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; i++)
+        m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+
+    for (auto &worker : m_Workers)
+        worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Jobs.push_back(std::move(job));
+        // Under the lock, so a worker can't take the job off the gauge before it was added
+        GetThreadPoolMetrics().QueueDepth.Add(1.0);
+    }
+    m_Condition.notify_one();
+}
+
+size_t ThreadPool::GetQueueDepth() const
+{
+    std::lock_guard lock(m_Mutex);
+    return m_Jobs.size();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(m_Mutex);
+            m_Condition.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+
+            // Drain the queue before stopping so nobody waits on a job that never runs
+            if (m_Jobs.empty())
+                return;
+
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+            GetThreadPoolMetrics().QueueDepth.Add(-1.0);
+        }
+        job();
+        GetThreadPoolMetrics().JobsRun.Add();
+    }
+}
+
+} // namespace BloxxEngine
@@ -5,5 +5,59 @@
 
 #include "BloxxEngine/World/BlockRegistry.h"
 
+#include "BloxxEngine/World/ChunkSection.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
 namespace BloxxEngine {
-} // BloxxEngine
\ No newline at end of file
+
+BlockTypeRegistry::BlockTypeRegistry()
+{
+    Register("air", BlockType::Air, "Air");
+}
+
+BlockId BlockTypeRegistry::Register(const std::string &id, const BlockType type, const std::string &name)
+{
+    if (const auto it = m_Ids.find(id); it != m_Ids.end())
+        return it->second;
+
+    if (m_Blocks.size() > std::numeric_limits<BlockId>::max())
+    {
+        std::cerr << "Block registry full, can't register " << id << std::endl;
+        return BLOCK_AIR;
+    }
+
+    auto block = std::make_unique<Block>(id, type);
+    block->Name = name.empty() ? id : name;
+
+    uint8_t flags = BlockFlag_None;
+    if (block->IsSolid())
+        flags |= BlockFlag_Solid;
+    if (block->IsTransparent())
+        flags |= BlockFlag_Transparent;
+    if (type == BlockType::Water)
+        flags |= BlockFlag_Fluid;
+
+    const auto blockId = static_cast<BlockId>(m_Blocks.size());
+    m_Blocks.push_back(std::move(block));
+    m_Flags.push_back(flags);
+    m_LightEmission.push_back(0);
+    m_Ids.emplace(id, blockId);
+    return blockId;
+}
+
+void BlockTypeRegistry::SetLightEmission(const BlockId id, const uint8_t level)
+{
+    m_Blocks[id]->LightEmission = std::min(level, MAX_LIGHT_LEVEL);
+    m_LightEmission[id] = m_Blocks[id]->LightEmission;
+}
+
+BlockId BlockTypeRegistry::Find(const std::string &id) const
+{
+    const auto it = m_Ids.find(id);
+    return it != m_Ids.end() ? it->second : BLOCK_AIR;
+}
+
+} // BloxxEngine
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/World/BlockTicker.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+constexpr int NeighbourOffsets[7][3] = {
+    {0, 0, 0}, {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1},
+};
+
+uint64_t SplitMix64(uint64_t &state)
+{
+    uint64_t z = state += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Sections of the same colour are at least two sections apart on every axis
+int Colour(const int sectionX, const int sectionY, const int sectionZ)
+{
+    return (sectionX & 1) | (sectionY & 1) << 1 | (sectionZ & 1) << 2;
+}
+} // namespace
+
+BlockTickContext::BlockTickContext(const World &world, Chunk &chunk, const int sectionY, const uint64_t tick,
+                                   const uint64_t seed, Output &output)
+    : m_World(world), m_Chunk(chunk),
+      m_Origin(chunk.GetChunkX() * CHUNK_WIDTH, sectionY * SECTION_SIZE, chunk.GetChunkZ() * CHUNK_DEPTH),
+      m_Tick(tick), m_RandomState(seed), m_Output(output)
+{
+}
+
+bool BlockTickContext::IsInSection(const int x, const int y, const int z) const
+{
+    return x >= m_Origin.x && x < m_Origin.x + SECTION_SIZE && y >= m_Origin.y && y < m_Origin.y + SECTION_SIZE &&
+           z >= m_Origin.z && z < m_Origin.z + SECTION_SIZE;
+}
+
+BlockId BlockTickContext::GetBlock(const int x, const int y, const int z) const
+{
+    if (IsInSection(x, y, z))
+        return m_Chunk.GetBlock(x - m_Origin.x, y, z - m_Origin.z);
+    return m_World.GetBlock(x, y, z);
+}
+
+uint8_t BlockTickContext::GetMetadata(const int x, const int y, const int z) const
+{
+    if (IsInSection(x, y, z))
+        return m_Chunk.GetMetadata(x - m_Origin.x, y, z - m_Origin.z);
+    return m_World.GetMetadata(x, y, z);
+}
+
+void BlockTickContext::SetBlock(const int x, const int y, const int z, const BlockId id, const uint8_t metadata)
+{
+    if (!IsInSection(x, y, z))
+    {
+        m_Output.Deferred.push_back({x, y, z, id, metadata});
+        return;
+    }
+
+    const BlockId previous = m_Chunk.GetBlock(x - m_Origin.x, y, z - m_Origin.z);
+    if (previous == id && m_Chunk.GetMetadata(x - m_Origin.x, y, z - m_Origin.z) == metadata)
+        return;
+
+    m_Chunk.SetBlock(x - m_Origin.x, y, z - m_Origin.z, id, metadata);
+    m_Output.Changes.push_back({x, y, z, previous, id});
+}
+
+void BlockTickContext::ScheduleTick(const int x, const int y, const int z, const uint32_t delay)
+{
+    m_Output.Requests.push_back({x, y, z, delay});
+}
+
+uint32_t BlockTickContext::Random()
+{
+    return static_cast<uint32_t>(SplitMix64(m_RandomState) >> 32);
+}
+
+BlockTicker::BlockTicker(World &world) : m_World(world)
+{
+}
+
+void BlockTicker::SetScheduledTickHandler(const BlockId id, TickHandler handler)
+{
+    if (m_ScheduledHandlers.size() <= id)
+        m_ScheduledHandlers.resize(id + 1);
+    m_ScheduledHandlers[id] = std::move(handler);
+}
+
+void BlockTicker::SetRandomTickHandler(const BlockId id, TickHandler handler)
+{
+    if (m_RandomHandlers.size() <= id)
+        m_RandomHandlers.resize(id + 1);
+    m_RandomHandlers[id] = std::move(handler);
+    m_HasRandomHandlers = std::ranges::any_of(m_RandomHandlers, [](const TickHandler &h) { return h != nullptr; });
+}
+
+const BlockTicker::TickHandler *BlockTicker::GetHandler(const std::vector<TickHandler> &handlers, const BlockId id)
+{
+    return id < handlers.size() && handlers[id] ? &handlers[id] : nullptr;
+}
+
+void BlockTicker::Update(const float deltaTime)
+{
+    m_Accumulator += deltaTime;
+    if (m_Accumulator < m_Settings.TickInterval)
+        return;
+
+    // Never more than one tick per update, a backlog just slows the world down
+    m_Accumulator = std::min(m_Accumulator - m_Settings.TickInterval, m_Settings.TickInterval);
+    Tick();
+}
+
+void BlockTicker::ScheduleTick(const int x, const int y, const int z, const uint32_t delay)
+{
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return;
+
+    const BlockId id = m_World.GetBlock(x, y, z);
+    if (!GetHandler(m_ScheduledHandlers, id))
+        return;
+
+    auto &scheduled = m_Scheduled[World::SectionKey(x >> SECTION_SHIFT, y >> SECTION_SHIFT, z >> SECTION_SHIFT)];
+    const auto index =
+        static_cast<uint16_t>(ChunkSection::Index(x & SECTION_MASK, y & SECTION_MASK, z & SECTION_MASK));
+    if (!scheduled.Queued.insert(SectionQueue::QueuedKey(index, id)).second)
+        return;
+
+    scheduled.Ticks.push_back({m_Tick + std::max(delay, 1u), index, id});
+    std::ranges::push_heap(scheduled.Ticks, std::greater{}, [](const ScheduledTick &tick) {
+        return std::pair(tick.Due, tick.Index);
+    });
+    m_ScheduledCount++;
+}
+
+void BlockTicker::OnBlockChanged(const int x, const int y, const int z)
+{
+    if (m_ScheduledHandlers.empty())
+        return;
+
+    for (const auto &offset : NeighbourOffsets)
+        ScheduleTick(x + offset[0], y + offset[1], z + offset[2], 1);
+}
+
+void BlockTicker::Tick()
+{
+    m_Tick++;
+    if (m_Scheduled.empty() && !m_HasRandomHandlers)
+    {
+        m_LastTickCount = 0;
+        m_LastTickTime = 0.0;
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    GatherSections();
+
+    std::atomic<size_t> handled{0};
+    for (const auto &phase : m_Phases)
+    {
+        if (phase.empty())
+            continue;
+
+        // No two sections of a phase touch, each one runs on its own without locking
+        if (m_Outputs.size() < phase.size())
+            m_Outputs.resize(phase.size());
+        auto run = [&](const size_t begin, const size_t end) {
+            size_t count = 0;
+            for (size_t i = begin; i < end; i++)
+                count += RunSection(phase[i], m_Outputs[i]);
+            handled += count;
+        };
+        if (ThreadPool *threadPool = m_World.GetThreadPool())
+            threadPool->ParallelFor(phase.size(), 8, run);
+        else
+            run(0, phase.size());
+
+        // Queued in section order, so the outcome doesn't depend on the thread count. The next phase sees the
+        // changes of this one.
+        for (size_t i = 0; i < phase.size(); i++)
+        {
+            const BlockTickContext::Output &output = m_Outputs[i];
+            for (const auto &change : output.Changes)
+                m_World.OnBlockChanged(change.X, change.Y, change.Z, change.Previous, change.Id);
+            for (const auto &write : output.Deferred)
+                m_World.SetBlock(write.X, write.Y, write.Z, write.Id, write.Metadata);
+            for (const auto &request : output.Requests)
+                ScheduleTick(request.X, request.Y, request.Z, request.Delay);
+        }
+    }
+
+    // Queues that ran dry, or whose chunk was unloaded, are dropped
+    m_ScheduledCount = 0;
+    std::erase_if(m_Scheduled, [this](const auto &entry) {
+        const auto &[key, scheduled] = entry;
+        const glm::ivec3 section = World::UnpackSectionKey(key);
+        if (scheduled.Ticks.empty() || !m_World.GetChunk(section.x, section.z))
+            return true;
+        m_ScheduledCount += scheduled.Ticks.size();
+        return false;
+    });
+
+    m_LastTickCount = handled;
+    m_LastTickTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BlockTicker::GatherSections()
+{
+    for (auto &phase : m_Phases)
+        phase.clear();
+
+    m_World.ForEachChunk([this](Chunk &chunk) {
+        for (int sectionY = 0; sectionY < CHUNK_SECTION_COUNT; sectionY++)
+        {
+            const uint64_t key = World::SectionKey(chunk.GetChunkX(), sectionY, chunk.GetChunkZ());
+
+            SectionQueue *scheduled = nullptr;
+            if (!m_Scheduled.empty())
+            {
+                const auto it = m_Scheduled.find(key);
+                if (it != m_Scheduled.end() && !it->second.Ticks.empty() && it->second.Ticks.front().Due <= m_Tick)
+                    scheduled = &it->second;
+            }
+
+            // Random ticks only ever pick blocks, empty sections have nothing to pick
+            const ChunkSection *section = chunk.GetSection(sectionY);
+            if (!scheduled && !(m_HasRandomHandlers && section && !section->IsEmpty()))
+                continue;
+
+            m_Phases[Colour(chunk.GetChunkX(), sectionY, chunk.GetChunkZ())].push_back(
+                {key, &chunk, sectionY, scheduled});
+        }
+    });
+
+    // Chunks come out of the hash map in any order
+    for (auto &phase : m_Phases)
+        std::ranges::sort(phase, {}, &SectionWork::Key);
+}
+
+size_t BlockTicker::RunSection(const SectionWork &work, BlockTickContext::Output &output)
+{
+    output.Changes.clear();
+    output.Deferred.clear();
+    output.Requests.clear();
+
+    uint64_t seed = work.Key ^ m_Tick * 0xd6e8feb86659fd93ull;
+    BlockTickContext context(m_World, *work.Column, work.SectionY, m_Tick, SplitMix64(seed), output);
+    auto position = [&context](const int index) {
+        return context.m_Origin + glm::ivec3(index & SECTION_MASK, index >> (2 * SECTION_SHIFT),
+                                             index >> SECTION_SHIFT & SECTION_MASK);
+    };
+
+    size_t count = 0;
+    if (work.Scheduled)
+    {
+        // The handlers queue their follow-up ticks in the output, so the queue only shrinks here
+        auto &scheduled = *work.Scheduled;
+        auto order = [](const ScheduledTick &tick) { return std::pair(tick.Due, tick.Index); };
+        while (!scheduled.Ticks.empty() && scheduled.Ticks.front().Due <= m_Tick)
+        {
+            std::ranges::pop_heap(scheduled.Ticks, std::greater{}, order);
+            const ScheduledTick tick = scheduled.Ticks.back();
+            scheduled.Ticks.pop_back();
+            scheduled.Queued.erase(SectionQueue::QueuedKey(tick.Index, tick.Id));
+
+            const glm::ivec3 blockPosition = position(tick.Index);
+            if (context.GetBlock(blockPosition.x, blockPosition.y, blockPosition.z) != tick.Id)
+                continue;
+            if (const TickHandler *handler = GetHandler(m_ScheduledHandlers, tick.Id))
+            {
+                (*handler)(context, blockPosition);
+                count++;
+            }
+        }
+    }
+
+    // Sections are never freed by a write, so the section stays valid while its handlers run
+    const ChunkSection *section = work.Column->GetSection(work.SectionY);
+    if (m_HasRandomHandlers && section)
+    {
+        for (int i = 0; i < m_Settings.RandomTicksPerSection && !section->IsEmpty(); i++)
+        {
+            const int index = static_cast<int>(context.Random() % SECTION_VOLUME);
+            if (const TickHandler *handler = GetHandler(m_RandomHandlers, section->Blocks[index]))
+            {
+                (*handler)(context, position(index));
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+} // namespace BloxxEngine
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/World/Collision.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+// Boxes touching a voxel face are not inside it, this keeps resting contacts from blocking sideways movement
+constexpr float Skin = 1e-4f;
+
+// Sweeps touch few chunks but many voxels, so the last chunk is kept around
+class SolidLookup
+{
+  public:
+    explicit SolidLookup(const World &world) : m_World(world), m_Registry(world.GetBlockRegistry())
+    {
+    }
+
+    bool IsSolid(const int x, const int y, const int z)
+    {
+        if (y < 0 || y >= CHUNK_HEIGHT)
+            return false;
+
+        const int chunkX = World::ToChunkCoordinate(x);
+        const int chunkZ = World::ToChunkCoordinate(z);
+        if (!m_HasChunk || chunkX != m_ChunkX || chunkZ != m_ChunkZ)
+        {
+            m_Chunk = m_World.GetChunk(chunkX, chunkZ);
+            m_ChunkX = chunkX;
+            m_ChunkZ = chunkZ;
+            m_HasChunk = true;
+        }
+
+        return m_Chunk && m_Registry.IsSolid(m_Chunk->GetBlock(x & SECTION_MASK, y, z & SECTION_MASK));
+    }
+
+  private:
+    const World &m_World;
+    const BlockTypeRegistry &m_Registry;
+    const Chunk *m_Chunk = nullptr;
+    int m_ChunkX = 0, m_ChunkZ = 0;
+    bool m_HasChunk = false;
+};
+
+int FloorToInt(const float value)
+{
+    return static_cast<int>(std::floor(value));
+}
+
+bool IsLayerBlocked(SolidLookup &solids, const int axis, const int layer, const glm::ivec3 &begin, const glm::ivec3 &end)
+{
+    const int u = (axis + 1) % 3;
+    const int v = (axis + 2) % 3;
+
+    glm::ivec3 voxel;
+    voxel[axis] = layer;
+    for (voxel[u] = begin[u]; voxel[u] <= end[u]; voxel[u]++)
+    {
+        for (voxel[v] = begin[v]; voxel[v] <= end[v]; voxel[v]++)
+        {
+            if (solids.IsSolid(voxel.x, voxel.y, voxel.z))
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns how far the box can move along the axis, checking every voxel layer between the start and end position
+ * nearest first. Voxels the box already overlaps are ignored, so a body stuck in a block can still move out.
+ */
+float SweepAxis(SolidLookup &solids, const glm::vec3 &min, const glm::vec3 &max, const int axis, const float delta)
+{
+    if (delta == 0.0f)
+        return 0.0f;
+
+    // Cross section of the box in voxels, shrunk by the skin so face contacts on the sides don't count
+    const glm::ivec3 begin(FloorToInt(min.x + Skin), FloorToInt(min.y + Skin), FloorToInt(min.z + Skin));
+    const glm::ivec3 end(FloorToInt(max.x - Skin), FloorToInt(max.y - Skin), FloorToInt(max.z - Skin));
+
+    if (delta > 0.0f)
+    {
+        const int last = FloorToInt(max[axis] + delta);
+        for (int layer = FloorToInt(max[axis]); layer <= last; layer++)
+        {
+            if (static_cast<float>(layer) < max[axis] - Skin)
+                continue;
+            if (IsLayerBlocked(solids, axis, layer, begin, end))
+                return std::max(0.0f, static_cast<float>(layer) - max[axis]);
+        }
+    }
+    else
+    {
+        const int last = FloorToInt(min[axis] + delta);
+        for (int layer = FloorToInt(min[axis]); layer >= last; layer--)
+        {
+            if (static_cast<float>(layer + 1) > min[axis] + Skin)
+                continue;
+            if (IsLayerBlocked(solids, axis, layer, begin, end))
+                return std::min(0.0f, static_cast<float>(layer + 1) - min[axis]);
+        }
+    }
+
+    return delta;
+}
+
+uint8_t MoveBody(SolidLookup &solids, glm::vec3 &position, const glm::vec3 &halfExtents, glm::vec3 &velocity,
+                 const float deltaTime)
+{
+    const glm::vec3 delta = velocity * deltaTime;
+    glm::vec3 min = position - halfExtents;
+    glm::vec3 max = position + halfExtents;
+    uint8_t contacts = CollisionContact_None;
+
+    // Vertical first, so bodies walking on the ground aren't caught on the voxel edges they stand on
+    constexpr int axisOrder[3] = {1, 0, 2};
+    for (const int axis : axisOrder)
+    {
+        const float moved = SweepAxis(solids, min, max, axis, delta[axis]);
+        if (moved != delta[axis])
+        {
+            velocity[axis] = 0.0f;
+            if (axis == 1)
+                contacts |= delta[axis] < 0.0f ? CollisionContact_Ground : CollisionContact_Ceiling;
+            else
+                contacts |= axis == 0 ? CollisionContact_WallX : CollisionContact_WallZ;
+        }
+
+        min[axis] += moved;
+        max[axis] += moved;
+    }
+
+    position = min + halfExtents;
+    return contacts;
+}
+} // namespace
+
+size_t CollisionBodies::Add(const glm::vec3 &position, const glm::vec3 &halfExtents, const glm::vec3 &velocity)
+{
+    PositionX.push_back(position.x);
+    PositionY.push_back(position.y);
+    PositionZ.push_back(position.z);
+    VelocityX.push_back(velocity.x);
+    VelocityY.push_back(velocity.y);
+    VelocityZ.push_back(velocity.z);
+    HalfExtentX.push_back(halfExtents.x);
+    HalfExtentY.push_back(halfExtents.y);
+    HalfExtentZ.push_back(halfExtents.z);
+    Contacts.push_back(CollisionContact_None);
+    return PositionX.size() - 1;
+}
+
+void CollisionBodies::Clear()
+{
+    for (auto *stream : {&PositionX, &PositionY, &PositionZ, &VelocityX, &VelocityY, &VelocityZ, &HalfExtentX,
+                         &HalfExtentY, &HalfExtentZ})
+        stream->clear();
+    Contacts.clear();
+}
+
+CollisionSystem::CollisionSystem(const World &world) : m_World(world)
+{
+}
+
+void CollisionSystem::Step(CollisionBodies &bodies, const float deltaTime, ThreadPool &threadPool) const
+{
+    // Bodies don't interact with each other, so any split over the workers gives the same result
+    threadPool.ParallelFor(bodies.GetCount(), 256, [this, &bodies, deltaTime](const size_t begin, const size_t end) {
+        StepRange(bodies, begin, end, deltaTime);
+    });
+}
+
+uint8_t CollisionSystem::Move(glm::vec3 &position, const glm::vec3 &halfExtents, glm::vec3 &velocity,
+                              const float deltaTime) const
+{
+    SolidLookup solids(m_World);
+    return MoveBody(solids, position, halfExtents, velocity, deltaTime);
+}
+
+void CollisionSystem::StepRange(CollisionBodies &bodies, const size_t begin, const size_t end,
+                                const float deltaTime) const
+{
+    SolidLookup solids(m_World);
+    for (size_t i = begin; i < end; i++)
+    {
+        glm::vec3 position(bodies.PositionX[i], bodies.PositionY[i], bodies.PositionZ[i]);
+        glm::vec3 velocity(bodies.VelocityX[i], bodies.VelocityY[i], bodies.VelocityZ[i]);
+        const glm::vec3 halfExtents(bodies.HalfExtentX[i], bodies.HalfExtentY[i], bodies.HalfExtentZ[i]);
+
+        bodies.Contacts[i] = MoveBody(solids, position, halfExtents, velocity, deltaTime);
+
+        bodies.PositionX[i] = position.x;
+        bodies.PositionY[i] = position.y;
+        bodies.PositionZ[i] = position.z;
+        bodies.VelocityX[i] = velocity.x;
+        bodies.VelocityY[i] = velocity.y;
+        bodies.VelocityZ[i] = velocity.z;
+    }
+}
+
+} // namespace BloxxEngine
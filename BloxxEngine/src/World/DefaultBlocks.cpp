@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/World/DefaultBlocks.h"
+
+#include "BloxxEngine/World/World.h"
+
+namespace BloxxEngine {
+
+TerrainGenerator::Settings RegisterDefaultBlocks(World &world)
+{
+    auto &registry = world.GetBlockRegistry();
+    TerrainGenerator::Settings settings;
+    settings.Stone = registry.Register("stone", BlockType::Solid, "Stone");
+    settings.Dirt = registry.Register("dirt", BlockType::Solid, "Dirt");
+    settings.Grass = registry.Register("grass", BlockType::Solid, "Grass");
+    settings.Water = registry.Register("water", BlockType::Water, "Water");
+
+    // Grass that ends up under an opaque block dies off to dirt
+    world.GetBlockTicker().SetRandomTickHandler(
+        settings.Grass, [&registry, dirt = settings.Dirt](BlockTickContext &context, const glm::ivec3 &position) {
+            if (!registry.IsTransparent(context.GetBlock(position.x, position.y + 1, position.z)))
+                context.SetBlock(position.x, position.y, position.z, dirt);
+        });
+    return settings;
+}
+
+} // namespace BloxxEngine
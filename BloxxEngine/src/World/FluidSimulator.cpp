@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/World/FluidSimulator.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+constexpr int HorizontalOffsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+// The strongest of two flows into the same cell wins: falling fluid, then the lowest level
+int FlowStrength(const uint8_t metadata)
+{
+    return metadata & FLUID_FALLING ? FLUID_MAX_LEVEL + 1 : FLUID_MAX_LEVEL - (metadata & FLUID_LEVEL_MASK);
+}
+} // namespace
+
+FluidSimulator::FluidSimulator(World &world) : m_World(world)
+{
+}
+
+void FluidSimulator::Update(const float deltaTime)
+{
+    if (m_Active.empty())
+    {
+        m_Accumulator = 0.0f;
+        return;
+    }
+
+    m_Accumulator += deltaTime;
+    if (m_Accumulator < m_Settings.StepInterval)
+        return;
+
+    // Never more than one step per update, a backlog just makes the flow slower
+    m_Accumulator = std::min(m_Accumulator - m_Settings.StepInterval, m_Settings.StepInterval);
+    Step();
+}
+
+void FluidSimulator::OnBlockChanged(const int x, const int y, const int z)
+{
+    Activate(x, y, z);
+    Activate(x + 1, y, z);
+    Activate(x - 1, y, z);
+    Activate(x, y + 1, z);
+    Activate(x, y - 1, z);
+    Activate(x, y, z + 1);
+    Activate(x, y, z - 1);
+}
+
+void FluidSimulator::Activate(const int x, const int y, const int z)
+{
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return;
+
+    // Only fluid cells do anything when evaluated, air next to them is filled by their spreading
+    if (!(m_World.GetBlockRegistry().GetFlags(m_World.GetBlock(x, y, z)) & BlockFlag_Fluid))
+        return;
+
+    m_Active[World::SectionKey(x >> SECTION_SHIFT, y >> SECTION_SHIFT, z >> SECTION_SHIFT)].push_back(
+        static_cast<uint16_t>(ChunkSection::Index(x & SECTION_MASK, y & SECTION_MASK, z & SECTION_MASK)));
+    m_ActiveCellCount++;
+}
+
+void FluidSimulator::Step()
+{
+    // Without active cells there is nothing to evaluate, and the changes of the previous step must not be applied again
+    if (m_Active.empty())
+    {
+        m_LastStepTime = 0.0;
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // Sorted so the same edits always produce the same flow, whatever order the hash map has
+    m_Sections.clear();
+    for (auto &[key, cells] : m_Active)
+        m_Sections.emplace_back(key, std::move(cells));
+    m_Active.clear();
+    std::ranges::sort(m_Sections, {}, &std::pair<uint64_t, std::vector<uint16_t>>::first);
+
+    // Take whole sections up to the cell budget, the rest waits for the next step
+    size_t taken = 0;
+    size_t cellCount = 0;
+    for (; taken < m_Sections.size() && (taken == 0 || cellCount < m_Settings.MaxCellsPerStep); taken++)
+    {
+        auto &cells = m_Sections[taken].second;
+        std::ranges::sort(cells);
+        cells.erase(std::ranges::unique(cells).begin(), cells.end());
+        cellCount += cells.size();
+    }
+    m_ActiveCellCount = 0;
+    for (size_t i = taken; i < m_Sections.size(); i++)
+    {
+        m_ActiveCellCount += m_Sections[i].second.size();
+        m_Active.emplace(m_Sections[i].first, std::move(m_Sections[i].second));
+    }
+
+    // Evaluate: sections only read the world, so they can run side by side
+    if (m_Changes.size() < taken)
+        m_Changes.resize(taken);
+    auto evaluate = [this](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            m_Changes[i].clear();
+            EvaluateSection(m_Sections[i].first, m_Sections[i].second, m_Changes[i]);
+        }
+    };
+    if (ThreadPool *threadPool = m_World.GetThreadPool())
+        threadPool->ParallelFor(taken, 4, evaluate);
+    else
+        evaluate(0, taken);
+
+    // Apply: flows from different sections can target the same cell, the strongest one wins
+    std::vector<FluidChange> &merged = m_Changes[0];
+    for (size_t i = 1; i < taken; i++)
+        merged.insert(merged.end(), m_Changes[i].begin(), m_Changes[i].end());
+    std::ranges::sort(merged, [](const FluidChange &a, const FluidChange &b) {
+        if (a.X != b.X)
+            return a.X < b.X;
+        if (a.Y != b.Y)
+            return a.Y < b.Y;
+        if (a.Z != b.Z)
+            return a.Z < b.Z;
+        return FlowStrength(a.Metadata) > FlowStrength(b.Metadata);
+    });
+    for (size_t i = 0; i < merged.size(); i++)
+    {
+        const FluidChange &change = merged[i];
+        if (i > 0 && merged[i - 1].X == change.X && merged[i - 1].Y == change.Y && merged[i - 1].Z == change.Z)
+            continue;
+
+        // Activates the changed cells for the next step
+        m_World.SetBlock(change.X, change.Y, change.Z, change.Id, change.Metadata);
+    }
+
+    m_LastStepTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void FluidSimulator::EvaluateSection(const uint64_t sectionKey, std::vector<uint16_t> &cells,
+                                     std::vector<FluidChange> &changes) const
+{
+    const BlockTypeRegistry &registry = m_World.GetBlockRegistry();
+    const glm::ivec3 section = World::UnpackSectionKey(sectionKey);
+    const int originX = section.x * SECTION_SIZE;
+    const int originY = section.y * SECTION_SIZE;
+    const int originZ = section.z * SECTION_SIZE;
+
+    // Air and the same fluid don't hold fluid up
+    auto isPassable = [this](const BlockId fluid, const int x, const int y, const int z) {
+        if (y < 0)
+            return false;
+        const BlockId below = m_World.GetBlock(x, y, z);
+        return below == BLOCK_AIR || below == fluid;
+    };
+
+    for (const uint16_t cell : cells)
+    {
+        const int x = originX + (cell & SECTION_MASK);
+        const int z = originZ + (cell >> SECTION_SHIFT & SECTION_MASK);
+        const int y = originY + (cell >> (2 * SECTION_SHIFT));
+
+        const BlockId id = m_World.GetBlock(x, y, z);
+        if (!(registry.GetFlags(id) & BlockFlag_Fluid))
+            continue;
+
+        const uint8_t metadata = m_World.GetMetadata(x, y, z);
+        uint8_t newMetadata = metadata;
+
+        // Flowing fluid takes its level from the strongest neighbour feeding it, or dries up without one
+        const bool source = metadata == 0;
+        if (!source)
+        {
+            if (m_World.GetBlock(x, y + 1, z) == id)
+            {
+                newMetadata = FLUID_FALLING;
+            }
+            else
+            {
+                int feedLevel = FLUID_MAX_LEVEL + 1;
+                for (const auto &offset : HorizontalOffsets)
+                {
+                    const int nx = x + offset[0];
+                    const int nz = z + offset[1];
+                    if (m_World.GetBlock(nx, y, nz) != id || isPassable(id, nx, y - 1, nz))
+                        continue;
+
+                    const uint8_t neighbour = m_World.GetMetadata(nx, y, nz);
+                    feedLevel = std::min(feedLevel, neighbour & FLUID_FALLING ? 0 : neighbour & FLUID_LEVEL_MASK);
+                }
+
+                if (feedLevel >= FLUID_MAX_LEVEL)
+                {
+                    changes.push_back({x, y, z, BLOCK_AIR, 0});
+                    continue;
+                }
+                newMetadata = static_cast<uint8_t>(feedLevel + 1);
+            }
+        }
+        if (newMetadata != metadata)
+            changes.push_back({x, y, z, id, newMetadata});
+
+        // Fall first, only fluid resting on something spreads sideways
+        if (y > 0 && m_World.GetBlock(x, y - 1, z) == BLOCK_AIR)
+        {
+            changes.push_back({x, y - 1, z, id, FLUID_FALLING});
+            continue;
+        }
+        if (isPassable(id, x, y - 1, z))
+            continue;
+
+        const int level = newMetadata & FLUID_FALLING ? 0 : newMetadata & FLUID_LEVEL_MASK;
+        if (level >= FLUID_MAX_LEVEL)
+            continue;
+        for (const auto &offset : HorizontalOffsets)
+        {
+            if (m_World.GetBlock(x + offset[0], y, z + offset[1]) == BLOCK_AIR)
+                changes.push_back({x + offset[0], y, z + offset[1], id, static_cast<uint8_t>(level + 1)});
+        }
+    }
+}
+
+} // namespace BloxxEngine
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/World/LightEngine.h"
+
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+constexpr int NeighbourOffsets[6][3] = {
+    {1, 0, 0}, {-1, 0, 0}, {0, 0, 1}, {0, 0, -1}, {0, 1, 0}, {0, -1, 0},
+};
+constexpr int Down = 5;
+
+uint8_t DefaultLevel(const bool sky)
+{
+    return sky ? MAX_LIGHT_LEVEL : 0;
+}
+} // namespace
+
+LightEngine::LightEngine(World &world) : m_World(world)
+{
+}
+
+bool LightEngine::Find(const int x, const int y, const int z, ChunkSection *&section)
+{
+    section = nullptr;
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return false;
+
+    const int chunkX = World::ToChunkCoordinate(x);
+    const int chunkZ = World::ToChunkCoordinate(z);
+    if (!m_CachedChunk || chunkX != m_CachedChunkX || chunkZ != m_CachedChunkZ)
+    {
+        m_CachedChunk = m_World.GetChunk(chunkX, chunkZ);
+        m_CachedChunkX = chunkX;
+        m_CachedChunkZ = chunkZ;
+        if (!m_CachedChunk)
+            return false;
+    }
+
+    section = m_CachedChunk->GetSection(y >> SECTION_SHIFT);
+    return true;
+}
+
+uint8_t LightEngine::GetLight(const Channel channel, const int x, const int y, const int z, bool &loaded)
+{
+    ChunkSection *section;
+    loaded = Find(x, y, z, section);
+    if (!section)
+        return DefaultLevel(channel == Channel::Sky);
+
+    const int index = ChunkSection::Index(x & SECTION_MASK, y & SECTION_MASK, z & SECTION_MASK);
+    return channel == Channel::Sky ? section->GetSkyLight(index) : section->GetBlockLight(index);
+}
+
+void LightEngine::SetLight(const Channel channel, const int x, const int y, const int z, const uint8_t level)
+{
+    ChunkSection *section;
+    if (!Find(x, y, z, section))
+        return;
+
+    if (!section)
+    {
+        // Missing sections already read as the default level, only allocate when that changes
+        if (level == DefaultLevel(channel == Channel::Sky))
+            return;
+        section = &m_CachedChunk->GetOrCreateSection(y >> SECTION_SHIFT);
+    }
+
+    const int index = ChunkSection::Index(x & SECTION_MASK, y & SECTION_MASK, z & SECTION_MASK);
+    if (channel == Channel::Sky)
+        section->SetSkyLight(index, level);
+    else
+        section->SetBlockLight(index, level);
+    m_LastUpdateCount++;
+}
+
+void LightEngine::LightChunk(const int chunkX, const int chunkZ)
+{
+    m_CachedChunk = nullptr;
+    Chunk *chunk = m_World.GetChunk(chunkX, chunkZ);
+    if (!chunk)
+        return;
+
+    const auto &registry = m_World.GetBlockRegistry();
+
+    // Everything above the highest non-empty section of this chunk and its neighbours keeps the default full sky
+    // light, so only the part below that has to be seeded
+    auto topOf = [](const Chunk *column) {
+        for (int index = CHUNK_SECTION_COUNT - 1; column && index >= 0; index--)
+        {
+            const ChunkSection *section = column->GetSection(index);
+            if (section && !section->IsEmpty())
+                return (index + 1) * SECTION_SIZE;
+        }
+        return 0;
+    };
+    const Chunk *neighbours[4] = {
+        m_World.GetChunk(chunkX + 1, chunkZ),
+        m_World.GetChunk(chunkX - 1, chunkZ),
+        m_World.GetChunk(chunkX, chunkZ + 1),
+        m_World.GetChunk(chunkX, chunkZ - 1),
+    };
+    int top = topOf(chunk);
+    for (const Chunk *neighbour : neighbours)
+        top = std::max(top, topOf(neighbour));
+    top = std::min(top, CHUNK_HEIGHT - 1);
+
+    const int originX = chunkX * CHUNK_WIDTH;
+    const int originZ = chunkZ * CHUNK_DEPTH;
+    for (int z = 0; z < CHUNK_DEPTH; z++)
+    {
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+        {
+            // Full sky light down to the first opaque block of the column, dark below it
+            bool open = true;
+            for (int y = top; y >= 0; y--)
+            {
+                const BlockId id = chunk->GetBlock(x, y, z);
+                open = open && registry.IsTransparent(id);
+
+                const int worldX = originX + x;
+                const int worldZ = originZ + z;
+                SetLight(Channel::Sky, worldX, y, worldZ, open ? MAX_LIGHT_LEVEL : 0);
+                if (open)
+                    m_SkyAddQueue.Push({worldX, y, worldZ, MAX_LIGHT_LEVEL});
+
+                if (const uint8_t emission = registry.GetLightEmission(id); emission > 0)
+                {
+                    SetLight(Channel::Block, worldX, y, worldZ, emission);
+                    m_BlockAddQueue.Push({worldX, y, worldZ, emission});
+                }
+            }
+        }
+    }
+
+    // Let the light of the loaded neighbours flow in across the shared borders
+    for (int side = 0; side < 4; side++)
+    {
+        if (!neighbours[side])
+            continue;
+
+        const int *offset = NeighbourOffsets[side];
+        for (int i = 0; i < SECTION_SIZE; i++)
+        {
+            // The border column of the neighbour that faces this chunk
+            const int x = offset[0] > 0 ? originX + CHUNK_WIDTH : offset[0] < 0 ? originX - 1 : originX + i;
+            const int z = offset[2] > 0 ? originZ + CHUNK_DEPTH : offset[2] < 0 ? originZ - 1 : originZ + i;
+            for (int y = 0; y <= top; y++)
+            {
+                bool loaded;
+                if (const uint8_t sky = GetLight(Channel::Sky, x, y, z, loaded); loaded && sky > 0)
+                    m_SkyAddQueue.Push({x, y, z, sky});
+                if (const uint8_t block = GetLight(Channel::Block, x, y, z, loaded); loaded && block > 0)
+                    m_BlockAddQueue.Push({x, y, z, block});
+            }
+        }
+    }
+}
+
+void LightEngine::OnBlockChanged(const int x, const int y, const int z, const BlockId previous, const BlockId current)
+{
+    m_CachedChunk = nullptr;
+    const auto &registry = m_World.GetBlockRegistry();
+    const bool transparent = registry.IsTransparent(current);
+
+    bool loaded;
+    const uint8_t blockLight = GetLight(Channel::Block, x, y, z, loaded);
+    if (!loaded)
+        return;
+
+    // Light emitted by the old block, or passing through where there now is an opaque block, has to go first
+    if (blockLight > 0 && (!transparent || registry.GetLightEmission(previous) > 0))
+    {
+        SetLight(Channel::Block, x, y, z, 0);
+        m_BlockRemoveQueue.Push({x, y, z, blockLight});
+    }
+    if (const uint8_t skyLight = GetLight(Channel::Sky, x, y, z, loaded); !transparent && skyLight > 0)
+    {
+        SetLight(Channel::Sky, x, y, z, 0);
+        m_SkyRemoveQueue.Push({x, y, z, skyLight});
+    }
+
+    if (const uint8_t emission = registry.GetLightEmission(current); emission > 0)
+    {
+        SetLight(Channel::Block, x, y, z, emission);
+        m_BlockAddQueue.Push({x, y, z, emission});
+    }
+
+    // Let the surrounding light flow into the opened up space
+    if (transparent)
+    {
+        for (const auto &offset : NeighbourOffsets)
+        {
+            const int nx = x + offset[0], ny = y + offset[1], nz = z + offset[2];
+            if (const uint8_t sky = GetLight(Channel::Sky, nx, ny, nz, loaded); loaded && sky > 0)
+                m_SkyAddQueue.Push({nx, ny, nz, sky});
+            if (const uint8_t block = GetLight(Channel::Block, nx, ny, nz, loaded); loaded && block > 0)
+                m_BlockAddQueue.Push({nx, ny, nz, block});
+        }
+    }
+}
+
+bool LightEngine::HasPendingWork() const
+{
+    return !m_SkyRemoveQueue.IsEmpty() || !m_SkyAddQueue.IsEmpty() || !m_BlockRemoveQueue.IsEmpty() ||
+           !m_BlockAddQueue.IsEmpty();
+}
+
+void LightEngine::Propagate()
+{
+    m_CachedChunk = nullptr;
+    m_LastUpdateCount = 0;
+
+    PropagateRemoval(Channel::Block, m_BlockRemoveQueue, m_BlockAddQueue);
+    PropagateAddition(Channel::Block, m_BlockAddQueue);
+    PropagateRemoval(Channel::Sky, m_SkyRemoveQueue, m_SkyAddQueue);
+    PropagateAddition(Channel::Sky, m_SkyAddQueue);
+
+    m_CachedChunk = nullptr;
+}
+
+void LightEngine::PropagateRemoval(const Channel channel, LightQueue &removeQueue, LightQueue &addQueue)
+{
+    const auto &registry = m_World.GetBlockRegistry();
+
+    while (!removeQueue.IsEmpty())
+    {
+        // Copied, pushing may reallocate the queue
+        const LightNode node = removeQueue.Pop();
+
+        for (int direction = 0; direction < 6; direction++)
+        {
+            const int x = node.X + NeighbourOffsets[direction][0];
+            const int y = node.Y + NeighbourOffsets[direction][1];
+            const int z = node.Z + NeighbourOffsets[direction][2];
+
+            bool loaded;
+            const uint8_t level = GetLight(channel, x, y, z, loaded);
+            if (!loaded || level == 0)
+                continue;
+
+            // Dimmer light came from the removed light, as did full sky light straight below removed full sky light
+            const bool skyColumn = channel == Channel::Sky && direction == Down && node.Level == MAX_LIGHT_LEVEL &&
+                                   level == MAX_LIGHT_LEVEL;
+            if (level < node.Level || skyColumn)
+            {
+                SetLight(channel, x, y, z, 0);
+                removeQueue.Push({x, y, z, level});
+
+                // Emitters inside the cleared region light up again
+                if (channel == Channel::Block)
+                {
+                    ChunkSection *section;
+                    Find(x, y, z, section);
+                    const BlockId id =
+                        section ? section->Blocks[ChunkSection::Index(x & SECTION_MASK, y & SECTION_MASK, z & SECTION_MASK)]
+                                : BLOCK_AIR;
+                    if (const uint8_t emission = registry.GetLightEmission(id); emission > 0)
+                    {
+                        SetLight(channel, x, y, z, emission);
+                        addQueue.Push({x, y, z, emission});
+                    }
+                }
+            }
+            else
+            {
+                // Light from another source borders the cleared region, spread it back in
+                addQueue.Push({x, y, z, level});
+            }
+        }
+    }
+    removeQueue.Reset();
+}
+
+void LightEngine::PropagateAddition(const Channel channel, LightQueue &addQueue)
+{
+    const auto &registry = m_World.GetBlockRegistry();
+
+    while (!addQueue.IsEmpty())
+    {
+        const LightNode node = addQueue.Pop();
+
+        // The level may have changed since the node was queued
+        bool loaded;
+        const uint8_t level = GetLight(channel, node.X, node.Y, node.Z, loaded);
+        if (!loaded || level <= 1)
+            continue;
+
+        for (int direction = 0; direction < 6; direction++)
+        {
+            const int x = node.X + NeighbourOffsets[direction][0];
+            const int y = node.Y + NeighbourOffsets[direction][1];
+            const int z = node.Z + NeighbourOffsets[direction][2];
+
+            ChunkSection *section;
+            if (!Find(x, y, z, section))
+                continue;
+
+            const int index = ChunkSection::Index(x & SECTION_MASK, y & SECTION_MASK, z & SECTION_MASK);
+            if (section && !registry.IsTransparent(section->Blocks[index]))
+                continue;
+
+            const uint8_t target = channel == Channel::Sky && direction == Down && level == MAX_LIGHT_LEVEL
+                                       ? MAX_LIGHT_LEVEL
+                                       : static_cast<uint8_t>(level - 1);
+            uint8_t current = DefaultLevel(channel == Channel::Sky);
+            if (section)
+                current = channel == Channel::Sky ? section->GetSkyLight(index) : section->GetBlockLight(index);
+            if (current >= target)
+                continue;
+
+            SetLight(channel, x, y, z, target);
+            addQueue.Push({x, y, z, target});
+        }
+    }
+    addQueue.Reset();
+}
+
+} // namespace BloxxEngine
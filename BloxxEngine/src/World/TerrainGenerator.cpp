@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/World/TerrainGenerator.h"
+
+#include "BloxxEngine/World/Chunk.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace BloxxEngine {
+
+// Integer hash of a lattice point, mapped to [0, 1)
+static float HashLattice(const int x, const int z, const uint32_t seed)
+{
+    uint32_t h = seed;
+    h ^= static_cast<uint32_t>(x) * 0x27d4eb2du;
+    h ^= static_cast<uint32_t>(z) * 0x165667b1u;
+    h = (h ^ (h >> 15)) * 0x2c1b3c6du;
+    h = (h ^ (h >> 12)) * 0x297a2d39u;
+    h ^= h >> 15;
+    return static_cast<float>(h >> 8) * (1.0f / 16777216.0f);
+}
+
+TerrainGenerator::TerrainGenerator(const Settings &settings) : m_Settings(settings)
+{
+}
+
+float TerrainGenerator::ValueNoise(const float x, const float z, const uint32_t seed) const
+{
+    const float fx = std::floor(x);
+    const float fz = std::floor(z);
+    const int ix = static_cast<int>(fx);
+    const int iz = static_cast<int>(fz);
+
+    // Smoothstep between the four surrounding lattice values
+    const float tx = x - fx;
+    const float tz = z - fz;
+    const float sx = tx * tx * (3.0f - 2.0f * tx);
+    const float sz = tz * tz * (3.0f - 2.0f * tz);
+
+    const float a = HashLattice(ix, iz, seed);
+    const float b = HashLattice(ix + 1, iz, seed);
+    const float c = HashLattice(ix, iz + 1, seed);
+    const float d = HashLattice(ix + 1, iz + 1, seed);
+    return std::lerp(std::lerp(a, b, sx), std::lerp(c, d, sx), sz);
+}
+
+int TerrainGenerator::GetHeight(const int x, const int z) const
+{
+    // Four octaves of value noise, in [-1, 1]
+    float noise = 0.0f;
+    float amplitude = 0.5f;
+    float frequency = m_Settings.Scale;
+    for (uint32_t octave = 0; octave < 4; octave++)
+    {
+        noise += (ValueNoise(static_cast<float>(x) * frequency, static_cast<float>(z) * frequency,
+                             m_Settings.Seed + octave) * 2.0f - 1.0f) * amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    const int height = m_Settings.BaseHeight + static_cast<int>(noise * m_Settings.Amplitude * 2.0f);
+    return std::clamp(height, 1, CHUNK_HEIGHT - 1);
+}
+
+void TerrainGenerator::Generate(Chunk &chunk) const
+{
+    const int originX = chunk.GetChunkX() * CHUNK_WIDTH;
+    const int originZ = chunk.GetChunkZ() * CHUNK_DEPTH;
+
+    for (int z = 0; z < CHUNK_DEPTH; z++)
+    {
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+        {
+            const int height = GetHeight(originX + x, originZ + z);
+            const bool underwater = height < m_Settings.SeaLevel;
+
+            for (int y = 0; y <= height; y++)
+            {
+                BlockId id = m_Settings.Stone;
+                if (y == height)
+                    id = underwater ? m_Settings.Dirt : m_Settings.Grass;
+                else if (y >= height - 3)
+                    id = m_Settings.Dirt;
+                chunk.SetBlock(x, y, z, id);
+            }
+
+            for (int y = height + 1; y <= m_Settings.SeaLevel; y++)
+                chunk.SetBlock(x, y, z, m_Settings.Water);
+        }
+    }
+}
+
+} // namespace BloxxEngine
@@ -1,5 +1,3 @@
-
-
 /*
  * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
  * All rights reserved.
@@ -7,5 +5,415 @@
 
 #include "BloxxEngine/World/World.h"
 
+#include "BloxxEngine/Metrics.h"
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/WorldReplication.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <ranges>
+#include <utility>
+#include <vector>
+
 namespace BloxxEngine {
-} // BloxxEngine
\ No newline at end of file
+
+namespace
+{
+// Chunks in all worlds, a client's replica included
+Gauge &GetLoadedChunksGauge()
+{
+    static Gauge &gauge = Metrics::GetGauge("world.chunks_loaded");
+    return gauge;
+}
+} // namespace
+
+World::World(ThreadPool *threadPool) : m_ThreadPool(threadPool)
+{
+}
+
+World::~World()
+{
+    GetLoadedChunksGauge().Add(-static_cast<double>(m_Chunks.size()));
+}
+
+void World::Update(const float deltaTime)
+{
+    // Ticks move fluids and blocks, fluid changes relight
+    m_BlockTicker.Update(deltaTime);
+    m_FluidSimulator.Update(deltaTime);
+    if (m_LightEngine.HasPendingWork())
+        m_LightEngine.Propagate();
+}
+
+Chunk *World::GetChunk(const int chunkX, const int chunkZ)
+{
+    const auto it = m_Chunks.find(ChunkKey(chunkX, chunkZ));
+    return it != m_Chunks.end() ? it->second.get() : nullptr;
+}
+
+const Chunk *World::GetChunk(const int chunkX, const int chunkZ) const
+{
+    const auto it = m_Chunks.find(ChunkKey(chunkX, chunkZ));
+    return it != m_Chunks.end() ? it->second.get() : nullptr;
+}
+
+Chunk &World::AddChunk(const int chunkX, const int chunkZ)
+{
+    const uint64_t key = ChunkKey(chunkX, chunkZ);
+    if (Chunk *chunk = GetChunk(chunkX, chunkZ))
+        return *chunk;
+
+    GetLoadedChunksGauge().Add(1.0);
+    if (m_ChunkPool.empty())
+        return *m_Chunks.emplace(key, std::make_unique<Chunk>(chunkX, chunkZ)).first->second;
+
+    // Reuse a removed chunk, it keeps its section storage
+    ChunkMap::node_type node = std::move(m_ChunkPool.back());
+    m_ChunkPool.pop_back();
+    node.key() = key;
+    node.mapped()->Reset(chunkX, chunkZ);
+    return *m_Chunks.insert(std::move(node)).position->second;
+}
+
+void World::RemoveChunk(const int chunkX, const int chunkZ)
+{
+    ChunkMap::node_type node = m_Chunks.extract(ChunkKey(chunkX, chunkZ));
+    if (node)
+        GetLoadedChunksGauge().Add(-1.0);
+    if (node && m_ChunkPool.size() < m_ChunkPoolLimit)
+        m_ChunkPool.push_back(std::move(node));
+}
+
+void World::SetChunkPoolLimit(const size_t limit)
+{
+    m_ChunkPoolLimit = limit;
+    if (m_ChunkPool.size() > limit)
+        m_ChunkPool.resize(limit);
+}
+
+BlockId World::GetBlock(const int x, const int y, const int z) const
+{
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return BLOCK_AIR;
+
+    const Chunk *chunk = GetChunk(ToChunkCoordinate(x), ToChunkCoordinate(z));
+    return chunk ? chunk->GetBlock(x & SECTION_MASK, y, z & SECTION_MASK) : BLOCK_AIR;
+}
+
+void World::SetBlock(const int x, const int y, const int z, const BlockId id, const uint8_t metadata)
+{
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return;
+
+    Chunk *chunk = GetChunk(ToChunkCoordinate(x), ToChunkCoordinate(z));
+    if (!chunk)
+        return;
+
+    const BlockId previous = chunk->GetBlock(x & SECTION_MASK, y, z & SECTION_MASK);
+    const uint8_t previousMetadata = chunk->GetMetadata(x & SECTION_MASK, y, z & SECTION_MASK);
+    if (previous == id && previousMetadata == metadata)
+        return;
+
+    chunk->SetBlock(x & SECTION_MASK, y, z & SECTION_MASK, id, metadata);
+    OnBlockChanged(x, y, z, previous, id);
+}
+
+void World::OnBlockChanged(const int x, const int y, const int z, const BlockId previous, const BlockId id)
+{
+    if (previous != id)
+        m_LightEngine.OnBlockChanged(x, y, z, previous, id);
+    m_FluidSimulator.OnBlockChanged(x, y, z);
+    m_BlockTicker.OnBlockChanged(x, y, z);
+    MarkForRemesh(x, z);
+    if (Chunk *chunk = GetChunk(ToChunkCoordinate(x), ToChunkCoordinate(z)))
+        chunk->MarkForSave(y >> SECTION_SHIFT);
+    if (m_Replicator)
+        m_Replicator->OnBlockChanged(x, y, z);
+}
+
+uint8_t World::GetMetadata(const int x, const int y, const int z) const
+{
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return 0;
+
+    const Chunk *chunk = GetChunk(ToChunkCoordinate(x), ToChunkCoordinate(z));
+    return chunk ? chunk->GetMetadata(x & SECTION_MASK, y, z & SECTION_MASK) : 0;
+}
+
+void World::MarkForRemesh(const int x, const int z)
+{
+    // Blocks on a chunk border are part of the neighbour's mesh as well, through face culling and occlusion
+    for (int cx = ToChunkCoordinate(x - 1); cx <= ToChunkCoordinate(x + 1); cx++)
+    {
+        for (int cz = ToChunkCoordinate(z - 1); cz <= ToChunkCoordinate(z + 1); cz++)
+        {
+            if (Chunk *chunk = GetChunk(cx, cz))
+                chunk->MarkForRemesh();
+        }
+    }
+}
+
+uint8_t World::GetSkyLight(const int x, const int y, const int z) const
+{
+    if (y >= CHUNK_HEIGHT)
+        return MAX_LIGHT_LEVEL;
+    if (y < 0)
+        return 0;
+
+    const Chunk *chunk = GetChunk(ToChunkCoordinate(x), ToChunkCoordinate(z));
+    return chunk ? chunk->GetSkyLight(x & SECTION_MASK, y, z & SECTION_MASK) : 0;
+}
+
+uint8_t World::GetBlockLight(const int x, const int y, const int z) const
+{
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return 0;
+
+    const Chunk *chunk = GetChunk(ToChunkCoordinate(x), ToChunkCoordinate(z));
+    return chunk ? chunk->GetBlockLight(x & SECTION_MASK, y, z & SECTION_MASK) : 0;
+}
+
+RaycastHit World::Raycast(const Ray &ray) const
+{
+    RaycastHit hit;
+
+    const float length = glm::length(ray.Direction);
+    if (length == 0.0f)
+        return hit;
+    const glm::vec3 direction = ray.Direction / length;
+
+    // Per axis: the voxel step and the distance to the next boundary. The boundary distance is always computed from the
+    // voxel instead of accumulated, so skipping empty space lands on exactly the voxel and distance stepping would
+    glm::ivec3 voxel = glm::ivec3(glm::floor(ray.Origin));
+    glm::ivec3 step;
+    glm::vec3 inverseDirection;
+    glm::vec3 tMax;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        step[axis] = direction[axis] > 0.0f ? 1 : direction[axis] < 0.0f ? -1 : 0;
+        inverseDirection[axis] = 1.0f / direction[axis];
+    }
+    auto boundaryDistance = [&](const int axis, const int coordinate) {
+        if (step[axis] == 0)
+            return std::numeric_limits<float>::infinity();
+        const int boundary = step[axis] > 0 ? coordinate + 1 : coordinate;
+        return (static_cast<float>(boundary) - ray.Origin[axis]) * inverseDirection[axis];
+    };
+    for (int axis = 0; axis < 3; axis++)
+        tMax[axis] = boundaryDistance(axis, voxel[axis]);
+
+    // The chunk and section are cached per section the ray passes through, not looked up per voxel
+    glm::ivec3 sectionCoordinate(std::numeric_limits<int>::min());
+    const Chunk *chunk = nullptr;
+    const ChunkSection *section = nullptr;
+    int enteredAxis = -1;
+    float distance = 0.0f;
+
+    // Air can't be skipped when the ray is looking for it
+    const bool skipEmpty = ray.SkipEmptySpace && !(m_BlockRegistry.GetFlags(BLOCK_AIR) & ray.HitMask);
+
+    // Leaves the cube at low with the given size in a single step, ending in the same voxel at the same distance as
+    // stepping through it would. Stepping takes the closest boundary first and the higher axis on equal distances.
+    auto skipNode = [&](const glm::ivec3 &low, const int size) {
+        glm::ivec3 last;
+        float exit = std::numeric_limits<float>::infinity();
+        int exitAxis = 0;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            last[axis] = step[axis] > 0 ? low[axis] + size - 1 : low[axis];
+            const float t = boundaryDistance(axis, last[axis]);
+            if (t <= exit)
+            {
+                exit = t;
+                exitAxis = axis;
+            }
+        }
+
+        // The other axes cross every boundary that stepping would have crossed before the exit
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (axis == exitAxis)
+                continue;
+            while (step[axis] != 0 && voxel[axis] != last[axis])
+            {
+                const float t = boundaryDistance(axis, voxel[axis]);
+                if (t > exit || (t == exit && axis < exitAxis))
+                    break;
+                voxel[axis] += step[axis];
+            }
+            tMax[axis] = boundaryDistance(axis, voxel[axis]);
+        }
+        voxel[exitAxis] = last[exitAxis] + step[exitAxis];
+        tMax[exitAxis] = boundaryDistance(exitAxis, voxel[exitAxis]);
+        distance = exit;
+        enteredAxis = exitAxis;
+    };
+
+    while (distance <= ray.MaxDistance)
+    {
+        // Nothing to hit above or below the world once the ray moves away from it
+        if ((voxel.y < 0 && step.y <= 0) || (voxel.y >= CHUNK_HEIGHT && step.y >= 0))
+            break;
+
+        const glm::ivec3 currentSection(voxel.x >> SECTION_SHIFT, voxel.y >> SECTION_SHIFT, voxel.z >> SECTION_SHIFT);
+        if (currentSection != sectionCoordinate)
+        {
+            if (currentSection.x != sectionCoordinate.x || currentSection.z != sectionCoordinate.z)
+                chunk = GetChunk(currentSection.x, currentSection.z);
+
+            sectionCoordinate = currentSection;
+            section = chunk && voxel.y >= 0 && voxel.y < CHUNK_HEIGHT ? chunk->GetSection(currentSection.y) : nullptr;
+            if (section && section->IsEmpty())
+                section = nullptr;
+        }
+
+        if (!section && skipEmpty)
+        {
+            skipNode(sectionCoordinate * SECTION_SIZE, SECTION_SIZE);
+            continue;
+        }
+
+        if (section)
+        {
+            const int x = voxel.x & SECTION_MASK;
+            const int y = voxel.y & SECTION_MASK;
+            const int z = voxel.z & SECTION_MASK;
+            if (skipEmpty && section->IsBrickEmpty(ChunkSection::BrickIndex(x, y, z)))
+            {
+                const glm::ivec3 brick(x & ~BRICK_MASK, y & ~BRICK_MASK, z & ~BRICK_MASK);
+                skipNode(sectionCoordinate * SECTION_SIZE + brick, BRICK_SIZE);
+                continue;
+            }
+
+            const BlockId id = section->Blocks[ChunkSection::Index(x, y, z)];
+            if (m_BlockRegistry.GetFlags(id) & ray.HitMask)
+            {
+                hit.Hit = true;
+                hit.Position = voxel;
+                hit.Distance = distance;
+                hit.Id = id;
+                if (enteredAxis >= 0)
+                {
+                    hit.Normal[enteredAxis] = -step[enteredAxis];
+                    constexpr BlockFace::Direction faces[3][2] = {
+                        {BlockFace::Direction::Left, BlockFace::Direction::Right},
+                        {BlockFace::Direction::Bottom, BlockFace::Direction::Top},
+                        {BlockFace::Direction::Back, BlockFace::Direction::Front},
+                    };
+                    hit.Face = faces[enteredAxis][hit.Normal[enteredAxis] > 0];
+                }
+                return hit;
+            }
+        }
+
+        // Step into the neighbouring voxel through the closest boundary
+        enteredAxis = tMax.x < tMax.y ? (tMax.x < tMax.z ? 0 : 2) : (tMax.y < tMax.z ? 1 : 2);
+        distance = tMax[enteredAxis];
+        voxel[enteredAxis] += step[enteredAxis];
+        tMax[enteredAxis] = boundaryDistance(enteredAxis, voxel[enteredAxis]);
+    }
+
+    return hit;
+}
+
+void World::RaycastBatch(const std::span<const Ray> rays, const std::span<RaycastHit> hits,
+                         ThreadPool &threadPool) const
+{
+    const size_t count = std::min(rays.size(), hits.size());
+    threadPool.ParallelFor(count, 256, [this, rays, hits](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++)
+            hits[i] = Raycast(rays[i]);
+    });
+}
+
+std::optional<glm::ivec3> World::FindNearestBlock(const glm::ivec3 &center, const int radius,
+                                                  const uint8_t flagMask) const
+{
+    const glm::ivec3 low = center - radius;
+    const glm::ivec3 high = center + radius;
+
+    // Squared distance from the center to the closest block of a cube
+    auto cubeDistance = [&center](const glm::ivec3 &cubeLow, const int size) {
+        int distance = 0;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            const int d = std::clamp(center[axis], cubeLow[axis], cubeLow[axis] + size - 1) - center[axis];
+            distance += d * d;
+        }
+        return distance;
+    };
+
+    // Non-empty sections in range, nearest first: the first matches prune most of the others
+    struct Candidate
+    {
+        int Distance;
+        const ChunkSection *Section;
+        glm::ivec3 Origin;
+    };
+    std::vector<Candidate> candidates;
+    const int minSection = std::max(low.y, 0) >> SECTION_SHIFT;
+    const int maxSection = std::min(high.y, CHUNK_HEIGHT - 1) >> SECTION_SHIFT;
+    for (int chunkX = ToChunkCoordinate(low.x); chunkX <= ToChunkCoordinate(high.x); chunkX++)
+    {
+        for (int chunkZ = ToChunkCoordinate(low.z); chunkZ <= ToChunkCoordinate(high.z); chunkZ++)
+        {
+            const Chunk *chunk = GetChunk(chunkX, chunkZ);
+            if (!chunk)
+                continue;
+            for (int sectionY = minSection; sectionY <= maxSection; sectionY++)
+            {
+                const ChunkSection *section = chunk->GetSection(sectionY);
+                if (!section || section->IsEmpty())
+                    continue;
+                const glm::ivec3 origin(chunkX * SECTION_SIZE, sectionY * SECTION_SIZE, chunkZ * SECTION_SIZE);
+                candidates.push_back({cubeDistance(origin, SECTION_SIZE), section, origin});
+            }
+        }
+    }
+    std::ranges::sort(candidates, {}, &Candidate::Distance);
+
+    std::optional<glm::ivec3> nearest;
+    int nearestDistance = std::numeric_limits<int>::max();
+    for (const Candidate &candidate : candidates)
+    {
+        if (candidate.Distance >= nearestDistance)
+            break;
+
+        for (uint64_t bricks = candidate.Section->BrickMask; bricks; bricks &= bricks - 1)
+        {
+            const int brick = std::countr_zero(bricks);
+            const glm::ivec3 brickLow((brick & BRICK_MASK) * BRICK_SIZE, (brick >> (2 * BRICK_SHIFT)) * BRICK_SIZE,
+                                      (brick >> BRICK_SHIFT & BRICK_MASK) * BRICK_SIZE);
+            if (cubeDistance(candidate.Origin + brickLow, BRICK_SIZE) >= nearestDistance)
+                continue;
+
+            for (uint64_t voxels = candidate.Section->VoxelMasks[brick]; voxels; voxels &= voxels - 1)
+            {
+                const int voxel = std::countr_zero(voxels);
+                const glm::ivec3 local = brickLow + glm::ivec3(voxel & BRICK_MASK, voxel >> (2 * BRICK_SHIFT),
+                                                               voxel >> BRICK_SHIFT & BRICK_MASK);
+                const glm::ivec3 position = candidate.Origin + local;
+                if (position.x < low.x || position.y < low.y || position.z < low.z || position.x > high.x ||
+                    position.y > high.y || position.z > high.z)
+                    continue;
+
+                const glm::ivec3 offset = position - center;
+                const int distance = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+                if (distance >= nearestDistance)
+                    continue;
+
+                const BlockId id = candidate.Section->Blocks[ChunkSection::Index(local.x, local.y, local.z)];
+                if (m_BlockRegistry.GetFlags(id) & flagMask)
+                {
+                    nearest = position;
+                    nearestDistance = distance;
+                }
+            }
+        }
+    }
+    return nearest;
+}
+
+} // namespace BloxxEngine
@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/World/World.h"
+#include "BloxxEngine/World/WorldReplication.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <unordered_map>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+using ChangeMask = std::array<uint64_t, SECTION_VOLUME / 64>;
+
+bool IsChanged(const ChangeMask *mask, const int index)
+{
+    return mask && ((*mask)[index >> 6] >> (index & 63) & 1);
+}
+
+/**
+ * Marks the changed blocks whose six neighbours were all changed as well, a word of the mask at a time. A word holds
+ * four rows along x (z = 4 * (w % 4) up to 4 * (w % 4) + 3) of one layer (y = w / 4). The neighbouring sections are
+ * ordered -x, +x, -y, +y, -z, +z and are nullptr where nothing changed.
+ */
+ChangeMask InteriorMask(const ChangeMask &mask, const ChangeMask *const (&neighbours)[6])
+{
+    constexpr uint64_t RowStart = 0x0001000100010001ull; // The x = 0 bits of the four rows
+    constexpr uint64_t RowEnd = RowStart << 15;
+    constexpr int Words = static_cast<int>(std::tuple_size_v<ChangeMask>);
+
+    auto word = [](const ChangeMask *changes, const int w) { return changes ? (*changes)[w] : 0; };
+
+    ChangeMask interior;
+    for (int w = 0; w < Words; w++)
+    {
+        const uint64_t changed = mask[w];
+        const uint64_t minusX = (changed << 1 & ~RowStart) | (word(neighbours[0], w) >> 15 & RowStart);
+        const uint64_t plusX = (changed >> 1 & ~RowEnd) | (word(neighbours[1], w) << 15 & RowEnd);
+        const uint64_t minusY = w >= 4 ? mask[w - 4] : word(neighbours[2], w + Words - 4);
+        const uint64_t plusY = w < Words - 4 ? mask[w + 4] : word(neighbours[3], w - Words + 4);
+        const uint64_t previousRows = (w & 3) != 0 ? mask[w - 1] : word(neighbours[4], w + 3);
+        const uint64_t nextRows = (w & 3) != 3 ? mask[w + 1] : word(neighbours[5], w - 3);
+        const uint64_t minusZ = changed << 16 | previousRows >> 48;
+        const uint64_t plusZ = changed >> 16 | nextRows << 48;
+        interior[w] = changed & minusX & plusX & minusY & plusY & minusZ & plusZ;
+    }
+    return interior;
+}
+
+/**
+ * Writes spans of one section, recording the previous contents into the journal and marking the changed blocks.
+ * Spans have to be written in increasing index order.
+ */
+class SectionWriter
+{
+  public:
+    void Begin(ChunkSection &section, EditJournal &journal, ChangeMask &changes)
+    {
+        m_Section = &section;
+        m_Journal = &journal;
+        m_Changes = &changes;
+        m_Cursor = 0;
+    }
+
+    // fill(blocks, metadata) overwrites the blocks it changes in the span starting at index
+    template <typename Fill> void Write(const int index, const int count, Fill &&fill)
+    {
+        m_Journal->Skip(index - m_Cursor);
+        std::copy_n(m_Section->Blocks.begin() + index, count, m_PreviousBlocks.begin());
+        std::copy_n(m_Section->Metadata.begin() + index, count, m_PreviousMetadata.begin());
+        fill(m_Section->Blocks.data() + index, m_Section->Metadata.data() + index);
+
+        // Equal neighbouring blocks go into the journal as a single run
+        int nonAirDelta = 0;
+        for (int i = 0; i < count;)
+        {
+            const BlockId previous = m_PreviousBlocks[i];
+            const uint8_t previousMetadata = m_PreviousMetadata[i];
+            const bool changed = IsChanged(index + i, previous, previousMetadata);
+
+            int end = i + 1;
+            while (end < count && IsChanged(index + end, m_PreviousBlocks[end], m_PreviousMetadata[end]) == changed &&
+                   (!changed || (m_PreviousBlocks[end] == previous && m_PreviousMetadata[end] == previousMetadata)))
+                end++;
+
+            if (!changed)
+            {
+                m_Journal->Skip(end - i);
+                i = end;
+                continue;
+            }
+
+            m_Journal->Record(previous, previousMetadata, end - i);
+            for (; i < end; i++)
+            {
+                const int cell = index + i;
+                (*m_Changes)[cell >> 6] |= 1ull << (cell & 63);
+
+                const bool occupied = m_Section->Blocks[cell] != BLOCK_AIR;
+                if (occupied != (previous != BLOCK_AIR))
+                {
+                    nonAirDelta += occupied ? 1 : -1;
+                    m_Section->SetOccupied(cell & SECTION_MASK, cell >> (2 * SECTION_SHIFT),
+                                           cell >> SECTION_SHIFT & SECTION_MASK, occupied);
+                }
+            }
+        }
+        m_Section->NonAirCount = static_cast<uint16_t>(m_Section->NonAirCount + nonAirDelta);
+        m_Cursor = index + count;
+    }
+
+  private:
+    [[nodiscard]] bool IsChanged(const int cell, const BlockId previous, const uint8_t previousMetadata) const
+    {
+        return m_Section->Blocks[cell] != previous || m_Section->Metadata[cell] != previousMetadata;
+    }
+
+    ChunkSection *m_Section = nullptr;
+    EditJournal *m_Journal = nullptr;
+    ChangeMask *m_Changes = nullptr;
+    int m_Cursor = 0;
+
+    std::array<BlockId, SECTION_VOLUME> m_PreviousBlocks;
+    std::array<uint8_t, SECTION_VOLUME> m_PreviousMetadata;
+};
+
+// Sections the edit didn't change anything in are left out of the journal
+void DiscardIfUnchanged(EditJournal &journal, std::vector<ChangeMask> &changes, const size_t changedBefore)
+{
+    if (journal.ChangedCount != changedBefore)
+        return;
+    journal.Runs.resize(journal.Sections.back().FirstRun);
+    journal.Sections.pop_back();
+    changes.pop_back();
+}
+} // namespace
+
+template <typename RowEdit>
+EditJournal World::EditBox(const glm::ivec3 &min, const glm::ivec3 &max, const bool createSections, RowEdit &&edit)
+{
+    EditJournal journal;
+    std::vector<ChangeMask> changes;
+
+    const int minY = std::max(min.y, 0);
+    const int maxY = std::min(max.y, CHUNK_HEIGHT - 1);
+    if (min.x > max.x || min.z > max.z || minY > maxY)
+        return journal;
+
+    SectionWriter writer;
+    for (int chunkX = ToChunkCoordinate(min.x); chunkX <= ToChunkCoordinate(max.x); chunkX++)
+    {
+        for (int chunkZ = ToChunkCoordinate(min.z); chunkZ <= ToChunkCoordinate(max.z); chunkZ++)
+        {
+            Chunk *chunk = GetChunk(chunkX, chunkZ);
+            if (!chunk)
+                continue;
+
+            // The box in chunk local coordinates
+            const int originX = chunkX * CHUNK_WIDTH;
+            const int originZ = chunkZ * CHUNK_DEPTH;
+            const int x0 = std::max(min.x - originX, 0);
+            const int x1 = std::min(max.x - originX, CHUNK_WIDTH - 1);
+            const int z0 = std::max(min.z - originZ, 0);
+            const int z1 = std::min(max.z - originZ, CHUNK_DEPTH - 1);
+            const int count = x1 - x0 + 1;
+
+            for (int sectionY = minY >> SECTION_SHIFT; sectionY <= maxY >> SECTION_SHIFT; sectionY++)
+            {
+                ChunkSection *section = chunk->GetSection(sectionY);
+                if (!section)
+                {
+                    // Missing sections are all air, edits that can't write anything into air skip them
+                    if (!createSections)
+                        continue;
+                    section = &chunk->GetOrCreateSection(sectionY);
+                }
+
+                const int originY = sectionY * SECTION_SIZE;
+                const int y0 = std::max(minY - originY, 0);
+                const int y1 = std::min(maxY - originY, SECTION_SIZE - 1);
+
+                const size_t changedBefore = journal.ChangedCount;
+                journal.BeginSection(chunkX, sectionY, chunkZ);
+                writer.Begin(*section, journal, changes.emplace_back());
+                for (int y = y0; y <= y1; y++)
+                {
+                    for (int z = z0; z <= z1; z++)
+                    {
+                        writer.Write(ChunkSection::Index(x0, y, z), count, [&](BlockId *blocks, uint8_t *metadata) {
+                            edit(originX + x0, originY + y, originZ + z, count, blocks, metadata);
+                        });
+                    }
+                }
+                DiscardIfUnchanged(journal, changes, changedBefore);
+            }
+        }
+    }
+
+    FinishEdit(journal, changes);
+    return journal;
+}
+
+void World::FinishEdit(const EditJournal &journal, const std::vector<ChangeMask> &changes)
+{
+    // The blocks that became transparent or opaque, only those change how light flows
+    std::vector<ChangeMask> lightChanges(journal.Sections.size(), ChangeMask{});
+    std::unordered_map<uint64_t, size_t> sections;
+    for (size_t i = 0; i < journal.Sections.size(); i++)
+    {
+        const EditJournal::Section &record = journal.Sections[i];
+        sections.emplace(SectionKey(record.ChunkX, record.SectionY, record.ChunkZ), i);
+
+        const ChunkSection *section = GetChunk(record.ChunkX, record.ChunkZ)->GetSection(record.SectionY);
+        int index = 0;
+        for (size_t run = record.FirstRun; run < record.FirstRun + record.RunCount; run++)
+        {
+            const EditJournal::Run &previous = journal.Runs[run];
+            const int end = index + previous.Length;
+            if (previous.Changed)
+            {
+                const bool wasTransparent = m_BlockRegistry.IsTransparent(previous.Id);
+                for (; index < end; index++)
+                {
+                    if (m_BlockRegistry.IsTransparent(section->Blocks[index]) != wasTransparent)
+                        lightChanges[i][index >> 6] |= 1ull << (index & 63);
+                }
+            }
+            index = end;
+        }
+    }
+    // Blocks on the section border check the neighbouring sections: -x, +x, -y, +y, -z, +z
+    auto interiorOf = [&](const size_t i, const std::vector<ChangeMask> &masks) {
+        const EditJournal::Section &record = journal.Sections[i];
+        auto find = [&](const int chunkX, const int sectionY, const int chunkZ) -> const ChangeMask * {
+            const auto it = sections.find(SectionKey(chunkX, sectionY, chunkZ));
+            return it != sections.end() ? &masks[it->second] : nullptr;
+        };
+        const ChangeMask *neighbours[6] = {
+            find(record.ChunkX - 1, record.SectionY, record.ChunkZ),
+            find(record.ChunkX + 1, record.SectionY, record.ChunkZ),
+            find(record.ChunkX, record.SectionY - 1, record.ChunkZ),
+            find(record.ChunkX, record.SectionY + 1, record.ChunkZ),
+            find(record.ChunkX, record.SectionY, record.ChunkZ - 1),
+            find(record.ChunkX, record.SectionY, record.ChunkZ + 1),
+        };
+        return InteriorMask(masks[i], neighbours);
+    };
+
+    for (size_t i = 0; i < journal.Sections.size(); i++)
+    {
+        const EditJournal::Section &record = journal.Sections[i];
+        Chunk *chunk = GetChunk(record.ChunkX, record.ChunkZ);
+        ChunkSection *section = chunk->GetSection(record.SectionY);
+        chunk->MarkForSave(record.SectionY);
+        if (m_Replicator)
+            m_Replicator->OnSectionChanged(record.ChunkX, record.SectionY, record.ChunkZ, changes[i]);
+
+        // Inside the changed region all six neighbours were changed by the edit as well
+        const ChangeMask interiorMask = interiorOf(i, changes);
+        // Light inside the region of blocks that turned transparent or opaque is reset directly. Every path light
+        // took into or out of it crosses the border of that region, which goes through the incremental lighting. A
+        // block that changed without changing transparency (air to water) isn't relit, so it isn't part of it.
+        const ChangeMask lightInteriorMask = interiorOf(i, lightChanges);
+
+        const glm::ivec3 origin(record.ChunkX * CHUNK_WIDTH, record.SectionY * SECTION_SIZE,
+                                record.ChunkZ * CHUNK_DEPTH);
+        auto isFluid = [&](const int x, const int y, const int z) {
+            const bool inside =
+                x >= 0 && x < SECTION_SIZE && y >= 0 && y < SECTION_SIZE && z >= 0 && z < SECTION_SIZE;
+            const BlockId id = inside ? section->Blocks[ChunkSection::Index(x, y, z)]
+                                      : GetBlock(origin.x + x, origin.y + y, origin.z + z);
+            return (m_BlockRegistry.GetFlags(id) & BlockFlag_Fluid) != 0;
+        };
+        auto isFluidAround = [&](const int x, const int y, const int z) {
+            return isFluid(x - 1, y, z) || isFluid(x + 1, y, z) || isFluid(x, y - 1, z) || isFluid(x, y + 1, z) ||
+                   isFluid(x, y, z - 1) || isFluid(x, y, z + 1);
+        };
+        bool touchesBorder[2][2] = {}; // [x or z][positive side]
+        int index = 0;
+        for (size_t run = record.FirstRun; run < record.FirstRun + record.RunCount; run++)
+        {
+            const EditJournal::Run &previous = journal.Runs[run];
+            if (!previous.Changed)
+            {
+                index += previous.Length;
+                continue;
+            }
+
+            for (const int end = index + previous.Length; index < end; index++)
+            {
+                const int x = index & SECTION_MASK;
+                const int z = index >> SECTION_SHIFT & SECTION_MASK;
+                const int y = index >> (2 * SECTION_SHIFT);
+                touchesBorder[0][0] |= x == 0;
+                touchesBorder[0][1] |= x == SECTION_MASK;
+                touchesBorder[1][0] |= z == 0;
+                touchesBorder[1][1] |= z == SECTION_MASK;
+
+                const bool interior = IsChanged(&interiorMask, index);
+                const glm::ivec3 position = origin + glm::ivec3(x, y, z);
+                const BlockId current = section->Blocks[index];
+
+                // Light only has to be flood filled from the border of the region, it flows into the inside from there
+                const uint8_t previousEmission = m_BlockRegistry.GetLightEmission(previous.Id);
+                const uint8_t currentEmission = m_BlockRegistry.GetLightEmission(current);
+                if (IsChanged(&lightChanges[i], index) || previousEmission != currentEmission)
+                {
+                    if (!IsChanged(&lightInteriorMask, index) || previousEmission > 0 || currentEmission > 0)
+                    {
+                        m_LightEngine.OnBlockChanged(position.x, position.y, position.z, previous.Id, current);
+                    }
+                    else
+                    {
+                        section->SetSkyLight(index, 0);
+                        section->SetBlockLight(index, 0);
+                    }
+                }
+
+                // Settled fluid inside the region stays settled, only flowing fluid has to be evaluated. On the border
+                // only blocks with fluid around them are handed over.
+                const bool fluid = m_BlockRegistry.GetFlags(current) & BlockFlag_Fluid;
+                if (interior ? fluid && section->Metadata[index] != 0
+                             : fluid || (m_BlockRegistry.GetFlags(previous.Id) & BlockFlag_Fluid) ||
+                                   isFluidAround(x, y, z))
+                    m_FluidSimulator.OnBlockChanged(position.x, position.y, position.z);
+
+                // Blocks inside the region are surrounded by the edit, the ticks their handlers need start from the
+                // border as well
+                if (!interior)
+                    m_BlockTicker.OnBlockChanged(position.x, position.y, position.z);
+            }
+        }
+
+        // Remeshing is flagged once per section, for the neighbours it reaches into as well
+        for (int dx = touchesBorder[0][0] ? -1 : 0; dx <= (touchesBorder[0][1] ? 1 : 0); dx++)
+        {
+            for (int dz = touchesBorder[1][0] ? -1 : 0; dz <= (touchesBorder[1][1] ? 1 : 0); dz++)
+            {
+                if (Chunk *neighbour = GetChunk(record.ChunkX + dx, record.ChunkZ + dz))
+                    neighbour->MarkForRemesh();
+            }
+        }
+    }
+}
+
+EditJournal World::FillBox(const glm::ivec3 &min, const glm::ivec3 &max, const BlockId id, const uint8_t metadata)
+{
+    return EditBox(min, max, id != BLOCK_AIR,
+                   [id, metadata](int, int, int, const int count, BlockId *blocks, uint8_t *blockMetadata) {
+                       std::fill_n(blocks, count, id);
+                       std::fill_n(blockMetadata, count, metadata);
+                   });
+}
+
+EditJournal World::FillSphere(const glm::ivec3 &center, const int radius, const BlockId id, const uint8_t metadata)
+{
+    const int radiusSquared = radius * radius;
+    auto fillRow = [&](const int x, const int y, const int z, const int count, BlockId *blocks,
+                       uint8_t *blockMetadata) {
+        const int dy = y - center.y;
+        const int dz = z - center.z;
+        const int rest = radiusSquared - dy * dy - dz * dz;
+        if (rest < 0)
+            return;
+
+        // Half the width of the sphere along this row
+        auto halfWidth = static_cast<int>(std::sqrt(static_cast<float>(rest)));
+        while (halfWidth * halfWidth > rest)
+            halfWidth--;
+        while ((halfWidth + 1) * (halfWidth + 1) <= rest)
+            halfWidth++;
+
+        const int begin = std::max(center.x - halfWidth - x, 0);
+        const int end = std::min(center.x + halfWidth - x + 1, count);
+        if (begin >= end)
+            return;
+        std::fill(blocks + begin, blocks + end, id);
+        std::fill(blockMetadata + begin, blockMetadata + end, metadata);
+    };
+    return EditBox(center - radius, center + radius, id != BLOCK_AIR, fillRow);
+}
+
+EditJournal World::Replace(const glm::ivec3 &min, const glm::ivec3 &max, const BlockId from, const BlockId to,
+                           const uint8_t metadata)
+{
+    return EditBox(min, max, from == BLOCK_AIR && to != BLOCK_AIR,
+                   [from, to, metadata](int, int, int, const int count, BlockId *blocks, uint8_t *blockMetadata) {
+                       for (int i = 0; i < count; i++)
+                       {
+                           if (blocks[i] == from)
+                           {
+                               blocks[i] = to;
+                               blockMetadata[i] = metadata;
+                           }
+                       }
+                   });
+}
+
+BlockRegion World::CopyRegion(const glm::ivec3 &min, const glm::ivec3 &max) const
+{
+    BlockRegion region;
+    if (min.x > max.x || min.y > max.y || min.z > max.z)
+        return region;
+
+    region.Size = max - min + 1;
+    const size_t volume = static_cast<size_t>(region.Size.x) * region.Size.y * region.Size.z;
+    region.Blocks.assign(volume, BLOCK_AIR);
+    region.Metadata.assign(volume, 0);
+
+    // Rows are copied straight out of the sections, one chunk at a time
+    for (int y = std::max(min.y, 0); y <= std::min(max.y, CHUNK_HEIGHT - 1); y++)
+    {
+        for (int z = min.z; z <= max.z; z++)
+        {
+            for (int chunkX = ToChunkCoordinate(min.x); chunkX <= ToChunkCoordinate(max.x); chunkX++)
+            {
+                const Chunk *chunk = GetChunk(chunkX, ToChunkCoordinate(z));
+                const ChunkSection *section = chunk ? chunk->GetSection(y >> SECTION_SHIFT) : nullptr;
+                if (!section)
+                    continue;
+
+                const int x0 = std::max(min.x, chunkX * CHUNK_WIDTH);
+                const int x1 = std::min(max.x, chunkX * CHUNK_WIDTH + CHUNK_WIDTH - 1);
+                const int source = ChunkSection::Index(x0 & SECTION_MASK, y & SECTION_MASK, z & SECTION_MASK);
+                const size_t target = region.Index(x0 - min.x, y - min.y, z - min.z);
+                std::copy_n(section->Blocks.begin() + source, x1 - x0 + 1, region.Blocks.begin() + target);
+                std::copy_n(section->Metadata.begin() + source, x1 - x0 + 1, region.Metadata.begin() + target);
+            }
+        }
+    }
+    return region;
+}
+
+EditJournal World::PasteRegion(const BlockRegion &region, const glm::ivec3 &origin, const bool skipAir)
+{
+    return EditBox(origin, origin + region.Size - 1, true,
+                   [&](const int x, const int y, const int z, const int count, BlockId *blocks, uint8_t *metadata) {
+                       const size_t source = region.Index(x - origin.x, y - origin.y, z - origin.z);
+                       if (!skipAir)
+                       {
+                           std::copy_n(region.Blocks.begin() + source, count, blocks);
+                           std::copy_n(region.Metadata.begin() + source, count, metadata);
+                           return;
+                       }
+                       for (int i = 0; i < count; i++)
+                       {
+                           if (region.Blocks[source + i] == BLOCK_AIR)
+                               continue;
+                           blocks[i] = region.Blocks[source + i];
+                           metadata[i] = region.Metadata[source + i];
+                       }
+                   });
+}
+
+EditJournal World::ApplyJournal(const EditJournal &journal)
+{
+    EditJournal inverse;
+    std::vector<ChangeMask> changes;
+
+    SectionWriter writer;
+    for (const EditJournal::Section &record : journal.Sections)
+    {
+        Chunk *chunk = GetChunk(record.ChunkX, record.ChunkZ);
+        if (!chunk)
+            continue;
+
+        const size_t changedBefore = inverse.ChangedCount;
+        inverse.BeginSection(record.ChunkX, record.SectionY, record.ChunkZ);
+        writer.Begin(chunk->GetOrCreateSection(record.SectionY), inverse, changes.emplace_back());
+        int index = 0;
+        for (size_t i = record.FirstRun; i < record.FirstRun + record.RunCount; i++)
+        {
+            const EditJournal::Run &run = journal.Runs[i];
+            if (run.Changed)
+            {
+                writer.Write(index, run.Length, [&run](BlockId *blocks, uint8_t *metadata) {
+                    std::fill_n(blocks, run.Length, run.Id);
+                    std::fill_n(metadata, run.Length, run.Metadata);
+                });
+            }
+            index += run.Length;
+        }
+        DiscardIfUnchanged(inverse, changes, changedBefore);
+    }
+
+    FinishEdit(inverse, changes);
+    return inverse;
+}
+
+} // namespace BloxxEngine
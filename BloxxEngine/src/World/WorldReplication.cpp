@@ -0,0 +1,641 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/World/WorldReplication.h"
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include <utility>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+// How the palette indices of a section with more than one block follow the palette
+enum class SectionEncoding : uint8_t
+{
+    Packed, // Whole uint64 words of indices at the smallest bit width, none straddling two words
+    Runs,   // Index and length - 1 per run
+};
+
+// Palettes up to this size are searched linearly while encoding
+constexpr size_t LINEAR_PALETTE_LIMIT = 32;
+
+// The section is sent whole when at least this many of its blocks changed
+constexpr size_t SECTION_DATA_THRESHOLD = SECTION_VOLUME / 8;
+
+// Block id in the upper bits and metadata in the low byte, the values the palettes are made of
+uint32_t PackBlock(const BlockId id, const uint8_t metadata)
+{
+    return static_cast<uint32_t>(id) << 8 | metadata;
+}
+
+void WriteFixed(std::vector<uint8_t> &out, uint64_t value, const int bytes)
+{
+    for (int i = 0; i < bytes; i++, value >>= 8)
+        out.push_back(static_cast<uint8_t>(value));
+}
+
+void WriteVarint(std::vector<uint8_t> &out, uint64_t value)
+{
+    for (; value >= 0x80; value >>= 7)
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+size_t VarintSize(uint64_t value)
+{
+    size_t size = 1;
+    for (; value >= 0x80; value >>= 7)
+        size++;
+    return size;
+}
+
+// Zigzag, so chunks on the negative side stay as short as the ones on the positive side
+void WriteCoordinate(std::vector<uint8_t> &out, const int value)
+{
+    WriteVarint(out, static_cast<uint32_t>(value) << 1 ^ static_cast<uint32_t>(value >> 31));
+}
+
+void WriteSectionHeader(std::vector<uint8_t> &out, const ReplicationMessage type, const int chunkX, const int sectionY,
+                        const int chunkZ)
+{
+    out.push_back(static_cast<uint8_t>(type));
+    WriteCoordinate(out, chunkX);
+    out.push_back(static_cast<uint8_t>(sectionY));
+    WriteCoordinate(out, chunkZ);
+}
+
+/**
+ * Reads a packet front to back. Reading past the end or an out of range value makes the reader invalid, after which
+ * every read returns zero.
+ */
+class PacketReader
+{
+  public:
+    explicit PacketReader(const std::span<const uint8_t> data) : m_Data(data) {}
+
+    [[nodiscard]] bool IsAtEnd() const { return m_Position == m_Data.size(); }
+    [[nodiscard]] bool IsValid() const { return m_Valid; }
+    void Fail() { m_Valid = false; }
+
+    uint64_t ReadFixed(const int bytes)
+    {
+        if (!m_Valid || m_Data.size() - m_Position < static_cast<size_t>(bytes))
+        {
+            m_Valid = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++)
+            value |= static_cast<uint64_t>(m_Data[m_Position++]) << (8 * i);
+        return value;
+    }
+
+    // Values above max make the reader invalid
+    uint64_t ReadVarint(const uint64_t max = UINT64_MAX)
+    {
+        uint64_t value = 0;
+        for (int shift = 0; m_Valid && shift < 64; shift += 7)
+        {
+            const auto byte = static_cast<uint8_t>(ReadFixed(1));
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                if (value <= max)
+                    return value;
+                break;
+            }
+        }
+        m_Valid = false;
+        return 0;
+    }
+
+    int ReadCoordinate()
+    {
+        const uint64_t value = ReadVarint(UINT32_MAX);
+        return static_cast<int>(static_cast<uint32_t>(value >> 1) ^ (0u - static_cast<uint32_t>(value & 1)));
+    }
+
+  private:
+    std::span<const uint8_t> m_Data;
+    size_t m_Position = 0;
+    bool m_Valid = true;
+};
+
+// Palette and indices of a section, a missing section is all air
+void WriteSection(std::vector<uint8_t> &out, const ChunkSection *section)
+{
+    // Per thread, so several packets can be built at once
+    thread_local std::array<uint32_t, SECTION_VOLUME> values;
+    thread_local std::array<uint32_t, SECTION_VOLUME> palette;
+    thread_local std::array<uint16_t, SECTION_VOLUME> indices;
+
+    for (int i = 0; i < SECTION_VOLUME; i++)
+        values[i] = section ? PackBlock(section->Blocks[i], section->Metadata[i]) : PackBlock(BLOCK_AIR, 0);
+
+    // Sections mostly hold a handful of blocks and neighbouring blocks are mostly the same, so the palette is built
+    // in order of appearance with a linear search on every change of value. Sections with many different blocks
+    // fall back to a sorted palette and binary searches.
+    size_t paletteSize = 0;
+    uint32_t previous = values[0];
+    uint16_t index = 0;
+    palette[paletteSize++] = previous;
+    for (int i = 0; i < SECTION_VOLUME && paletteSize <= LINEAR_PALETTE_LIMIT; i++)
+    {
+        if (values[i] != previous)
+        {
+            previous = values[i];
+            index = 0;
+            while (index < paletteSize && palette[index] != previous)
+                index++;
+            if (index == paletteSize)
+                palette[paletteSize++] = previous;
+        }
+        indices[i] = index;
+    }
+    if (paletteSize > LINEAR_PALETTE_LIMIT)
+    {
+        palette = values;
+        std::ranges::sort(palette);
+        paletteSize = std::ranges::unique(palette).begin() - palette.begin();
+        const auto paletteEnd = palette.begin() + static_cast<std::ptrdiff_t>(paletteSize);
+        for (int i = 0; i < SECTION_VOLUME; i++)
+        {
+            if (i == 0 || values[i] != previous)
+            {
+                previous = values[i];
+                index = static_cast<uint16_t>(std::lower_bound(palette.begin(), paletteEnd, previous) -
+                                              palette.begin());
+            }
+            indices[i] = index;
+        }
+    }
+
+    WriteVarint(out, paletteSize);
+    for (size_t i = 0; i < paletteSize; i++)
+    {
+        WriteVarint(out, palette[i] >> 8);
+        out.push_back(static_cast<uint8_t>(palette[i]));
+    }
+    if (paletteSize == 1)
+        return;
+
+    size_t runCount = 1;
+    size_t runBytes = 0;
+    size_t runStart = 0;
+    for (int i = 1; i < SECTION_VOLUME; i++)
+    {
+        if (indices[i] == indices[runStart])
+            continue;
+        runBytes += VarintSize(indices[runStart]) + VarintSize(i - runStart - 1);
+        runCount++;
+        runStart = i;
+    }
+    runBytes += VarintSize(indices[runStart]) + VarintSize(SECTION_VOLUME - runStart - 1);
+
+    const int bits = std::bit_width(paletteSize - 1);
+    const int perWord = 64 / bits;
+    const size_t wordCount = (SECTION_VOLUME + perWord - 1) / perWord;
+    if (VarintSize(runCount) + runBytes < wordCount * sizeof(uint64_t))
+    {
+        out.push_back(static_cast<uint8_t>(SectionEncoding::Runs));
+        WriteVarint(out, runCount);
+        runStart = 0;
+        for (int i = 1; i <= SECTION_VOLUME; i++)
+        {
+            if (i < SECTION_VOLUME && indices[i] == indices[runStart])
+                continue;
+            WriteVarint(out, indices[runStart]);
+            WriteVarint(out, i - runStart - 1);
+            runStart = i;
+        }
+        return;
+    }
+
+    out.push_back(static_cast<uint8_t>(SectionEncoding::Packed));
+    for (size_t word = 0, i = 0; word < wordCount; word++)
+    {
+        uint64_t packed = 0;
+        for (int j = 0; j < perWord && i < SECTION_VOLUME; j++, i++)
+            packed |= static_cast<uint64_t>(indices[i]) << (j * bits);
+        WriteFixed(out, packed, sizeof(packed));
+    }
+}
+
+// Ids above maxId are unknown to the client and make the section malformed
+bool ReadSection(PacketReader &reader, const BlockId maxId, std::span<uint32_t, SECTION_VOLUME> values)
+{
+    thread_local std::array<uint32_t, SECTION_VOLUME> palette;
+
+    const size_t paletteSize = reader.ReadVarint(SECTION_VOLUME);
+    if (paletteSize == 0)
+        return false;
+    for (size_t i = 0; i < paletteSize && reader.IsValid(); i++)
+    {
+        const auto id = static_cast<BlockId>(reader.ReadVarint(maxId));
+        palette[i] = PackBlock(id, static_cast<uint8_t>(reader.ReadFixed(1)));
+    }
+    if (paletteSize == 1)
+    {
+        std::ranges::fill(values, palette[0]);
+        return reader.IsValid();
+    }
+
+    const auto encoding = static_cast<SectionEncoding>(reader.ReadFixed(1));
+    if (encoding == SectionEncoding::Packed)
+    {
+        const int bits = std::bit_width(paletteSize - 1);
+        const int perWord = 64 / bits;
+        const uint64_t mask = (1ull << bits) - 1;
+        for (int i = 0; i < SECTION_VOLUME && reader.IsValid();)
+        {
+            uint64_t packed = reader.ReadFixed(sizeof(packed));
+            for (int j = 0; j < perWord && i < SECTION_VOLUME; j++, i++, packed >>= bits)
+            {
+                if ((packed & mask) >= paletteSize)
+                    return false;
+                values[i] = palette[packed & mask];
+            }
+        }
+        return reader.IsValid();
+    }
+    if (encoding != SectionEncoding::Runs)
+        return false;
+
+    const size_t runCount = reader.ReadVarint(SECTION_VOLUME);
+    size_t i = 0;
+    for (size_t run = 0; run < runCount && reader.IsValid(); run++)
+    {
+        const size_t index = reader.ReadVarint(paletteSize - 1);
+        const size_t length = i < SECTION_VOLUME ? reader.ReadVarint(SECTION_VOLUME - i - 1) + 1 : 0;
+        if (!reader.IsValid() || length == 0)
+            return false;
+        std::fill_n(values.begin() + static_cast<std::ptrdiff_t>(i), length, palette[index]);
+        i += length;
+    }
+    return reader.IsValid() && i == SECTION_VOLUME;
+}
+
+bool IsChanged(const WorldReplicator::ChangeMask &mask, const int index)
+{
+    return mask[index >> 6] >> (index & 63) & 1;
+}
+} // namespace
+
+WorldReplicator::WorldReplicator(World &world) : m_World(world)
+{
+    m_World.SetReplicator(this);
+}
+
+WorldReplicator::~WorldReplicator()
+{
+    m_World.SetReplicator(nullptr);
+}
+
+WorldReplicator::PendingSection &WorldReplicator::GetPending(const int chunkX, const int sectionY, const int chunkZ)
+{
+    const auto [it, inserted] =
+        m_PendingIndex.try_emplace(World::SectionKey(chunkX, sectionY, chunkZ), m_Pending.size());
+    if (inserted)
+        m_Pending.push_back({chunkX, sectionY, chunkZ, {}});
+    return m_Pending[it->second];
+}
+
+void WorldReplicator::OnBlockChanged(const int x, const int y, const int z)
+{
+    PendingSection &pending =
+        GetPending(World::ToChunkCoordinate(x), y >> SECTION_SHIFT, World::ToChunkCoordinate(z));
+    const int index = ChunkSection::Index(x & SECTION_MASK, y & SECTION_MASK, z & SECTION_MASK);
+    pending.Mask[index >> 6] |= 1ull << (index & 63);
+}
+
+void WorldReplicator::OnSectionChanged(const int chunkX, const int sectionY, const int chunkZ, const ChangeMask &mask)
+{
+    PendingSection &pending = GetPending(chunkX, sectionY, chunkZ);
+    for (size_t i = 0; i < mask.size(); i++)
+        pending.Mask[i] |= mask[i];
+}
+
+void WorldReplicator::WriteChunk(const int chunkX, const int chunkZ, std::vector<uint8_t> &packet) const
+{
+    const Chunk *chunk = std::as_const(m_World).GetChunk(chunkX, chunkZ);
+    if (!chunk)
+        return;
+
+    uint16_t sectionMask = 0;
+    for (int i = 0; i < CHUNK_SECTION_COUNT; i++)
+    {
+        const ChunkSection *section = chunk->GetSection(i);
+        if (section && !section->IsEmpty())
+            sectionMask |= 1 << i;
+    }
+
+    packet.push_back(static_cast<uint8_t>(ReplicationMessage::ChunkData));
+    WriteCoordinate(packet, chunkX);
+    WriteCoordinate(packet, chunkZ);
+    WriteFixed(packet, sectionMask, sizeof(sectionMask));
+    for (int i = 0; i < CHUNK_SECTION_COUNT; i++)
+    {
+        if (sectionMask >> i & 1)
+            WriteSection(packet, chunk->GetSection(i));
+    }
+}
+
+void WorldReplicator::WriteUnloadChunk(const int chunkX, const int chunkZ, std::vector<uint8_t> &packet)
+{
+    packet.push_back(static_cast<uint8_t>(ReplicationMessage::UnloadChunk));
+    WriteCoordinate(packet, chunkX);
+    WriteCoordinate(packet, chunkZ);
+}
+
+void WorldReplicator::WriteChanges(std::vector<uint8_t> &packet)
+{
+    m_LastStats = {};
+    const size_t start = packet.size();
+
+    for (const PendingSection &pending : m_Pending)
+    {
+        const Chunk *chunk = std::as_const(m_World).GetChunk(pending.ChunkX, pending.ChunkZ);
+        if (!chunk)
+            continue;
+        const ChunkSection *section = chunk->GetSection(pending.SectionY);
+        auto value = [section](const int i) {
+            return section ? PackBlock(section->Blocks[i], section->Metadata[i]) : PackBlock(BLOCK_AIR, 0);
+        };
+
+        size_t count = 0;
+        for (const uint64_t word : pending.Mask)
+            count += std::popcount(word);
+        m_LastStats.ChangedBlocks += count;
+        m_LastStats.Sections++;
+
+        // The changed blocks one by one
+        m_Delta.clear();
+        WriteSectionHeader(m_Delta, ReplicationMessage::SectionDelta, pending.ChunkX, pending.SectionY,
+                           pending.ChunkZ);
+        WriteVarint(m_Delta, count);
+        for (size_t word = 0; word < pending.Mask.size(); word++)
+        {
+            for (uint64_t bits = pending.Mask[word]; bits; bits &= bits - 1)
+            {
+                const int i = static_cast<int>(word * 64) + std::countr_zero(bits);
+                WriteFixed(m_Delta, i, sizeof(uint16_t));
+                WriteVarint(m_Delta, value(i) >> 8);
+                m_Delta.push_back(static_cast<uint8_t>(value(i)));
+            }
+        }
+
+        // As runs: the unchanged and changed runs of the mask, then the changed values as runs of equal blocks
+        size_t changedRuns = 0;
+        for (int i = 0; i < SECTION_VOLUME; i++)
+            changedRuns += IsChanged(pending.Mask, i) && (i == 0 || !IsChanged(pending.Mask, i - 1));
+        m_Runs.clear();
+        WriteSectionHeader(m_Runs, ReplicationMessage::MultiBlockChange, pending.ChunkX, pending.SectionY,
+                           pending.ChunkZ);
+        WriteVarint(m_Runs, changedRuns);
+        for (int i = 0, runEnd = 0; i < SECTION_VOLUME; i++)
+        {
+            if (!IsChanged(pending.Mask, i) || (i > 0 && IsChanged(pending.Mask, i - 1)))
+                continue;
+            int end = i + 1;
+            while (end < SECTION_VOLUME && IsChanged(pending.Mask, end))
+                end++;
+            WriteVarint(m_Runs, i - runEnd);
+            WriteVarint(m_Runs, end - i - 1);
+            runEnd = end;
+        }
+        size_t valueRuns = 0;
+        uint32_t previous = 0;
+        for (int i = 0; i < SECTION_VOLUME; i++)
+        {
+            if (IsChanged(pending.Mask, i) && (valueRuns == 0 || value(i) != previous))
+            {
+                valueRuns++;
+                previous = value(i);
+            }
+        }
+        WriteVarint(m_Runs, valueRuns);
+        size_t length = 0;
+        for (int i = 0; i <= SECTION_VOLUME; i++)
+        {
+            if (i < SECTION_VOLUME && !IsChanged(pending.Mask, i))
+                continue;
+            if (length > 0 && (i == SECTION_VOLUME || value(i) != previous))
+            {
+                WriteVarint(m_Runs, previous >> 8);
+                m_Runs.push_back(static_cast<uint8_t>(previous));
+                WriteVarint(m_Runs, length - 1);
+                length = 0;
+            }
+            if (i < SECTION_VOLUME)
+            {
+                previous = value(i);
+                length++;
+            }
+        }
+
+        // The whole section, only worth encoding when a good part of it changed
+        m_Section.clear();
+        if (count >= SECTION_DATA_THRESHOLD)
+        {
+            WriteSectionHeader(m_Section, ReplicationMessage::SectionData, pending.ChunkX, pending.SectionY,
+                               pending.ChunkZ);
+            WriteSection(m_Section, section);
+        }
+
+        const std::vector<uint8_t> *smallest = m_Delta.size() <= m_Runs.size() ? &m_Delta : &m_Runs;
+        if (!m_Section.empty() && m_Section.size() < smallest->size())
+            smallest = &m_Section;
+        packet.insert(packet.end(), smallest->begin(), smallest->end());
+        m_LastStats.SectionDeltas += smallest == &m_Delta;
+        m_LastStats.MultiBlockChanges += smallest == &m_Runs;
+        m_LastStats.SectionDatas += smallest == &m_Section;
+    }
+
+    m_LastStats.Bytes = packet.size() - start;
+    m_Pending.clear();
+    m_PendingIndex.clear();
+}
+
+WorldReplica::WorldReplica(World &world) : m_World(world)
+{
+}
+
+void WorldReplica::SetBlock(Chunk &chunk, const int sectionY, const int index, const BlockId id,
+                            const uint8_t metadata)
+{
+    const int x = index & SECTION_MASK;
+    const int y = sectionY * SECTION_SIZE + (index >> (2 * SECTION_SHIFT));
+    const int z = index >> SECTION_SHIFT & SECTION_MASK;
+    const BlockId previous = chunk.GetBlock(x, y, z);
+    if (previous == id && chunk.GetMetadata(x, y, z) == metadata)
+        return;
+
+    chunk.SetBlock(x, y, z, id, metadata);
+    if (previous != id)
+        m_World.GetLightEngine().OnBlockChanged(chunk.GetChunkX() * CHUNK_WIDTH + x, y,
+                                                chunk.GetChunkZ() * CHUNK_DEPTH + z, previous, id);
+
+    // Blocks on the border show in the meshes of the neighbours
+    chunk.MarkForRemesh();
+    const int dx = x == 0 ? -1 : x == SECTION_MASK ? 1 : 0;
+    const int dz = z == 0 ? -1 : z == SECTION_MASK ? 1 : 0;
+    if (dx != 0)
+    {
+        if (Chunk *neighbour = m_World.GetChunk(chunk.GetChunkX() + dx, chunk.GetChunkZ()))
+            neighbour->MarkForRemesh();
+    }
+    if (dz != 0)
+    {
+        if (Chunk *neighbour = m_World.GetChunk(chunk.GetChunkX(), chunk.GetChunkZ() + dz))
+            neighbour->MarkForRemesh();
+    }
+    m_LastChangedBlocks++;
+}
+
+bool WorldReplica::Apply(const std::span<const uint8_t> packet)
+{
+    // Messages are decoded in full before anything is applied, so a malformed one changes nothing
+    thread_local std::vector<uint32_t> values(CHUNK_SECTION_COUNT * SECTION_VOLUME);
+    thread_local std::vector<uint16_t> indices(SECTION_VOLUME);
+    auto sectionValues = [](const int sectionIndex) {
+        return std::span<uint32_t, SECTION_VOLUME>(values.data() + sectionIndex * SECTION_VOLUME, SECTION_VOLUME);
+    };
+
+    const auto maxId = static_cast<BlockId>(m_World.GetBlockRegistry().GetCount() - 1);
+    m_LastChangedBlocks = 0;
+    PacketReader reader(packet);
+    while (!reader.IsAtEnd())
+    {
+        const auto type = static_cast<ReplicationMessage>(reader.ReadFixed(1));
+        const int chunkX = reader.ReadCoordinate();
+        const int sectionY = type == ReplicationMessage::ChunkData || type == ReplicationMessage::UnloadChunk
+                                 ? 0
+                                 : static_cast<int>(reader.ReadFixed(1));
+        const int chunkZ = reader.ReadCoordinate();
+        if (sectionY >= CHUNK_SECTION_COUNT)
+            reader.Fail();
+
+        // Changed blocks of the section messages: their index in indices, their value in values
+        size_t count = 0;
+        switch (type)
+        {
+        case ReplicationMessage::ChunkData: {
+            const auto sectionMask = static_cast<uint16_t>(reader.ReadFixed(sizeof(uint16_t)));
+            for (int i = 0; i < CHUNK_SECTION_COUNT && reader.IsValid(); i++)
+            {
+                if ((sectionMask >> i & 1) && !ReadSection(reader, maxId, sectionValues(i)))
+                    reader.Fail();
+            }
+            if (!reader.IsValid())
+                break;
+
+            // A fresh chunk starts out as air
+            m_World.RemoveChunk(chunkX, chunkZ);
+            Chunk &chunk = m_World.AddChunk(chunkX, chunkZ);
+            for (int sectionIndex = 0; sectionIndex < CHUNK_SECTION_COUNT; sectionIndex++)
+            {
+                for (int i = 0; (sectionMask >> sectionIndex & 1) && i < SECTION_VOLUME; i++)
+                {
+                    const uint32_t value = values[sectionIndex * SECTION_VOLUME + i];
+                    if (value == PackBlock(BLOCK_AIR, 0))
+                        continue;
+                    chunk.SetBlock(i & SECTION_MASK, sectionIndex * SECTION_SIZE + (i >> (2 * SECTION_SHIFT)),
+                                   i >> SECTION_SHIFT & SECTION_MASK, static_cast<BlockId>(value >> 8),
+                                   static_cast<uint8_t>(value));
+                    m_LastChangedBlocks++;
+                }
+            }
+            m_World.GetLightEngine().LightChunk(chunkX, chunkZ);
+            for (const auto &[nx, nz] : {std::pair{-1, 0}, std::pair{1, 0}, std::pair{0, -1}, std::pair{0, 1}})
+            {
+                if (Chunk *neighbour = m_World.GetChunk(chunkX + nx, chunkZ + nz))
+                    neighbour->MarkForRemesh();
+            }
+            continue;
+        }
+        case ReplicationMessage::UnloadChunk:
+            if (!reader.IsValid())
+                break;
+            m_World.RemoveChunk(chunkX, chunkZ);
+            for (const auto &[nx, nz] : {std::pair{-1, 0}, std::pair{1, 0}, std::pair{0, -1}, std::pair{0, 1}})
+            {
+                if (Chunk *neighbour = m_World.GetChunk(chunkX + nx, chunkZ + nz))
+                    neighbour->MarkForRemesh();
+            }
+            continue;
+        case ReplicationMessage::SectionData:
+            if (!ReadSection(reader, maxId, sectionValues(0)))
+                reader.Fail();
+            for (int i = 0; i < SECTION_VOLUME; i++)
+                indices[i] = static_cast<uint16_t>(i);
+            count = SECTION_VOLUME;
+            break;
+        case ReplicationMessage::SectionDelta:
+            count = reader.ReadVarint(SECTION_VOLUME);
+            for (size_t i = 0; i < count && reader.IsValid(); i++)
+            {
+                indices[i] = static_cast<uint16_t>(reader.ReadFixed(sizeof(uint16_t)));
+                const auto id = static_cast<BlockId>(reader.ReadVarint(maxId));
+                values[i] = PackBlock(id, static_cast<uint8_t>(reader.ReadFixed(1)));
+                if (indices[i] >= SECTION_VOLUME)
+                    reader.Fail();
+            }
+            break;
+        case ReplicationMessage::MultiBlockChange: {
+            const size_t changedRuns = reader.ReadVarint(SECTION_VOLUME);
+            int index = 0;
+            for (size_t run = 0; run < changedRuns && reader.IsValid(); run++)
+            {
+                index += static_cast<int>(reader.ReadVarint(SECTION_VOLUME - index));
+                if (index == SECTION_VOLUME)
+                    reader.Fail();
+                const int end = index + static_cast<int>(reader.ReadVarint(SECTION_VOLUME - index - 1)) + 1;
+                for (; reader.IsValid() && index < end; index++)
+                    indices[count++] = static_cast<uint16_t>(index);
+            }
+            const size_t valueRuns = reader.ReadVarint(count);
+            size_t filled = 0;
+            for (size_t run = 0; run < valueRuns && reader.IsValid(); run++)
+            {
+                const auto id = static_cast<BlockId>(reader.ReadVarint(maxId));
+                const uint32_t value = PackBlock(id, static_cast<uint8_t>(reader.ReadFixed(1)));
+                if (filled == count)
+                    reader.Fail();
+                const size_t length = reader.ReadVarint(count - filled - 1) + 1;
+                if (reader.IsValid())
+                    std::fill_n(values.begin() + static_cast<std::ptrdiff_t>(filled), length, value);
+                filled += length;
+            }
+            if (filled != count)
+                reader.Fail();
+            break;
+        }
+        default:
+            reader.Fail();
+            break;
+        }
+
+        if (!reader.IsValid())
+        {
+            std::cerr << "Malformed replication message of type " << static_cast<int>(type) << std::endl;
+            return false;
+        }
+
+        if (Chunk *chunk = m_World.GetChunk(chunkX, chunkZ))
+        {
+            for (size_t i = 0; i < count; i++)
+                SetBlock(*chunk, sectionY, indices[i], static_cast<BlockId>(values[i] >> 8),
+                         static_cast<uint8_t>(values[i]));
+        }
+    }
+    return true;
+}
+
+} // namespace BloxxEngine
@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/World/WorldSaver.h"
+#include "BloxxEngine/Metrics.h"
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+constexpr uint32_t CHUNK_FILE_MAGIC = 0x48435842; // "BXCH"
+constexpr uint32_t CHUNK_FILE_VERSION = 1;
+
+/**
+ * A chunk file is the header followed by the runs of the sections in SectionMask, bottom to top. Each section is
+ * run length encoded over its blocks in section index order, its runs add up to SECTION_VOLUME exactly.
+ */
+#pragma pack(push, 1)
+struct ChunkFileHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    int32_t ChunkX;
+    int32_t ChunkZ;
+    uint16_t SectionMask;
+    uint16_t Reserved;
+    uint32_t RunCount;
+};
+
+struct ChunkFileRun
+{
+    BlockId Id;
+    uint8_t Metadata;
+    uint16_t Length;
+};
+#pragma pack(pop)
+
+void AppendRuns(std::vector<uint8_t> &buffer, const ChunkFileRun *runs, const size_t count)
+{
+    const size_t offset = buffer.size();
+    buffer.resize(offset + count * sizeof(ChunkFileRun));
+    std::memcpy(buffer.data() + offset, runs, count * sizeof(ChunkFileRun));
+}
+
+// Appends the runs of one section, returns their number
+uint32_t EncodeSection(const BlockId *blocks, const uint8_t *metadata, std::vector<uint8_t> &buffer)
+{
+    uint32_t runCount = 1;
+    ChunkFileRun run{blocks[0], metadata[0], 1};
+    for (int i = 1; i < SECTION_VOLUME; i++)
+    {
+        if (blocks[i] == run.Id && metadata[i] == run.Metadata)
+        {
+            run.Length++;
+            continue;
+        }
+        AppendRuns(buffer, &run, 1);
+        runCount++;
+        run = {blocks[i], metadata[i], 1};
+    }
+    AppendRuns(buffer, &run, 1);
+    return runCount;
+}
+
+/**
+ * Reads and validates the file of a chunk. Returns false when there is none, or with an error when it is damaged.
+ * sectionRuns receives the index of the first run of every section and one past the last run.
+ */
+bool ReadChunkFile(const std::filesystem::path &path, const int chunkX, const int chunkZ, ChunkFileHeader &header,
+                   std::vector<ChunkFileRun> &runs, std::vector<size_t> &sectionRuns)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    header = {};
+    if (data.size() >= sizeof(header))
+        std::memcpy(&header, data.data(), sizeof(header));
+
+    bool valid = header.Magic == CHUNK_FILE_MAGIC && header.Version == CHUNK_FILE_VERSION &&
+                 header.ChunkX == chunkX && header.ChunkZ == chunkZ &&
+                 data.size() == sizeof(header) + static_cast<size_t>(header.RunCount) * sizeof(ChunkFileRun);
+    if (valid)
+    {
+        runs.resize(header.RunCount);
+        std::memcpy(runs.data(), data.data() + sizeof(header), runs.size() * sizeof(ChunkFileRun));
+
+        // The runs have to cover the sections exactly
+        sectionRuns.assign(1, 0);
+        int covered = 0;
+        for (size_t i = 0; i < runs.size() && valid; i++)
+        {
+            covered += runs[i].Length;
+            valid = runs[i].Length > 0 && covered <= SECTION_VOLUME;
+            if (covered == SECTION_VOLUME)
+            {
+                sectionRuns.push_back(i + 1);
+                covered = 0;
+            }
+        }
+        valid &= covered == 0 && sectionRuns.size() == static_cast<size_t>(std::popcount(header.SectionMask)) + 1;
+    }
+
+    if (!valid)
+        std::cerr << "Chunk file " << path.string() << " is damaged" << std::endl;
+    return valid;
+}
+} // namespace
+
+WorldSaver::WorldSaver(World &world, std::filesystem::path directory)
+    : m_World(world), m_Directory(std::move(directory))
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_Directory, error);
+    if (error)
+        std::cerr << "Could not create save directory " << m_Directory.string() << ": " << error.message() << std::endl;
+}
+
+WorldSaver::~WorldSaver()
+{
+    Wait();
+}
+
+std::filesystem::path WorldSaver::GetChunkPath(const int chunkX, const int chunkZ) const
+{
+    return m_Directory / ("c." + std::to_string(chunkX) + "." + std::to_string(chunkZ) + ".bxc");
+}
+
+void WorldSaver::Update(const float deltaTime)
+{
+    if (m_NeedsFinish && !IsSaving())
+        FinishSave();
+
+    m_TimeSinceSave += deltaTime;
+    if (m_Settings.AutosaveInterval > 0.0 && m_TimeSinceSave >= m_Settings.AutosaveInterval && Save())
+        m_TimeSinceSave = 0.0;
+}
+
+bool WorldSaver::Save()
+{
+    if (IsSaving())
+        return false;
+    if (m_NeedsFinish)
+        FinishSave();
+
+    // The snapshot is the only part on this thread: a copy of the blocks of the edited sections, or of every section
+    // for chunks without a file yet. The buffers of the previous save are reused.
+    const auto start = std::chrono::steady_clock::now();
+    m_SnapshotCount = 0;
+    m_World.ForEachChunk([this](Chunk &chunk) {
+        if (!chunk.GetUnsavedSections())
+            return;
+
+        if (m_SnapshotCount == m_Snapshots.size())
+            m_Snapshots.emplace_back();
+        ChunkSnapshot &snapshot = m_Snapshots[m_SnapshotCount++];
+        snapshot.ChunkX = chunk.GetChunkX();
+        snapshot.ChunkZ = chunk.GetChunkZ();
+        snapshot.CopiedMask = m_ChunksOnDisk.contains(World::ChunkKey(snapshot.ChunkX, snapshot.ChunkZ))
+                                  ? chunk.GetUnsavedSections()
+                                  : std::numeric_limits<uint16_t>::max();
+        snapshot.SectionMask = 0;
+        snapshot.Failed = false;
+        chunk.MarkSaved();
+
+        size_t sectionCount = 0;
+        for (int i = 0; i < CHUNK_SECTION_COUNT; i++)
+        {
+            const ChunkSection *section = chunk.GetSection(i);
+            if ((snapshot.CopiedMask >> i & 1) && section && !section->IsEmpty())
+            {
+                snapshot.SectionMask |= 1 << i;
+                sectionCount++;
+            }
+        }
+
+        snapshot.Blocks.resize(sectionCount * SECTION_VOLUME);
+        snapshot.Metadata.resize(sectionCount * SECTION_VOLUME);
+        size_t offset = 0;
+        for (int i = 0; i < CHUNK_SECTION_COUNT; i++)
+        {
+            if (!(snapshot.SectionMask >> i & 1))
+                continue;
+            const ChunkSection &section = *chunk.GetSection(i);
+            std::ranges::copy(section.Blocks, snapshot.Blocks.begin() + static_cast<std::ptrdiff_t>(offset));
+            std::ranges::copy(section.Metadata, snapshot.Metadata.begin() + static_cast<std::ptrdiff_t>(offset));
+            offset += SECTION_VOLUME;
+        }
+    });
+    m_LastSnapshotTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (m_SnapshotCount == 0)
+        return true;
+
+    m_SaveStart = start;
+    m_BytesWritten = 0;
+    m_NeedsFinish = true;
+    m_Saving.store(true, std::memory_order_release);
+
+    ThreadPool *threadPool = m_World.GetThreadPool();
+    if (!threadPool || threadPool->GetWorkerCount() == 0)
+    {
+        WriteChunks(0, m_SnapshotCount);
+        m_SaveEnd = std::chrono::steady_clock::now();
+        m_Saving.store(false, std::memory_order_release);
+        FinishSave();
+        return true;
+    }
+
+    // One job per worker, the last one to finish completes the save
+    const size_t jobCount = std::min<size_t>(m_SnapshotCount, threadPool->GetWorkerCount());
+    m_RemainingJobs = jobCount;
+    for (size_t job = 0; job < jobCount; job++)
+    {
+        const size_t begin = m_SnapshotCount * job / jobCount;
+        const size_t end = m_SnapshotCount * (job + 1) / jobCount;
+        threadPool->Submit([this, begin, end] {
+            WriteChunks(begin, end);
+            if (m_RemainingJobs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+
+            m_SaveEnd = std::chrono::steady_clock::now();
+            // Notified under the lock, Wait() can't return and destroy this saver before it is done
+            std::lock_guard lock(m_DoneMutex);
+            m_Saving.store(false, std::memory_order_release);
+            m_Done.notify_all();
+        });
+    }
+    return true;
+}
+
+void WorldSaver::Wait()
+{
+    {
+        std::unique_lock lock(m_DoneMutex);
+        m_Done.wait(lock, [this] { return !IsSaving(); });
+    }
+    if (m_NeedsFinish)
+        FinishSave();
+}
+
+void WorldSaver::FinishSave()
+{
+    m_NeedsFinish = false;
+
+    // Failed chunks are saved in full by the next save, if they are still loaded
+    size_t failed = 0;
+    for (size_t i = 0; i < m_SnapshotCount; i++)
+    {
+        const ChunkSnapshot &snapshot = m_Snapshots[i];
+        const uint64_t key = World::ChunkKey(snapshot.ChunkX, snapshot.ChunkZ);
+        if (!snapshot.Failed)
+        {
+            m_ChunksOnDisk.insert(key);
+            continue;
+        }
+
+        failed++;
+        m_ChunksOnDisk.erase(key);
+        if (Chunk *chunk = m_World.GetChunk(snapshot.ChunkX, snapshot.ChunkZ))
+            chunk->MarkForSave();
+    }
+
+    m_LastChunkCount = m_SnapshotCount - failed;
+    m_LastBytesWritten = m_BytesWritten;
+    m_LastSaveTime = std::chrono::duration<double, std::milli>(m_SaveEnd - m_SaveStart).count();
+}
+
+void WorldSaver::WriteChunks(const size_t begin, const size_t end)
+{
+    thread_local std::vector<uint8_t> buffer;
+    for (size_t i = begin; i < end; i++)
+        m_Snapshots[i].Failed = !WriteChunk(m_Snapshots[i], buffer);
+}
+
+bool WorldSaver::WriteChunk(const ChunkSnapshot &snapshot, std::vector<uint8_t> &buffer)
+{
+    const std::filesystem::path path = GetChunkPath(snapshot.ChunkX, snapshot.ChunkZ);
+
+    // The sections the snapshot doesn't cover come from the current file
+    thread_local ChunkFileHeader previous;
+    thread_local std::vector<ChunkFileRun> previousRuns;
+    thread_local std::vector<size_t> previousSectionRuns;
+    if (snapshot.CopiedMask != std::numeric_limits<uint16_t>::max() &&
+        !ReadChunkFile(path, snapshot.ChunkX, snapshot.ChunkZ, previous, previousRuns, previousSectionRuns))
+    {
+        std::cerr << "Could not merge " << path.string() << ", saving it in full next time" << std::endl;
+        return false;
+    }
+
+    buffer.resize(sizeof(ChunkFileHeader));
+    ChunkFileHeader header{CHUNK_FILE_MAGIC, CHUNK_FILE_VERSION, snapshot.ChunkX, snapshot.ChunkZ, 0, 0, 0};
+    size_t offset = 0;
+    int previousSection = 0;
+    for (int i = 0; i < CHUNK_SECTION_COUNT; i++)
+    {
+        if (snapshot.SectionMask >> i & 1)
+        {
+            header.RunCount += EncodeSection(&snapshot.Blocks[offset], &snapshot.Metadata[offset], buffer);
+            header.SectionMask |= 1 << i;
+            offset += SECTION_VOLUME;
+        }
+        else if (!(snapshot.CopiedMask >> i & 1) && (previous.SectionMask >> i & 1))
+        {
+            const size_t first = previousSectionRuns[previousSection];
+            const size_t count = previousSectionRuns[previousSection + 1] - first;
+            AppendRuns(buffer, &previousRuns[first], count);
+            header.RunCount += static_cast<uint32_t>(count);
+            header.SectionMask |= 1 << i;
+        }
+        previousSection += previous.SectionMask >> i & 1;
+    }
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    // Write next to the target and rename, so the previous version stays intact until the new one is complete
+    const std::filesystem::path tempPath = std::filesystem::path(path).concat(".tmp");
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        file.close();
+        if (!file)
+        {
+            std::cerr << "Failed writing " << tempPath.string() << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::cerr << "Could not replace " << path.string() << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    m_BytesWritten.fetch_add(buffer.size(), std::memory_order_relaxed);
+    static Counter &savedBytes = Metrics::GetCounter("world.saved_bytes");
+    savedBytes.Add(buffer.size());
+    return true;
+}
+
+bool WorldSaver::LoadChunk(Chunk &chunk)
+{
+    ChunkFileHeader header;
+    std::vector<ChunkFileRun> runs;
+    std::vector<size_t> sectionRuns;
+    if (!ReadChunkFile(GetChunkPath(chunk.GetChunkX(), chunk.GetChunkZ()), chunk.GetChunkX(), chunk.GetChunkZ(),
+                       header, runs, sectionRuns))
+        return false;
+
+    // Through SetBlock, which keeps the occupancy masks and block counts of the sections up to date
+    size_t run = 0;
+    for (int sectionIndex = 0; sectionIndex < CHUNK_SECTION_COUNT; sectionIndex++)
+    {
+        auto setBlock = [&chunk, sectionY = sectionIndex * SECTION_SIZE](const int i, const BlockId id,
+                                                                         const uint8_t metadata) {
+            chunk.SetBlock(i & SECTION_MASK, sectionY + (i >> 2 * SECTION_SHIFT), i >> SECTION_SHIFT & SECTION_MASK, id,
+                           metadata);
+        };
+
+        if (!(header.SectionMask >> sectionIndex & 1))
+        {
+            // Sections left out of the file are air
+            const ChunkSection *section = chunk.GetSection(sectionIndex);
+            for (int i = 0; section && !section->IsEmpty() && i < SECTION_VOLUME; i++)
+            {
+                if (section->Blocks[i] != BLOCK_AIR)
+                    setBlock(i, BLOCK_AIR, 0);
+            }
+            continue;
+        }
+
+        for (int i = 0; i < SECTION_VOLUME; run++)
+        {
+            for (const int end = i + runs[run].Length; i < end; i++)
+                setBlock(i, runs[run].Id, runs[run].Metadata);
+        }
+    }
+
+    chunk.MarkForRemesh();
+    m_ChunksOnDisk.insert(World::ChunkKey(chunk.GetChunkX(), chunk.GetChunkZ()));
+    return true;
+}
+
+} // namespace BloxxEngine
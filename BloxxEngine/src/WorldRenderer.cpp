@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "BloxxEngine/WorldRenderer.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <ranges>
+#include <utility>
+
+namespace BloxxEngine
+{
+
+namespace
+{
+
+// Meshes of unloaded chunks kept for reuse, the rest is freed with its GL buffers
+constexpr size_t MESH_POOL_LIMIT = 256;
+
+constexpr std::pair<int, int> NEIGHBOURS[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+// Chunk coordinates back from a mesh map key
+int KeyChunkX(const uint64_t key)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+}
+
+int KeyChunkZ(const uint64_t key)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(key));
+}
+
+float HorizontalDistanceSquared(const int chunkX, const int chunkZ, const glm::vec3 &cameraPosition)
+{
+    const float dx = (static_cast<float>(chunkX) + 0.5f) * CHUNK_WIDTH - cameraPosition.x;
+    const float dz = (static_cast<float>(chunkZ) + 0.5f) * CHUNK_DEPTH - cameraPosition.z;
+    return dx * dx + dz * dz;
+}
+
+} // namespace
+
+WorldRenderer::WorldRenderer(World &world, ThreadPool *threadPool) : m_World(world), m_ThreadPool(threadPool)
+{
+}
+
+WorldRenderer::~WorldRenderer() = default;
+
+ChunkMesh &WorldRenderer::GetOrCreateMesh(const int chunkX, const int chunkZ)
+{
+    const uint64_t key = World::ChunkKey(chunkX, chunkZ);
+    if (const auto it = m_Meshes.find(key); it != m_Meshes.end())
+        return *it->second;
+
+    if (m_MeshPool.empty())
+        return *m_Meshes.emplace(key, std::make_unique<ChunkMesh>()).first->second;
+
+    MeshMap::node_type node = std::move(m_MeshPool.back());
+    m_MeshPool.pop_back();
+    node.key() = key;
+    node.mapped()->Reset();
+    return *m_Meshes.insert(std::move(node)).position->second;
+}
+
+const ChunkMesh *WorldRenderer::GetMesh(const int chunkX, const int chunkZ) const
+{
+    const auto it = m_Meshes.find(World::ChunkKey(chunkX, chunkZ));
+    return it != m_Meshes.end() ? it->second.get() : nullptr;
+}
+
+void WorldRenderer::UpdateLods(const glm::vec3 &cameraPosition)
+{
+    m_LodCounts.fill(0);
+    m_World.ForEachChunk([this, &cameraPosition](Chunk &chunk) {
+        ChunkMesh &mesh = GetOrCreateMesh(chunk.GetChunkX(), chunk.GetChunkZ());
+        const float distance =
+            std::sqrt(HorizontalDistanceSquared(chunk.GetChunkX(), chunk.GetChunkZ(), cameraPosition));
+
+        int lod = mesh.GetLod();
+        while (lod < CHUNK_LOD_COUNT - 1 && distance > m_LodSettings.Distances[lod] + m_LodSettings.Hysteresis)
+            lod++;
+        while (lod > 0 && distance < m_LodSettings.Distances[lod - 1] - m_LodSettings.Hysteresis)
+            lod--;
+        m_LodCounts[lod]++;
+
+        if (lod == mesh.GetLod())
+            return;
+        mesh.SetLod(lod);
+        chunk.MarkForRemesh();
+        for (const auto &[nx, nz] : NEIGHBOURS)
+        {
+            if (Chunk *neighbour = m_World.GetChunk(chunk.GetChunkX() + nx, chunk.GetChunkZ() + nz))
+                neighbour->MarkForRemesh();
+        }
+    });
+}
+
+void WorldRenderer::UpdateMeshes()
+{
+    // Meshes whose chunk was unloaded go back to the pool
+    for (auto it = m_Meshes.begin(); it != m_Meshes.end();)
+    {
+        const uint64_t key = it->first;
+        ++it;
+        if (m_World.GetChunk(KeyChunkX(key), KeyChunkZ(key)))
+            continue;
+        MeshMap::node_type node = m_Meshes.extract(key);
+        if (m_MeshPool.size() < MESH_POOL_LIMIT)
+            m_MeshPool.push_back(std::move(node));
+    }
+
+    // Meshes are created up front, the workers only look them up
+    m_RemeshJobs.clear();
+    m_World.ForEachChunk([this](Chunk &chunk) {
+        if (chunk.NeedsRemesh())
+            m_RemeshJobs.push_back({&chunk, &GetOrCreateMesh(chunk.GetChunkX(), chunk.GetChunkZ()), {}});
+    });
+    if (m_RemeshJobs.empty())
+        return;
+
+    // Borders towards neighbours at another level of detail get skirts, indexed [x or z][positive side]
+    for (RemeshJob &job : m_RemeshJobs)
+    {
+        for (int side = 0; side < 2; side++)
+        {
+            for (int positive = 0; positive < 2; positive++)
+            {
+                const int offset = positive ? 1 : -1;
+                const ChunkMesh *neighbour = side == 0
+                                                 ? GetMesh(job.Source->GetChunkX() + offset, job.Source->GetChunkZ())
+                                                 : GetMesh(job.Source->GetChunkX(), job.Source->GetChunkZ() + offset);
+                job.Skirts[side][positive] = neighbour && neighbour->GetLod() != job.Mesh->GetLod();
+            }
+        }
+    }
+
+    auto generate = [this](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            RemeshJob &job = m_RemeshJobs[i];
+            job.Mesh->Generate(m_World, *job.Source, job.Skirts);
+            job.Source->MarkMeshed();
+        }
+    };
+    if (m_ThreadPool)
+        m_ThreadPool->ParallelFor(m_RemeshJobs.size(), 1, generate);
+    else
+        generate(0, m_RemeshJobs.size());
+}
+
+int WorldRenderer::Draw()
+{
+    int drawCalls = 0;
+    for (const auto &mesh : m_Meshes | std::views::values)
+        drawCalls += mesh->Draw();
+    return drawCalls;
+}
+
+void WorldRenderer::GatherTranslucent(const glm::vec3 &cameraPosition)
+{
+    m_TranslucentMeshes.clear();
+    for (const auto &[key, mesh] : m_Meshes)
+    {
+        if (mesh->HasTranslucent())
+            m_TranslucentMeshes.push_back(
+                {mesh.get(), HorizontalDistanceSquared(KeyChunkX(key), KeyChunkZ(key), cameraPosition)});
+    }
+}
+
+int WorldRenderer::DrawTranslucent(const glm::vec3 &cameraPosition)
+{
+    // Far to near by chunk column, each mesh orders its own sections
+    GatherTranslucent(cameraPosition);
+    std::ranges::sort(m_TranslucentMeshes, std::ranges::greater{}, &TranslucentMesh::Distance);
+
+    int drawCalls = 0;
+    for (const TranslucentMesh &translucent : m_TranslucentMeshes)
+        drawCalls += translucent.Mesh->DrawTranslucent(cameraPosition);
+    return drawCalls;
+}
+
+int WorldRenderer::SortTranslucent(const glm::vec3 &cameraPosition)
+{
+    GatherTranslucent(cameraPosition);
+
+    std::atomic<int> sortedCount{0};
+    auto sort = [this, &cameraPosition, &sortedCount](const size_t begin, const size_t end) {
+        int sorted = 0;
+        for (size_t i = begin; i < end; i++)
+            sorted += m_TranslucentMeshes[i].Mesh->SortTranslucent(cameraPosition);
+        sortedCount += sorted;
+    };
+    if (m_ThreadPool)
+        m_ThreadPool->ParallelFor(m_TranslucentMeshes.size(), 4, sort);
+    else
+        sort(0, m_TranslucentMeshes.size());
+    return sortedCount;
+}
+
+} // namespace BloxxEngine
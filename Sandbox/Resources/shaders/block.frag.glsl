@@ -19,12 +19,14 @@ in vec2 TexCoords;
 in vec3 Tangent;
 in vec3 Bitangent;
 in vec3 Normal;
+in float VertexAO;
 
 out vec4 FragColor;
 
 uniform Material material;
 uniform Light light;
 uniform vec3 viewPos;      // Camera position
+uniform float opacity;     // Below 1 for the translucent pass
 
 vec2 ParallaxMapping(vec2 texCoords, vec3 viewDir, float heightScale) {
     // Sample height map
@@ -61,7 +63,7 @@ void main() {
     vec3 albedo = texture(material.albedo, texCoords).rgb;
     float roughness = texture(material.rmah, texCoords).r;
     float metallic = texture(material.rmah, texCoords).g;
-    float ao = texture(material.rmah, texCoords).b;
+    float ao = texture(material.rmah, texCoords).b * VertexAO;
 
     vec3 normalMap = texture(material.normal, texCoords).rgb;
     normalMap = normalize(normalMap * 2.0 - 1.0); // Transform from [0,1] to [-1,1]
@@ -110,5 +112,5 @@ void main() {
     // Apply gamma correction for sRGB
     color = pow(color, vec3(1.0 / 2.2));
 
-    FragColor = vec4(color, 1.0);
+    FragColor = vec4(color, opacity);
 }
@@ -5,12 +5,14 @@ layout(location = 1) in vec3 aNormal;    // Normal attribute
 layout(location = 2) in vec2 aTexCoords; // Texture coordinate attribute
 layout(location = 3) in vec3 aTangent;   // Tangent attribute
 layout(location = 4) in vec3 aBitangent; // Bitangent attribute
+layout(location = 5) in float aAmbientOcclusion; // Baked voxel occlusion
 
 out vec3 FragPos;
 out vec2 TexCoords;
 out vec3 Tangent;
 out vec3 Bitangent;
 out vec3 Normal;
+out float VertexAO;
 
 uniform mat4 model;
 uniform mat4 view;
@@ -22,6 +24,7 @@ void main() {
 
     // Pass texture coordinates to fragment shader
     TexCoords = aTexCoords;
+    VertexAO = aAmbientOcclusion;
 
     // Transform normal, tangent, and bitangent vectors
     mat3 normalMatrix = transpose(inverse(mat3(model)));
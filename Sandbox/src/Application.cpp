@@ -1,15 +1,47 @@
 #include <BloxxEngine.h>
 
-int main()
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main(int argc, char **argv)
 {
     BloxxEngine::Renderer renderer;
 
+    // --record <file> records this session's input, --replay <file> [--frame-log <file>] plays one back for a
+    // reproducible performance run and exits with a frame time summary
+    std::string recordPath, replayPath, frameLogPath;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--record") == 0)
+            recordPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--replay") == 0)
+            replayPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--frame-log") == 0)
+            frameLogPath = argv[i + 1];
+        else
+            std::cerr << "Ignoring unknown argument " << argv[i] << std::endl;
+    }
+
+    if (!replayPath.empty() && !renderer.LoadReplay(replayPath, frameLogPath))
+    {
+        return EXIT_FAILURE;
+    }
+
     if (!renderer.Initialize("Sandbox", 1024, 768))
     {
         return EXIT_FAILURE;
     }
 
+#ifdef SANDBOX_RESOURCE_DIR
+    // Pick up edits to the source resources while running
+    renderer.EnableHotReload(SANDBOX_RESOURCE_DIR);
+#endif
+
+    if (!recordPath.empty())
+        renderer.StartRecording(recordPath);
+
     renderer.Run();
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+// Dedicated server: runs the world simulation at a fixed tick rate without a window, GL or meshing
+
+#include "BloxxEngine/Metrics.h"
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/DefaultBlocks.h"
+#include "BloxxEngine/World/TerrainGenerator.h"
+#include "BloxxEngine/World/World.h"
+#include "BloxxEngine/World/WorldSaver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace BloxxEngine;
+
+struct ServerSettings
+{
+    double TickRate = 20.0;
+    int Radius = 12; // Chunks around the origin, the same patch the client generates
+    uint32_t Seed = 1337;
+    std::string SaveDirectory = "Saves/World";
+    uint64_t Ticks = 0; // Stop after this many ticks, 0 runs until interrupted
+    double ReportInterval = 5.0; // Seconds between tick timing reports
+    int MaxCatchUpTicks = 5; // Ticks run back to back after a stall before the backlog is dropped
+    std::string MetricsPath; // Metrics dumps for soak tests, CSV or .json lines, none when empty
+    double MetricsInterval = 10.0; // Seconds between metrics dumps
+};
+
+constexpr double TICK_TIME_BOUNDS[] = {0.5, 1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0, 250.0};
+
+std::atomic<bool> s_Running{true};
+
+void OnSignal(int)
+{
+    s_Running = false;
+}
+
+void PrintUsage()
+{
+    std::cerr << "Usage: BloxxServer [--tick-rate hz] [--radius chunks] [--seed n] [--save directory] [--ticks n]"
+                 " [--report seconds] [--metrics file] [--metrics-interval seconds]"
+              << std::endl;
+}
+
+bool ParseArguments(const int argc, char **argv, ServerSettings &settings)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *name = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << name << std::endl;
+            return false;
+        }
+        const char *value = argv[++i];
+
+        if (std::strcmp(name, "--tick-rate") == 0)
+            settings.TickRate = std::atof(value);
+        else if (std::strcmp(name, "--radius") == 0)
+            settings.Radius = std::atoi(value);
+        else if (std::strcmp(name, "--seed") == 0)
+            settings.Seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (std::strcmp(name, "--save") == 0)
+            settings.SaveDirectory = value;
+        else if (std::strcmp(name, "--ticks") == 0)
+            settings.Ticks = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(name, "--report") == 0)
+            settings.ReportInterval = std::atof(value);
+        else if (std::strcmp(name, "--metrics") == 0)
+            settings.MetricsPath = value;
+        else if (std::strcmp(name, "--metrics-interval") == 0)
+            settings.MetricsInterval = std::atof(value);
+        else
+        {
+            std::cerr << "Unknown argument " << name << std::endl;
+            return false;
+        }
+    }
+
+    if (settings.TickRate <= 0.0 || settings.Radius < 0 || settings.ReportInterval <= 0.0 ||
+        settings.MetricsInterval <= 0.0)
+    {
+        std::cerr << "Tick rate and intervals must be positive, the radius can't be negative" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Generates the patch around the origin on the workers, chunks saved earlier replace their generated terrain
+void LoadWorld(World &world, WorldSaver &saver, ThreadPool &threadPool, const ServerSettings &settings)
+{
+    TerrainGenerator::Settings terrain = RegisterDefaultBlocks(world);
+    terrain.Seed = settings.Seed;
+    const TerrainGenerator generator(terrain);
+
+    std::vector<Chunk *> chunks;
+    for (int chunkX = -settings.Radius; chunkX < settings.Radius; chunkX++)
+    {
+        for (int chunkZ = -settings.Radius; chunkZ < settings.Radius; chunkZ++)
+            chunks.push_back(&world.AddChunk(chunkX, chunkZ));
+    }
+    threadPool.ParallelFor(chunks.size(), 1, [&generator, &chunks](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++)
+            generator.Generate(*chunks[i]);
+    });
+
+    size_t loaded = 0;
+    for (Chunk *chunk : chunks)
+        loaded += saver.LoadChunk(*chunk);
+
+    for (const Chunk *chunk : chunks)
+        world.GetLightEngine().LightChunk(chunk->GetChunkX(), chunk->GetChunkZ());
+    world.GetLightEngine().Propagate();
+
+    std::cout << "Generated " << chunks.size() << " chunks, " << loaded << " loaded from " << settings.SaveDirectory
+              << std::endl;
+}
+
+} // namespace
+
+int main(const int argc, char **argv)
+{
+    ServerSettings settings;
+    if (!ParseArguments(argc, argv, settings))
+    {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    ThreadPool threadPool;
+    World world(&threadPool);
+    WorldSaver saver(world, settings.SaveDirectory);
+    LoadWorld(world, saver, threadPool, settings);
+
+    using Clock = std::chrono::steady_clock;
+    const auto fixedDeltaTime = static_cast<float>(1.0 / settings.TickRate);
+    const auto tickDuration =
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / settings.TickRate));
+    const auto reportDuration =
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(settings.ReportInterval));
+
+    // Tick timings since the last report, in milliseconds
+    uint64_t ticks = 0, reportTicks = 0, droppedTicks = 0;
+    double tickTimeSum = 0.0, tickTimeMax = 0.0;
+
+    Histogram &tickTimes = Metrics::GetHistogram("server.tick_ms", TICK_TIME_BOUNDS);
+    Counter &droppedTicksCounter = Metrics::GetCounter("server.dropped_ticks");
+    Gauge &fluidCells = Metrics::GetGauge("world.active_fluid_cells");
+    std::unique_ptr<MetricsDumper> metricsDumper;
+    if (!settings.MetricsPath.empty())
+        metricsDumper = std::make_unique<MetricsDumper>(settings.MetricsPath, settings.MetricsInterval);
+
+    std::cout << "Running at " << settings.TickRate << " ticks per second on " << threadPool.GetWorkerCount()
+              << " workers" << std::endl;
+
+    auto nextTick = Clock::now() + tickDuration;
+    auto lastReport = Clock::now();
+    while (s_Running && (settings.Ticks == 0 || ticks < settings.Ticks))
+    {
+        std::this_thread::sleep_until(nextTick);
+
+        // The whole simulation step, block ticks, fluids and lighting. Nothing is meshed, there are no meshes.
+        const auto tickStart = Clock::now();
+        world.Update(fixedDeltaTime);
+        saver.Update(fixedDeltaTime);
+        const double tickTime = std::chrono::duration<double, std::milli>(Clock::now() - tickStart).count();
+
+        ticks++;
+        reportTicks++;
+        tickTimeSum += tickTime;
+        tickTimeMax = std::max(tickTimeMax, tickTime);
+        tickTimes.Record(tickTime);
+        nextTick += tickDuration;
+
+        // Same catch-up limit as the client's simulation thread
+        const auto behind = Clock::now() - nextTick;
+        if (behind > tickDuration * settings.MaxCatchUpTicks)
+        {
+            const auto dropped = behind / tickDuration;
+            droppedTicks += static_cast<uint64_t>(dropped);
+            droppedTicksCounter.Add(static_cast<uint64_t>(dropped));
+            nextTick += tickDuration * dropped;
+        }
+
+        if (metricsDumper)
+        {
+            fluidCells.Set(static_cast<double>(world.GetFluidSimulator().GetActiveCellCount()));
+            metricsDumper->Update(fixedDeltaTime);
+        }
+
+        const auto now = Clock::now();
+        if (now - lastReport >= reportDuration)
+        {
+            const double seconds = std::chrono::duration<double>(now - lastReport).count();
+            std::cout << "Tick " << ticks << ": " << tickTimeSum / static_cast<double>(reportTicks) << " ms avg, "
+                      << tickTimeMax << " ms max, " << static_cast<double>(reportTicks) / seconds
+                      << " ticks/s, " << droppedTicks << " dropped, "
+                      << world.GetFluidSimulator().GetActiveCellCount() << " active fluid cells" << std::endl;
+            reportTicks = 0;
+            tickTimeSum = 0.0;
+            tickTimeMax = 0.0;
+            lastReport = now;
+        }
+    }
+
+    // Save what changed since the last autosave
+    std::cout << "Stopping after " << ticks << " ticks, saving" << std::endl;
+    saver.Wait();
+    saver.Save();
+    saver.Wait();
+    std::cout << "Saved " << saver.GetLastChunkCount() << " chunks" << std::endl;
+    return EXIT_SUCCESS;
+}
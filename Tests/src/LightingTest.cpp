@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Test.h"
+
+#include "BloxxEngine/World/World.h"
+
+#include <random>
+
+namespace BloxxTest
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+// Chunks from -CHUNK_RADIUS up to CHUNK_RADIUS on both axes
+constexpr int CHUNK_RADIUS = 2;
+constexpr int RANDOM_EDITS = 400;
+// Edits between two runs of the queued lighting, so some runs handle several overlapping edits at once
+constexpr int MAX_EDITS_PER_RUN = 4;
+constexpr int CHECK_INTERVAL = 25; // Runs of the queued lighting
+} // namespace
+
+void TestLighting()
+{
+    World world;
+    const TerrainGenerator::Settings terrain = GenerateTerrain(world, CHUNK_RADIUS);
+    const BlockId lamp = RegisterLamp(world);
+    const int extent = CHUNK_RADIUS * SECTION_SIZE;
+
+    LightWorld(world);
+    CHECK(!world.GetLightEngine().HasPendingWork());
+    CHECK(CountLightDifferences(world) == 0);
+
+    // Single blocks around the surface, on chunk borders as well, in the same order every run
+    std::mt19937 random(34);
+    std::uniform_int_distribution<int> horizontal(-extent, extent - 1);
+    std::uniform_int_distribution<int> height(terrain.BaseHeight - 24, terrain.BaseHeight + 24);
+    std::uniform_int_distribution<int> editsPerRun(1, MAX_EDITS_PER_RUN);
+    const BlockId blocks[] = {BLOCK_AIR, terrain.Stone, terrain.Water, lamp};
+    std::uniform_int_distribution<size_t> block(0, std::size(blocks) - 1);
+    for (int edit = 0, run = 1; edit < RANDOM_EDITS; run++)
+    {
+        for (int i = editsPerRun(random); i > 0 && edit < RANDOM_EDITS; i--, edit++)
+            world.SetBlock(horizontal(random), height(random), horizontal(random), blocks[block(random)]);
+        world.GetLightEngine().Propagate();
+        if (run % CHECK_INTERVAL == 0)
+            CHECK(CountLightDifferences(world) == 0);
+    }
+    CHECK(CountLightDifferences(world) == 0);
+
+    // A lamp above the terrain lights its surroundings, and takes its light along when it is removed
+    const int surface = terrain.BaseHeight + 30;
+    world.SetBlock(3, surface, 3, lamp);
+    world.GetLightEngine().Propagate();
+    CHECK(world.GetBlockLight(3, surface + 1, 3) == 13);
+    world.SetBlock(3, surface, 3, BLOCK_AIR);
+    world.GetLightEngine().Propagate();
+    CHECK(world.GetBlockLight(3, surface + 1, 3) == 0);
+    CHECK(world.GetSkyLight(3, surface, 3) == MAX_LIGHT_LEVEL);
+    CHECK(CountLightDifferences(world) == 0);
+}
+
+} // namespace BloxxTest
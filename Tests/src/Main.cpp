@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+// Tests of the GL free world code. Run without arguments for all of them, or name the ones to run.
+
+#include "Test.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+
+struct Test
+{
+    const char *Name;
+    void (*Run)();
+};
+
+constexpr Test TESTS[] = {
+    {"worldsaver", BloxxTest::TestWorldSaver},
+    {"replication", BloxxTest::TestReplication},
+    {"worldedit", BloxxTest::TestWorldEdit},
+    {"lighting", BloxxTest::TestLighting},
+};
+
+size_t failureCount = 0;
+
+} // namespace
+
+namespace BloxxTest
+{
+
+bool Check(const bool condition, const char *expression, const char *file, const int line)
+{
+    if (!condition)
+    {
+        std::cerr << file << ':' << line << ": CHECK(" << expression << ") failed" << std::endl;
+        failureCount++;
+    }
+    return condition;
+}
+
+size_t GetFailureCount()
+{
+    return failureCount;
+}
+
+} // namespace BloxxTest
+
+int main(const int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::ranges::none_of(TESTS, [&](const Test &test) { return std::strcmp(test.Name, argv[i]) == 0; }))
+        {
+            std::cerr << "Unknown test " << argv[i] << ", available:";
+            for (const Test &test : TESTS)
+                std::cerr << ' ' << test.Name;
+            std::cerr << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    bool passed = true;
+    for (const Test &test : TESTS)
+    {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc; i++)
+            selected |= std::strcmp(test.Name, argv[i]) == 0;
+        if (!selected)
+            continue;
+
+        std::cout << "== " << test.Name << std::endl;
+        const size_t failures = BloxxTest::GetFailureCount();
+        test.Run();
+        if (BloxxTest::GetFailureCount() != failures)
+        {
+            std::cerr << test.Name << " failed " << BloxxTest::GetFailureCount() - failures << " checks" << std::endl;
+            passed = false;
+        }
+    }
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
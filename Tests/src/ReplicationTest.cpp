@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Test.h"
+
+#include "BloxxEngine/World/World.h"
+#include "BloxxEngine/World/WorldReplication.h"
+
+#include <random>
+#include <span>
+#include <vector>
+
+namespace BloxxTest
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+// Chunks from -CHUNK_RADIUS up to CHUNK_RADIUS on both axes
+constexpr int CHUNK_RADIUS = 2;
+constexpr int GARBAGE_PACKETS = 2000;
+
+// Sends the changes since the last call, the client has to end up with the blocks of the server
+void CheckSync(WorldReplicator &replicator, WorldReplica &replica, World &server, World &client)
+{
+    std::vector<uint8_t> packet;
+    replicator.WriteChanges(packet);
+    CHECK(!replicator.HasChanges());
+    CHECK(replica.Apply(packet));
+    CHECK(CopyBlocks(client) == CopyBlocks(server));
+}
+} // namespace
+
+void TestReplication()
+{
+    World server;
+    World client;
+    const TerrainGenerator::Settings terrain = GenerateTerrain(server, CHUNK_RADIUS);
+    // Only the block registry of the server, its chunks come through the replication
+    GenerateTerrain(client, 0);
+    const int extent = CHUNK_RADIUS * SECTION_SIZE;
+
+    WorldReplicator replicator(server);
+    WorldReplica replica(client);
+
+    // Generated terrain isn't a change, clients get it with the chunks
+    CHECK(!replicator.HasChanges());
+    std::vector<uint8_t> packet;
+    for (int chunkX = -CHUNK_RADIUS; chunkX < CHUNK_RADIUS; chunkX++)
+    {
+        for (int chunkZ = -CHUNK_RADIUS; chunkZ < CHUNK_RADIUS; chunkZ++)
+            replicator.WriteChunk(chunkX, chunkZ, packet);
+    }
+    CHECK(replica.Apply(packet));
+    CHECK(CopyBlocks(client) == CopyBlocks(server));
+
+    // A few scattered blocks, and one changed back within the same tick
+    server.SetBlock(-extent, 70, -extent, terrain.Stone, 9);
+    server.SetBlock(3, 200, 3, terrain.Grass);
+    server.SetBlock(extent - 1, 0, extent - 1, BLOCK_AIR);
+    server.SetBlock(5, 150, -5, terrain.Dirt);
+    server.SetBlock(5, 150, -5, BLOCK_AIR);
+    CheckSync(replicator, replica, server, client);
+    CHECK(replicator.GetLastStats().SectionDeltas > 0);
+
+    // Bulk edits across chunk borders, then undoing one of them
+    const EditJournal fill = server.FillBox({-20, 60, -20}, {20, 90, 20}, terrain.Stone, 1);
+    CheckSync(replicator, replica, server, client);
+    CHECK(replicator.GetLastStats().SectionDatas > 0);
+
+    server.Replace({-extent, 0, -extent}, {extent - 1, CHUNK_HEIGHT - 1, 0}, terrain.Stone, terrain.Dirt, 4);
+    CheckSync(replicator, replica, server, client);
+
+    server.FillBox({-30, 95, 2}, {30, 95, 2}, terrain.Grass);
+    CheckSync(replicator, replica, server, client);
+    CHECK(replicator.GetLastStats().MultiBlockChanges > 0);
+
+    server.ApplyJournal(fill);
+    CheckSync(replicator, replica, server, client);
+
+    // Unloaded chunks are removed on the client and edits to them are skipped
+    WorldReplicator::WriteUnloadChunk(1, 1, packet = {});
+    CHECK(replica.Apply(packet));
+    CHECK(!client.GetChunk(1, 1));
+    server.SetBlock(extent - 1, 100, extent - 1, terrain.Stone);
+    replicator.WriteChanges(packet = {});
+    CHECK(replica.Apply(packet));
+    CHECK(!client.GetChunk(1, 1));
+    replicator.WriteChunk(1, 1, packet = {});
+    CHECK(replica.Apply(packet));
+    CHECK(CopyBlocks(client) == CopyBlocks(server));
+
+    // Every truncation of a packet fails at its last message, and the complete packet still repairs the client
+    server.FillSphere({0, 80, 0}, 12, terrain.Grass, 2);
+    server.SetBlock(-7, 40, 9, terrain.Stone, 3);
+    replicator.WriteChanges(packet = {});
+    CHECK(packet.size() > 1);
+    const std::span<const uint8_t> complete(packet);
+    CHECK(!replica.Apply(complete.first(packet.size() - 1)));
+    for (size_t size = 1; size < packet.size(); size++)
+        replica.Apply(complete.first(size));
+    CHECK(replica.Apply(complete));
+    CHECK(CopyBlocks(client) == CopyBlocks(server));
+
+    // Malformed messages change nothing
+    const std::vector<std::vector<uint8_t>> malformed = {
+        {0},                                  // Unknown message type
+        {0xFF, 0, 0},                         // Unknown message type
+        {3, 0, 0, 0, 0},                      // Empty palette
+        {3, 0, 16, 0, 1, 1, 0},               // Section above the chunk
+        {3, 0, 0, 0, 1, 0xFF, 0xFF, 0x03, 0}, // Block id the client doesn't know
+        {3, 0, 0, 0, 2, 1, 0, 2, 0, 7},       // Unknown section encoding
+        {4, 0, 0, 0, 1, 0x00, 0x10, 1, 0},    // Block index outside the section
+        {4, 0, 0, 0, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01}, // Varint past 64 bits
+        {5, 0, 0, 0, 1, 0, 0x80, 0x20, 1, 1, 0, 0},                                     // Run past the section
+        {5, 0, 0, 0, 1, 0, 3, 1, 1, 0, 0},                                              // Values for 1 of 4 blocks
+    };
+    for (const std::vector<uint8_t> &message : malformed)
+        CHECK(!replica.Apply(message));
+    CHECK(CopyBlocks(client) == CopyBlocks(server));
+
+    // Random bytes, on a world of their own since some of them are valid messages
+    World garbageWorld;
+    GenerateTerrain(garbageWorld, 1);
+    WorldReplica garbageReplica(garbageWorld);
+    std::mt19937 random(47);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<size_t> length(1, 64);
+    for (int i = 0; i < GARBAGE_PACKETS; i++)
+    {
+        packet.resize(length(random));
+        for (uint8_t &value : packet)
+            value = static_cast<uint8_t>(byte(random));
+        // Mostly valid message types, so the bodies get decoded
+        packet[0] = static_cast<uint8_t>(packet[0] % 6);
+        garbageReplica.Apply(packet);
+    }
+}
+
+} // namespace BloxxTest
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Test.h"
+
+#include "BloxxEngine/World/DefaultBlocks.h"
+#include "BloxxEngine/World/World.h"
+
+namespace BloxxTest
+{
+
+using namespace BloxxEngine;
+
+TerrainGenerator::Settings GenerateTerrain(World &world, const int radius)
+{
+    const TerrainGenerator::Settings terrain = RegisterDefaultBlocks(world);
+    const TerrainGenerator generator(terrain);
+    for (int chunkX = -radius; chunkX < radius; chunkX++)
+    {
+        for (int chunkZ = -radius; chunkZ < radius; chunkZ++)
+            generator.Generate(world.AddChunk(chunkX, chunkZ));
+    }
+    return terrain;
+}
+
+ChunkBlocks CopyBlocks(const Chunk &chunk)
+{
+    ChunkBlocks blocks;
+    blocks.reserve(static_cast<size_t>(CHUNK_WIDTH) * CHUNK_DEPTH * CHUNK_HEIGHT);
+    for (int x = 0; x < CHUNK_WIDTH; x++)
+    {
+        for (int y = 0; y < CHUNK_HEIGHT; y++)
+        {
+            for (int z = 0; z < CHUNK_DEPTH; z++)
+                blocks.emplace_back(chunk.GetBlock(x, y, z), chunk.GetMetadata(x, y, z));
+        }
+    }
+    return blocks;
+}
+
+WorldBlocks CopyBlocks(World &world)
+{
+    WorldBlocks blocks;
+    world.ForEachChunk([&blocks](const Chunk &chunk) {
+        blocks[{chunk.GetChunkX(), chunk.GetChunkZ()}] = CopyBlocks(chunk);
+    });
+    return blocks;
+}
+
+BlockId RegisterLamp(World &world)
+{
+    auto &registry = world.GetBlockRegistry();
+    const BlockId lamp = registry.Register("lamp", BlockType::Solid, "Lamp");
+    registry.SetLightEmission(lamp, 14);
+    return lamp;
+}
+
+void LightWorld(World &world)
+{
+    world.ForEachChunk([&world](const Chunk &chunk) {
+        world.GetLightEngine().LightChunk(chunk.GetChunkX(), chunk.GetChunkZ());
+    });
+    world.GetLightEngine().Propagate();
+}
+
+size_t CountLightDifferences(World &world)
+{
+    World expected;
+    GenerateTerrain(expected, 0);
+    RegisterLamp(expected);
+    world.ForEachChunk([&expected](const Chunk &chunk) {
+        Chunk &copy = expected.AddChunk(chunk.GetChunkX(), chunk.GetChunkZ());
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+        {
+            for (int y = 0; y < CHUNK_HEIGHT; y++)
+            {
+                for (int z = 0; z < CHUNK_DEPTH; z++)
+                {
+                    if (const BlockId id = chunk.GetBlock(x, y, z); id != BLOCK_AIR)
+                        copy.SetBlock(x, y, z, id, chunk.GetMetadata(x, y, z));
+                }
+            }
+        }
+    });
+    LightWorld(expected);
+
+    size_t differences = 0;
+    world.ForEachChunk([&](const Chunk &chunk) {
+        const Chunk &copy = *expected.GetChunk(chunk.GetChunkX(), chunk.GetChunkZ());
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+        {
+            for (int y = 0; y < CHUNK_HEIGHT; y++)
+            {
+                for (int z = 0; z < CHUNK_DEPTH; z++)
+                {
+                    differences += chunk.GetSkyLight(x, y, z) != copy.GetSkyLight(x, y, z);
+                    differences += chunk.GetBlockLight(x, y, z) != copy.GetBlockLight(x, y, z);
+                }
+            }
+        }
+    });
+    return differences;
+}
+
+} // namespace BloxxTest
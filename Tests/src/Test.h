@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#pragma once
+#include "BloxxEngine/World/TerrainGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace BloxxEngine
+{
+class Chunk;
+class World;
+} // namespace BloxxEngine
+
+namespace BloxxTest
+{
+
+// Each test reports its failures through CHECK and keeps going after one
+void TestWorldSaver();
+void TestReplication();
+void TestWorldEdit();
+void TestLighting();
+
+// Prints the failed condition with its location, returns the condition
+bool Check(bool condition, const char *expression, const char *file, int line);
+[[nodiscard]] size_t GetFailureCount();
+
+// Registers the default blocks and generates the chunks from -radius up to radius on both axes
+BloxxEngine::TerrainGenerator::Settings GenerateTerrain(BloxxEngine::World &world, int radius);
+
+// Every block and its metadata, per chunk by chunk coordinates
+using ChunkBlocks = std::vector<std::pair<BloxxEngine::BlockId, uint8_t>>;
+using WorldBlocks = std::map<std::pair<int, int>, ChunkBlocks>;
+ChunkBlocks CopyBlocks(const BloxxEngine::Chunk &chunk);
+WorldBlocks CopyBlocks(BloxxEngine::World &world);
+
+// An opaque block that emits light, registered after the default blocks
+BloxxEngine::BlockId RegisterLamp(BloxxEngine::World &world);
+// Lights every loaded chunk from scratch and runs the queued lighting
+void LightWorld(BloxxEngine::World &world);
+/**
+ * Number of sky and block light levels of world that differ from lighting the same blocks from scratch, for worlds
+ * whose blocks were registered through GenerateTerrain() and RegisterLamp(). Run the queued lighting first.
+ */
+size_t CountLightDifferences(BloxxEngine::World &world);
+
+} // namespace BloxxTest
+
+#define CHECK(condition) ::BloxxTest::Check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
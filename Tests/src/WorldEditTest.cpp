@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Test.h"
+
+#include "BloxxEngine/World/World.h"
+
+#include <random>
+#include <vector>
+
+namespace BloxxTest
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+// Chunks from -CHUNK_RADIUS up to CHUNK_RADIUS on both axes
+constexpr int CHUNK_RADIUS = 2;
+constexpr int RANDOM_EDITS = 60;
+constexpr int FLOOR_HEIGHT = 59;
+
+// Runs the queued lighting of an edit, the light has to match lighting the blocks from scratch
+void CheckLight(World &world)
+{
+    world.GetLightEngine().Propagate();
+    CHECK(CountLightDifferences(world) == 0);
+}
+} // namespace
+
+void TestWorldEdit()
+{
+    World world;
+    const TerrainGenerator::Settings terrain = GenerateTerrain(world, CHUNK_RADIUS);
+    const BlockId lamp = RegisterLamp(world);
+    const int extent = CHUNK_RADIUS * SECTION_SIZE;
+
+    // A flat stone floor with open sky above it
+    world.FillBox({-extent, 0, -extent}, {extent - 1, FLOOR_HEIGHT, extent - 1}, terrain.Stone);
+    world.FillBox({-extent, FLOOR_HEIGHT + 1, -extent}, {extent - 1, CHUNK_HEIGHT - 1, extent - 1}, BLOCK_AIR);
+    LightWorld(world);
+    CHECK(CountLightDifferences(world) == 0);
+    const WorldBlocks initial = CopyBlocks(world);
+
+    std::vector<EditJournal> journals;
+
+    // Water replacing both the stone and the air above it. The air turning into water doesn't change how light
+    // flows, the sky light still has to reach the stone that opened up below it.
+    journals.push_back(world.FillBox({0, 55, 0}, {9, 64, 9}, terrain.Water));
+    world.GetLightEngine().Propagate();
+    CHECK(world.GetSkyLight(5, FLOOR_HEIGHT, 5) == MAX_LIGHT_LEVEL);
+    CHECK(CountLightDifferences(world) == 0);
+
+    // A cave dug into the floor, across chunk borders, with lamps in it
+    journals.push_back(world.FillSphere({-3, 40, -3}, 12, BLOCK_AIR));
+    CheckLight(world);
+    journals.push_back(world.FillSphere({-3, 36, -3}, 2, lamp));
+    CheckLight(world);
+
+    // Closing the cave up again, then swapping blocks that are opaque before and after
+    journals.push_back(world.FillBox({-15, 45, -15}, {10, 58, 10}, terrain.Dirt));
+    CheckLight(world);
+    journals.push_back(world.Replace({-extent, 30, -extent}, {extent - 1, FLOOR_HEIGHT, extent - 1}, terrain.Stone,
+                                     terrain.Grass));
+    CheckLight(world);
+
+    // A copy of the cave pasted above the floor, once in full and once without its air
+    const BlockRegion region = world.CopyRegion({-16, 26, -16}, {10, 54, 10});
+    journals.push_back(world.PasteRegion(region, {-20, 70, -8}));
+    CheckLight(world);
+    journals.push_back(world.PasteRegion(region, {-5, 90, -25}, true));
+    CheckLight(world);
+
+    // Random boxes of every kind of block
+    std::mt19937 random(40);
+    std::uniform_int_distribution<int> horizontal(-extent, extent - 1);
+    std::uniform_int_distribution<int> height(FLOOR_HEIGHT - 20, FLOOR_HEIGHT + 20);
+    std::uniform_int_distribution<int> size(0, 6);
+    const BlockId blocks[] = {BLOCK_AIR, terrain.Stone, terrain.Dirt, terrain.Water, lamp};
+    std::uniform_int_distribution<size_t> block(0, std::size(blocks) - 1);
+    for (int i = 0; i < RANDOM_EDITS; i++)
+    {
+        const glm::ivec3 min(horizontal(random), height(random), horizontal(random));
+        journals.push_back(world.FillBox(min, min + glm::ivec3(size(random), size(random), size(random)),
+                                         blocks[block(random)]));
+    }
+    CheckLight(world);
+
+    // Undoing every edit in reverse restores the blocks and their light
+    for (auto journal = journals.rbegin(); journal != journals.rend(); ++journal)
+        world.ApplyJournal(*journal);
+    CheckLight(world);
+    CHECK(CopyBlocks(world) == initial);
+}
+
+} // namespace BloxxTest
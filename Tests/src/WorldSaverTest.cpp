@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include "Test.h"
+
+#include "BloxxEngine/ThreadPool.h"
+#include "BloxxEngine/World/World.h"
+#include "BloxxEngine/World/WorldSaver.h"
+
+#include <filesystem>
+#include <future>
+#include <limits>
+
+namespace BloxxTest
+{
+
+using namespace BloxxEngine;
+
+namespace
+{
+// Chunks from -CHUNK_RADIUS up to CHUNK_RADIUS on both axes
+constexpr int CHUNK_RADIUS = 2;
+constexpr uint16_t ALL_SECTIONS = std::numeric_limits<uint16_t>::max();
+
+// Loads every chunk of expected from the directory into a fresh world and compares the blocks
+void CheckSaved(const std::filesystem::path &directory, const WorldBlocks &expected)
+{
+    World world;
+    WorldSaver loader(world, directory);
+    for (const auto &[coordinate, blocks] : expected)
+    {
+        Chunk &chunk = world.AddChunk(coordinate.first, coordinate.second);
+        if (CHECK(loader.LoadChunk(chunk)))
+            CHECK(CopyBlocks(chunk) == blocks);
+    }
+}
+
+// Keeps the only worker of the pool busy until Open(), so the jobs submitted meanwhile are still in flight
+class PoolGate
+{
+  public:
+    explicit PoolGate(ThreadPool &threadPool)
+    {
+        threadPool.Submit([opened = m_Open.get_future().share()] { opened.wait(); });
+    }
+    ~PoolGate() { Open(); }
+
+    void Open()
+    {
+        if (!m_Opened)
+            m_Open.set_value();
+        m_Opened = true;
+    }
+
+  private:
+    std::promise<void> m_Open;
+    bool m_Opened = false;
+};
+} // namespace
+
+void TestWorldSaver()
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "BloxxTests" / "WorldSaver";
+    std::filesystem::remove_all(directory);
+
+    ThreadPool threadPool(1);
+    World world(&threadPool);
+    const TerrainGenerator::Settings terrain = GenerateTerrain(world, CHUNK_RADIUS);
+    const int extent = CHUNK_RADIUS * SECTION_SIZE;
+    const int chunkCount = 4 * CHUNK_RADIUS * CHUNK_RADIUS;
+
+    WorldSaver saver(world, directory);
+
+    // Generated terrain isn't saved
+    CHECK(saver.Save());
+    saver.Wait();
+    CHECK(saver.GetLastChunkCount() == 0);
+    CHECK(std::filesystem::is_empty(directory));
+
+    // The first save of a chunk copies all of its sections. Edits made while the files are being written are left
+    // for the next save.
+    world.FillBox({-extent, 100, -extent}, {extent - 1, 110, extent - 1}, terrain.Stone);
+    world.SetBlock(-extent, 3, -extent, terrain.Dirt, 5);
+    world.SetBlock(extent - 1, 200, extent - 1, terrain.Grass, 7);
+    const WorldBlocks firstSave = CopyBlocks(world);
+    {
+        PoolGate gate(threadPool);
+        CHECK(saver.Save());
+        CHECK(saver.IsSaving());
+        CHECK(!saver.Save());
+
+        world.FillBox({0, 120, 0}, {20, 125, 5}, terrain.Dirt, 3);
+        world.SetBlock(-extent, 3, -extent, BLOCK_AIR);
+        world.SetBlock(-1, 101, -1, terrain.Grass, 1);
+        gate.Open();
+        saver.Wait();
+    }
+    CHECK(!saver.IsSaving());
+    CHECK(saver.GetLastChunkCount() == static_cast<size_t>(chunkCount));
+    CHECK(saver.GetLastBytesWritten() > 0);
+    CheckSaved(directory, firstSave);
+
+    // Only the sections edited during the save are marked, so the next save merges them into the files
+    CHECK(world.GetChunk(0, 0)->GetUnsavedSections() == 1 << 7);
+    CHECK(world.GetChunk(1, 0)->GetUnsavedSections() == 1 << 7);
+    CHECK(world.GetChunk(-2, -2)->GetUnsavedSections() == 1 << 0);
+    CHECK(world.GetChunk(-1, -1)->GetUnsavedSections() == 1 << 6);
+    CHECK(world.GetChunk(1, 1)->GetUnsavedSections() == 0);
+
+    const WorldBlocks secondSave = CopyBlocks(world);
+    CHECK(saver.Save());
+    saver.Wait();
+    CHECK(saver.GetLastChunkCount() == 4);
+    CheckSaved(directory, secondSave);
+
+    // A chunk that fails to write keeps its previous file and is marked to be saved in full
+    world.SetBlock(extent - 1, 40, extent - 1, terrain.Stone, 2);
+    const std::filesystem::path blocked = std::filesystem::path(saver.GetChunkPath(1, 1)).concat(".tmp");
+    std::filesystem::create_directories(blocked / "blocked");
+    CHECK(saver.Save());
+    saver.Wait();
+    CHECK(saver.GetLastChunkCount() == 0);
+    CHECK(world.GetChunk(1, 1)->GetUnsavedSections() == ALL_SECTIONS);
+    CheckSaved(directory, secondSave);
+
+    // Without a file to merge with, the next save writes all of its sections again
+    std::filesystem::remove_all(blocked);
+    std::filesystem::remove(saver.GetChunkPath(1, 1));
+    const WorldBlocks thirdSave = CopyBlocks(world);
+    CHECK(saver.Save());
+    saver.Wait();
+    CHECK(saver.GetLastChunkCount() == 1);
+    CHECK(world.GetChunk(1, 1)->GetUnsavedSections() == 0);
+    CheckSaved(directory, thirdSave);
+
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace BloxxTest
@@ -0,0 +1,511 @@
+/*
+ * Copyright (c) 2024. Combat Jongerenmarketing en -communicatie B.V
+ * All rights reserved.
+ */
+
+#include <BloxxEngine/AssetCooking.h>
+#include <BloxxEngine/AssetFormat.h>
+#include <BloxxEngine/TangentSpace.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace BloxxEngine;
+
+namespace
+{
+
+struct PackedAsset
+{
+    std::string Path;
+    AssetKind Kind;
+    std::vector<uint8_t> Data;
+};
+
+bool HasExtension(const fs::path &path, std::initializer_list<const char *> extensions)
+{
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](const unsigned char c) { return std::tolower(c); });
+    return std::ranges::any_of(extensions, [&](const char *e) { return ext == e; });
+}
+
+std::string ReadText(const fs::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return {(std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()};
+}
+
+/**
+ * Decodes an image to RGBA8 (bottom row first, like the runtime loader) and optionally appends a box filtered
+ * mip chain down to 1x1.
+ */
+bool PackTexture(const fs::path &path, const bool generateMips, std::vector<uint8_t> &out)
+{
+    stbi_set_flip_vertically_on_load(true);
+
+    int width, height, channels;
+    stbi_uc *pixels = stbi_load(path.string().c_str(), &width, &height, &channels, 4);
+    if (!pixels)
+    {
+        std::cerr << "Failed to decode " << path.string() << ": " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+
+    std::vector<std::vector<uint8_t>> levels;
+    levels.emplace_back(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    std::vector<std::pair<int, int>> sizes = {{width, height}};
+    if (generateMips)
+        GenerateMips(levels, sizes, ASSET_MAX_MIP_LEVELS);
+
+    // Header followed by the aligned mip levels. Mip offsets are relative here and fixed up once the entry's
+    // position in the archive is known.
+    TextureAssetHeader header{};
+    header.Width = static_cast<uint32_t>(width);
+    header.Height = static_cast<uint32_t>(height);
+    header.Format = TextureFormat::RGBA8;
+    header.MipCount = static_cast<uint32_t>(levels.size());
+
+    uint64_t offset = (sizeof(TextureAssetHeader) + ASSET_ARCHIVE_ALIGNMENT - 1) & ~(ASSET_ARCHIVE_ALIGNMENT - 1);
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        header.Mips[i] = {static_cast<uint32_t>(sizes[i].first), static_cast<uint32_t>(sizes[i].second), offset,
+                          levels[i].size()};
+        offset = (offset + levels[i].size() + ASSET_ARCHIVE_ALIGNMENT - 1) & ~(ASSET_ARCHIVE_ALIGNMENT - 1);
+    }
+
+    out.assign(offset, 0);
+    std::memcpy(out.data(), &header, sizeof(header));
+    for (size_t i = 0; i < levels.size(); i++)
+        std::memcpy(out.data() + header.Mips[i].DataOffset, levels[i].data(), levels[i].size());
+
+    return true;
+}
+
+uint64_t Align(const uint64_t value)
+{
+    return (value + ASSET_ARCHIVE_ALIGNMENT - 1) & ~(ASSET_ARCHIVE_ALIGNMENT - 1);
+}
+
+uint16_t FloatToHalf(const float value)
+{
+    const uint32_t bits = std::bit_cast<uint32_t>(value);
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (((bits >> 23) & 0xFF) == 0xFF)
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    if (exponent >= 31)
+        return static_cast<uint16_t>(sign | 0x7C00);
+    if (exponent <= 0)
+    {
+        // Subnormal or zero
+        if (exponent < -10)
+            return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        const int shift = 14 - exponent;
+        const uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        return static_cast<uint16_t>(sign | (half + (rest > halfway || (rest == halfway && (half & 1)))));
+    }
+
+    // Round to nearest even, a mantissa overflow correctly carries into the exponent
+    const uint32_t half = sign | static_cast<uint32_t>(exponent) << 10 | mantissa >> 13;
+    const uint32_t rest = mantissa & 0x1FFF;
+    return static_cast<uint16_t>(half + (rest > 0x1000 || (rest == 0x1000 && (half & 1))));
+}
+
+// Signed normalised 10:10:10:2 as read by GL_INT_2_10_10_10_REV, x in the lowest bits
+uint32_t PackSnorm1010102(const glm::vec3 &value)
+{
+    auto pack = [](const float v) {
+        return static_cast<uint32_t>(static_cast<int32_t>(std::round(std::clamp(v, -1.0f, 1.0f) * 511.0f))) & 0x3FF;
+    };
+    return pack(value.x) | pack(value.y) << 10 | pack(value.z) << 20;
+}
+
+/**
+ * Reads the triangles of a Wavefront .obj file: positions, texture coordinates and normals, polygons are split into
+ * fans. Corners sharing the same position, uv and normal become one vertex. Missing normals are computed from the
+ * faces.
+ */
+bool ReadObj(const fs::path &path, std::vector<glm::vec3> &positions, std::vector<glm::vec3> &normals,
+             std::vector<glm::vec2> &texCoords, std::vector<uint32_t> &indices)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        std::cerr << "Could not open mesh " << path.string() << std::endl;
+        return false;
+    }
+
+    std::vector<glm::vec3> objPositions;
+    std::vector<glm::vec3> objNormals;
+    std::vector<glm::vec2> objTexCoords;
+    std::map<std::tuple<int, int, int>, uint32_t> vertexIndices;
+    std::vector<bool> hasNormal;
+
+    // Resolves a 1 based, possibly negative (relative) .obj index, -1 when absent
+    auto resolve = [](const std::string &token, const size_t count) {
+        if (token.empty())
+            return -1;
+        const int index = std::stoi(token);
+        return index < 0 ? static_cast<int>(count) + index : index - 1;
+    };
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        std::istringstream stream(line);
+        std::string type;
+        stream >> type;
+
+        if (type == "v")
+        {
+            glm::vec3 &p = objPositions.emplace_back();
+            stream >> p.x >> p.y >> p.z;
+        }
+        else if (type == "vn")
+        {
+            glm::vec3 &n = objNormals.emplace_back();
+            stream >> n.x >> n.y >> n.z;
+        }
+        else if (type == "vt")
+        {
+            glm::vec2 &uv = objTexCoords.emplace_back();
+            stream >> uv.x >> uv.y;
+        }
+        else if (type == "f")
+        {
+            std::vector<uint32_t> corners;
+            std::string corner;
+            while (stream >> corner)
+            {
+                // v, v/vt, v//vn or v/vt/vn
+                const size_t slash1 = corner.find('/');
+                const size_t slash2 = slash1 == std::string::npos ? std::string::npos : corner.find('/', slash1 + 1);
+                const int p = resolve(corner.substr(0, slash1), objPositions.size());
+                const int t = slash1 == std::string::npos
+                                  ? -1
+                                  : resolve(corner.substr(slash1 + 1, slash2 - slash1 - 1), objTexCoords.size());
+                const int n = slash2 == std::string::npos ? -1 : resolve(corner.substr(slash2 + 1), objNormals.size());
+
+                if (p < 0 || p >= static_cast<int>(objPositions.size()) ||
+                    t >= static_cast<int>(objTexCoords.size()) || n >= static_cast<int>(objNormals.size()))
+                {
+                    std::cerr << path.string() << ":" << lineNumber << ": index out of range" << std::endl;
+                    return false;
+                }
+
+                const auto [it, inserted] =
+                    vertexIndices.try_emplace({p, t, n}, static_cast<uint32_t>(positions.size()));
+                if (inserted)
+                {
+                    positions.push_back(objPositions[p]);
+                    texCoords.push_back(t >= 0 ? objTexCoords[t] : glm::vec2(0.0f));
+                    normals.push_back(n >= 0 ? objNormals[n] : glm::vec3(0.0f));
+                    hasNormal.push_back(n >= 0);
+                }
+                corners.push_back(it->second);
+            }
+
+            for (size_t i = 2; i < corners.size(); i++)
+                indices.insert(indices.end(), {corners[0], corners[i - 1], corners[i]});
+        }
+    }
+
+    // Area weighted face normals for the vertices the file gave none
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const glm::vec3 faceNormal = glm::cross(positions[indices[i + 1]] - positions[indices[i]],
+                                                positions[indices[i + 2]] - positions[indices[i]]);
+        for (size_t c = 0; c < 3; c++)
+        {
+            if (!hasNormal[indices[i + c]])
+                normals[indices[i + c]] = normals[indices[i + c]] + faceNormal;
+        }
+    }
+    for (glm::vec3 &normal : normals)
+    {
+        const float length = std::sqrt(glm::dot(normal, normal));
+        normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+    }
+    return true;
+}
+
+/**
+ * Cooks an .obj file into the runtime mesh layout: tangent frames computed here, attributes quantised, 16 bit
+ * indices when they fit. The runtime uploads the result without touching it.
+ */
+bool PackMesh(const fs::path &path, std::vector<uint8_t> &out)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<uint32_t> indices;
+    if (!ReadObj(path, positions, normals, texCoords, indices))
+        return false;
+    if (indices.empty())
+    {
+        std::cerr << path.string() << " has no faces" << std::endl;
+        return false;
+    }
+
+    std::vector<glm::vec3> tangents(positions.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> bitangents(positions.size(), glm::vec3(0.0f));
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+        glm::vec3 tangent, bitangent;
+        TriangleTangents(positions[a], positions[b], positions[c], texCoords[a], texCoords[b], texCoords[c], tangent,
+                         bitangent);
+        for (const uint32_t v : {a, b, c})
+        {
+            tangents[v] = tangents[v] + tangent;
+            bitangents[v] = bitangents[v] + bitangent;
+        }
+    }
+
+    MeshAssetHeader header{};
+    header.VertexCount = static_cast<uint32_t>(positions.size());
+    header.IndexCount = static_cast<uint32_t>(indices.size());
+    header.IndexSize = positions.size() <= std::numeric_limits<uint16_t>::max() + 1u ? 2 : 4;
+    glm::vec3 boundsMin = positions[0], boundsMax = positions[0];
+
+    std::vector<PackedMeshVertex> vertices(positions.size());
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        OrthonormalizeTangentFrame(normals[i], tangents[i], bitangents[i]);
+
+        PackedMeshVertex &vertex = vertices[i];
+        vertex = {};
+        std::memcpy(vertex.Position, &positions[i], sizeof(vertex.Position));
+        vertex.Normal = PackSnorm1010102(normals[i]);
+        vertex.Tangent = PackSnorm1010102(tangents[i]);
+        vertex.Bitangent = PackSnorm1010102(bitangents[i]);
+        vertex.TexCoords[0] = FloatToHalf(texCoords[i].x);
+        vertex.TexCoords[1] = FloatToHalf(texCoords[i].y);
+        vertex.AmbientOcclusion = 255;
+
+        boundsMin = glm::min(boundsMin, positions[i]);
+        boundsMax = glm::max(boundsMax, positions[i]);
+    }
+    std::memcpy(header.BoundsMin, &boundsMin, sizeof(header.BoundsMin));
+    std::memcpy(header.BoundsMax, &boundsMax, sizeof(header.BoundsMax));
+
+    // Header followed by the aligned vertex and index arrays, offsets relative until WriteArchive() fixes them up
+    header.VertexOffset = Align(sizeof(MeshAssetHeader));
+    header.IndexOffset = Align(header.VertexOffset + vertices.size() * sizeof(PackedMeshVertex));
+    out.assign(header.IndexOffset + indices.size() * header.IndexSize, 0);
+    std::memcpy(out.data(), &header, sizeof(header));
+    std::memcpy(out.data() + header.VertexOffset, vertices.data(), vertices.size() * sizeof(PackedMeshVertex));
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        uint8_t *index = out.data() + header.IndexOffset + i * header.IndexSize;
+        if (header.IndexSize == 2)
+        {
+            const auto value = static_cast<uint16_t>(indices[i]);
+            std::memcpy(index, &value, sizeof(value));
+        }
+        else
+        {
+            std::memcpy(index, &indices[i], sizeof(uint32_t));
+        }
+    }
+    return true;
+}
+
+bool WriteArchive(const fs::path &outputPath, std::vector<PackedAsset> &assets)
+{
+    std::ranges::sort(assets, {}, [](const PackedAsset &a) { return HashAssetPath(a.Path); });
+
+    std::vector<AssetArchiveEntry> entries(assets.size());
+    std::string strings;
+
+    uint64_t offset = Align(sizeof(AssetArchiveHeader));
+    for (size_t i = 0; i < assets.size(); i++)
+    {
+        PackedAsset &asset = assets[i];
+        AssetArchiveEntry &entry = entries[i];
+        entry.PathHash = HashAssetPath(asset.Path);
+        entry.PathOffset = static_cast<uint32_t>(strings.size());
+        entry.PathLength = static_cast<uint32_t>(asset.Path.size());
+        entry.Kind = asset.Kind;
+        entry.DataOffset = offset;
+        entry.DataSize = asset.Data.size();
+        strings += asset.Path;
+
+        if (i > 0 && entries[i - 1].PathHash == entry.PathHash)
+            std::cout << "Note: hash collision between " << assets[i - 1].Path << " and " << asset.Path << std::endl;
+
+        // Make the mip offsets absolute now that the entry has a place in the file
+        if (asset.Kind == AssetKind::Texture)
+        {
+            TextureAssetHeader header{};
+            std::memcpy(&header, asset.Data.data(), sizeof(header));
+            for (uint32_t m = 0; m < header.MipCount; m++)
+                header.Mips[m].DataOffset += offset;
+            std::memcpy(asset.Data.data(), &header, sizeof(header));
+        }
+        else if (asset.Kind == AssetKind::Mesh)
+        {
+            MeshAssetHeader header{};
+            std::memcpy(&header, asset.Data.data(), sizeof(header));
+            header.VertexOffset += offset;
+            header.IndexOffset += offset;
+            std::memcpy(asset.Data.data(), &header, sizeof(header));
+        }
+
+        offset = Align(offset + asset.Data.size());
+    }
+
+    AssetArchiveHeader header{};
+    header.Magic = ASSET_ARCHIVE_MAGIC;
+    header.Version = ASSET_ARCHIVE_VERSION;
+    header.EntryCount = static_cast<uint32_t>(entries.size());
+    header.EntryTableOffset = offset;
+    header.StringTableOffset = offset + entries.size() * sizeof(AssetArchiveEntry);
+    header.StringTableSize = strings.size();
+
+    // Write next to the target and rename, so a running game never maps a half written archive
+    const fs::path tempPath = fs::path(outputPath).concat(".tmp");
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Could not open " << tempPath.string() << " for writing" << std::endl;
+        return false;
+    }
+
+    const auto pad = [&file](const uint64_t target) {
+        static constexpr char zeros[ASSET_ARCHIVE_ALIGNMENT] = {};
+        const auto position = static_cast<uint64_t>(file.tellp());
+        file.write(zeros, static_cast<std::streamsize>(target - position));
+    };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (size_t i = 0; i < assets.size(); i++)
+    {
+        pad(entries[i].DataOffset);
+        file.write(reinterpret_cast<const char *>(assets[i].Data.data()),
+                   static_cast<std::streamsize>(assets[i].Data.size()));
+    }
+    pad(header.EntryTableOffset);
+    file.write(reinterpret_cast<const char *>(entries.data()),
+               static_cast<std::streamsize>(entries.size() * sizeof(AssetArchiveEntry)));
+    file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    file.close();
+
+    if (!file)
+    {
+        std::cerr << "Failed writing " << tempPath.string() << std::endl;
+        return false;
+    }
+
+    std::error_code error;
+    fs::rename(tempPath, outputPath, error);
+    if (error)
+    {
+        std::cerr << "Could not replace " << outputPath.string() << ": " << error.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool generateMips = false;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--mips")
+            generateMips = true;
+        else
+            positional.push_back(arg);
+    }
+
+    if (positional.size() != 2)
+    {
+        std::cerr << "Usage: AssetPacker [--mips] <resource directory> <output.bxpak>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const fs::path inputDir = positional[0];
+    const fs::path outputPath = positional[1];
+    if (!fs::is_directory(inputDir))
+    {
+        std::cerr << inputDir.string() << " is not a directory" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<PackedAsset> assets;
+    for (const auto &item : fs::recursive_directory_iterator(inputDir))
+    {
+        if (!item.is_regular_file())
+            continue;
+
+        PackedAsset asset;
+        asset.Path = fs::relative(item.path(), inputDir).generic_string();
+
+        bool ok = true;
+        if (HasExtension(item.path(), {".png", ".jpg", ".jpeg", ".tga", ".bmp"}))
+        {
+            asset.Kind = AssetKind::Texture;
+            ok = PackTexture(item.path(), generateMips, asset.Data);
+        }
+        else if (HasExtension(item.path(), {".glsl", ".vert", ".frag", ".geom", ".comp"}))
+        {
+            asset.Kind = AssetKind::Shader;
+            std::string source;
+            std::set<fs::path> includeStack;
+            ok = PreprocessShader(item.path(), source, includeStack);
+            asset.Data.assign(source.begin(), source.end());
+        }
+        else if (HasExtension(item.path(), {".obj"}))
+        {
+            asset.Kind = AssetKind::Mesh;
+            ok = PackMesh(item.path(), asset.Data);
+        }
+        else
+        {
+            asset.Kind = AssetKind::Raw;
+            const std::string data = ReadText(item.path());
+            asset.Data.assign(data.begin(), data.end());
+        }
+
+        if (!ok)
+            return EXIT_FAILURE;
+
+        std::cout << "Packed " << asset.Path << " (" << asset.Data.size() << " bytes)" << std::endl;
+        assets.push_back(std::move(asset));
+    }
+
+    if (!WriteArchive(outputPath, assets))
+        return EXIT_FAILURE;
+
+    std::cout << "Wrote " << assets.size() << " assets to " << outputPath.string() << std::endl;
+    return EXIT_SUCCESS;
+}